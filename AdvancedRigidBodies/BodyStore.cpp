@@ -0,0 +1,400 @@
+#include "BodyStore.hpp"
+#include <algorithm>
+
+BodyHandle BodyStore::add(const RigidBody& body) {
+    // Reuse a free slot if one exists, otherwise grow the slot table
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(slotToIndex.size());
+        slotToIndex.push_back(0);
+        slotGeneration.push_back(0);
+    }
+
+    uint32_t index = static_cast<uint32_t>(size());
+    slotToIndex[slot] = index;
+    indexToSlot.push_back(slot);
+
+    sf::Vector2f pos = body.getPosition();
+    sf::Vector2f vel = body.getVelocity();
+
+    positionX.push_back(pos.x);
+    positionY.push_back(pos.y);
+    velocityX.push_back(vel.x);
+    velocityY.push_back(vel.y);
+    accelerationX.push_back(0.f);
+    accelerationY.push_back(0.f);
+
+    rotation.push_back(body.getRotation());
+    angularVelocity.push_back(body.getAngularVelocity());
+    angularAcceleration.push_back(0.f);
+
+    radius.push_back(body.getRadius());
+    mass.push_back(body.getMass());
+    inertia.push_back(body.getInertia());
+    inverseMass.push_back(0.f);
+    inverseInertia.push_back(0.f);
+    restitution.push_back(body.restitution);
+    friction.push_back(body.friction);
+    isStatic.push_back(body.getIsStatic() ? 1 : 0);
+    isResting.push_back(0);
+    sleepTime.push_back(0.f);
+    sleepAnchorX.push_back(pos.x);
+    sleepAnchorY.push_back(pos.y);
+    sleepAnchorRotation.push_back(body.getRotation());
+
+    previousPositionX.push_back(pos.x);
+    previousPositionY.push_back(pos.y);
+    previousRotation.push_back(body.getRotation());
+
+    colour.push_back(body.getColour());
+    impactIntensity.push_back(0.f);
+    squashStretch.push_back(1.f);
+    trailTimer.push_back(0.f);
+    appliedForce.push_back(sf::Vector2f(0.f, 0.f));
+    trailPoints.resize(trailPoints.size() + RigidBody::MAX_TRAIL_LENGTH);
+    trailHead.push_back(0);
+    trailLength.push_back(0);
+
+    updateInverses(index);
+    return BodyHandle{slot, slotGeneration[slot]};
+}
+
+void BodyStore::addBodies(std::span<const RigidBody> newBodies, std::vector<BodyHandle>* outHandles) {
+    // Grow geometrically, so a stream of small batches stays amortised O(1) per body
+    size_t needed = size() + newBodies.size();
+    if (needed > positionX.capacity()) {
+        reserve(std::max(needed, positionX.capacity() * 2));
+    }
+    if (outHandles) {
+        outHandles->reserve(outHandles->size() + newBodies.size());
+    }
+
+    for (const RigidBody& body : newBodies) {
+        BodyHandle handle = add(body);
+        if (outHandles) outHandles->push_back(handle);
+    }
+}
+
+void BodyStore::reserve(size_t count) {
+    positionX.reserve(count);
+    positionY.reserve(count);
+    velocityX.reserve(count);
+    velocityY.reserve(count);
+    accelerationX.reserve(count);
+    accelerationY.reserve(count);
+
+    rotation.reserve(count);
+    angularVelocity.reserve(count);
+    angularAcceleration.reserve(count);
+
+    radius.reserve(count);
+    mass.reserve(count);
+    inertia.reserve(count);
+    inverseMass.reserve(count);
+    inverseInertia.reserve(count);
+    restitution.reserve(count);
+    friction.reserve(count);
+    isStatic.reserve(count);
+    isResting.reserve(count);
+    sleepTime.reserve(count);
+    sleepAnchorX.reserve(count);
+    sleepAnchorY.reserve(count);
+    sleepAnchorRotation.reserve(count);
+
+    previousPositionX.reserve(count);
+    previousPositionY.reserve(count);
+    previousRotation.reserve(count);
+
+    colour.reserve(count);
+    impactIntensity.reserve(count);
+    squashStretch.reserve(count);
+    trailTimer.reserve(count);
+    appliedForce.reserve(count);
+    trailPoints.reserve(count * RigidBody::MAX_TRAIL_LENGTH);
+    trailHead.reserve(count);
+    trailLength.reserve(count);
+
+    indexToSlot.reserve(count);
+    slotToIndex.reserve(count);
+    slotGeneration.reserve(count);
+}
+
+void BodyStore::removeSwap(size_t index) {
+    size_t last = size() - 1;
+    releaseSlot(index);
+    if (index != last) {
+        moveBody(last, index);
+    }
+    truncate(last);
+}
+
+/**
+ * Move every field of one body to another index
+ * Used by removeIf() to close gaps left by removed bodies
+ */
+void BodyStore::moveBody(size_t from, size_t to) {
+    positionX[to] = positionX[from];
+    positionY[to] = positionY[from];
+    velocityX[to] = velocityX[from];
+    velocityY[to] = velocityY[from];
+    accelerationX[to] = accelerationX[from];
+    accelerationY[to] = accelerationY[from];
+
+    rotation[to] = rotation[from];
+    angularVelocity[to] = angularVelocity[from];
+    angularAcceleration[to] = angularAcceleration[from];
+
+    radius[to] = radius[from];
+    mass[to] = mass[from];
+    inertia[to] = inertia[from];
+    inverseMass[to] = inverseMass[from];
+    inverseInertia[to] = inverseInertia[from];
+    restitution[to] = restitution[from];
+    friction[to] = friction[from];
+    isStatic[to] = isStatic[from];
+    isResting[to] = isResting[from];
+    sleepTime[to] = sleepTime[from];
+    sleepAnchorX[to] = sleepAnchorX[from];
+    sleepAnchorY[to] = sleepAnchorY[from];
+    sleepAnchorRotation[to] = sleepAnchorRotation[from];
+
+    previousPositionX[to] = previousPositionX[from];
+    previousPositionY[to] = previousPositionY[from];
+    previousRotation[to] = previousRotation[from];
+
+    colour[to] = colour[from];
+    impactIntensity[to] = impactIntensity[from];
+    squashStretch[to] = squashStretch[from];
+    trailTimer[to] = trailTimer[from];
+    appliedForce[to] = appliedForce[from];
+    std::copy_n(&trailPoints[from * RigidBody::MAX_TRAIL_LENGTH], RigidBody::MAX_TRAIL_LENGTH,
+                &trailPoints[to * RigidBody::MAX_TRAIL_LENGTH]);
+    trailHead[to] = trailHead[from];
+    trailLength[to] = trailLength[from];
+
+    // Keep the handle pointing at the body's new home
+    uint32_t slot = indexToSlot[from];
+    indexToSlot[to] = slot;
+    slotToIndex[slot] = static_cast<uint32_t>(to);
+}
+
+/**
+ * Retire the slot of a body that is being removed
+ * Bumping the generation invalidates every handle still referring to it
+ */
+void BodyStore::releaseSlot(size_t index) {
+    uint32_t slot = indexToSlot[index];
+    ++slotGeneration[slot];
+    freeSlots.push_back(slot);
+}
+
+void BodyStore::truncate(size_t newSize) {
+    positionX.resize(newSize);
+    positionY.resize(newSize);
+    velocityX.resize(newSize);
+    velocityY.resize(newSize);
+    accelerationX.resize(newSize);
+    accelerationY.resize(newSize);
+
+    rotation.resize(newSize);
+    angularVelocity.resize(newSize);
+    angularAcceleration.resize(newSize);
+
+    radius.resize(newSize);
+    mass.resize(newSize);
+    inertia.resize(newSize);
+    inverseMass.resize(newSize);
+    inverseInertia.resize(newSize);
+    restitution.resize(newSize);
+    friction.resize(newSize);
+    isStatic.resize(newSize);
+    isResting.resize(newSize);
+    sleepTime.resize(newSize);
+    sleepAnchorX.resize(newSize);
+    sleepAnchorY.resize(newSize);
+    sleepAnchorRotation.resize(newSize);
+
+    previousPositionX.resize(newSize);
+    previousPositionY.resize(newSize);
+    previousRotation.resize(newSize);
+
+    colour.resize(newSize);
+    impactIntensity.resize(newSize);
+    squashStretch.resize(newSize);
+    trailTimer.resize(newSize);
+    appliedForce.resize(newSize);
+    trailPoints.resize(newSize * RigidBody::MAX_TRAIL_LENGTH);
+    trailHead.resize(newSize);
+    trailLength.resize(newSize);
+
+    indexToSlot.resize(newSize);
+}
+
+void BodyStore::setMassAndRadius(size_t i, float newMass, float newRadius) {
+    mass[i] = newMass;
+    radius[i] = newRadius;
+    inertia[i] = RigidBody::diskInertia(newMass, newRadius);
+    updateInverses(i);
+}
+
+void BodyStore::updateInverses(size_t i) {
+    inverseMass[i] = isStatic[i] ? 0.0f : 1.0f / mass[i];
+    inverseInertia[i] = isStatic[i] ? 0.0f : 1.0f / inertia[i];
+}
+
+void BodyStore::clear() {
+    removeIf([](size_t) { return true; });
+}
+
+bool BodyStore::contains(BodyHandle handle) const {
+    return handle.slot < slotGeneration.size() &&
+           slotGeneration[handle.slot] == handle.generation &&
+           slotToIndex[handle.slot] < size() &&
+           indexToSlot[slotToIndex[handle.slot]] == handle.slot;
+}
+
+size_t BodyStore::indexOf(BodyHandle handle) const {
+    return slotToIndex[handle.slot];
+}
+
+BodyHandle BodyStore::handleAt(size_t index) const {
+    uint32_t slot = indexToSlot[index];
+    return BodyHandle{slot, slotGeneration[slot]};
+}
+
+/**
+ * FNV-1a over the raw bytes of the state arrays
+ *
+ *   hash = offset basis
+ *   for each byte:  hash = (hash XOR byte) × prime
+ *
+ * Bytes, not values: -0.0 and 0.0 (or two NaNs) compare equal as floats but
+ * are different states, and a replay that drifts by one bit must show up.
+ */
+uint64_t BodyStore::computeStateHash() const {
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](const void* data, size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < bytes; ++i) {
+            hash = (hash ^ p[i]) * 1099511628211ull;
+        }
+    };
+
+    size_t count = size();
+    uint64_t hashedCount = count;  // Fixed width: 32- and 64-bit builds must agree
+    mix(&hashedCount, sizeof(hashedCount));
+    mix(indexToSlot.data(), count * sizeof(uint32_t));
+    mix(positionX.data(), count * sizeof(float));
+    mix(positionY.data(), count * sizeof(float));
+    mix(rotation.data(), count * sizeof(float));
+    mix(velocityX.data(), count * sizeof(float));
+    mix(velocityY.data(), count * sizeof(float));
+    mix(angularVelocity.data(), count * sizeof(float));
+    mix(isResting.data(), count * sizeof(uint8_t));
+    return hash;
+}
+
+void BodyStore::writeSnapshot(SnapshotWriter& out) const {
+    uint64_t count = size();
+    out.write(count);
+    out.write(static_cast<uint64_t>(slotGeneration.size()));
+    out.write(static_cast<uint64_t>(freeSlots.size()));
+
+    out.writeArray(positionX, count);
+    out.writeArray(positionY, count);
+    out.writeArray(velocityX, count);
+    out.writeArray(velocityY, count);
+    out.writeArray(rotation, count);
+    out.writeArray(angularVelocity, count);
+
+    out.writeArray(radius, count);
+    out.writeArray(mass, count);
+    out.writeArray(inertia, count);
+    out.writeArray(restitution, count);
+    out.writeArray(friction, count);
+    out.writeArray(isStatic, count);
+    out.writeArray(isResting, count);
+    out.writeArray(sleepTime, count);
+    out.writeArray(sleepAnchorX, count);
+    out.writeArray(sleepAnchorY, count);
+    out.writeArray(sleepAnchorRotation, count);
+    out.writeArray(colour, count);
+
+    out.writeArray(indexToSlot, count);
+    out.writeArray(slotGeneration, slotGeneration.size());
+    out.writeArray(freeSlots, freeSlots.size());
+}
+
+bool BodyStore::readSnapshot(SnapshotReader& in) {
+    uint64_t count = 0, slotCount = 0, freeCount = 0;
+    in.read(count);
+    in.read(slotCount);
+    in.read(freeCount);
+    // Every body costs well over a byte, so this rejects absurd counts before any resize
+    if (!in.fits(count, 1) || !in.fits(slotCount, 1) || !in.fits(freeCount, 1)) return false;
+    size_t n = static_cast<size_t>(count);
+
+    in.readArray(positionX, n);
+    in.readArray(positionY, n);
+    in.readArray(velocityX, n);
+    in.readArray(velocityY, n);
+    in.readArray(rotation, n);
+    in.readArray(angularVelocity, n);
+
+    in.readArray(radius, n);
+    in.readArray(mass, n);
+    in.readArray(inertia, n);
+    in.readArray(restitution, n);
+    in.readArray(friction, n);
+    in.readArray(isStatic, n);
+    in.readArray(isResting, n);
+    in.readArray(sleepTime, n);
+    in.readArray(sleepAnchorX, n);
+    in.readArray(sleepAnchorY, n);
+    in.readArray(sleepAnchorRotation, n);
+    in.readArray(colour, n);
+
+    in.readArray(indexToSlot, n);
+    in.readArray(slotGeneration, static_cast<size_t>(slotCount));
+    in.readArray(freeSlots, static_cast<size_t>(freeCount));
+    if (!in.ok()) return false;
+
+    // Every slot is either owned by exactly one body or free
+    if (n + freeSlots.size() != slotGeneration.size()) return false;
+    slotToIndex.assign(slotGeneration.size(), 0xFFFFFFFFu);
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t slot = indexToSlot[i];
+        if (slot >= slotToIndex.size() || slotToIndex[slot] != 0xFFFFFFFFu) return false;
+        slotToIndex[slot] = static_cast<uint32_t>(i);
+    }
+    for (uint32_t slot : freeSlots) {
+        if (slot >= slotToIndex.size() || slotToIndex[slot] != 0xFFFFFFFFu) return false;
+        slotToIndex[slot] = 0;
+    }
+
+    // Derived from what was read, not saved
+    inverseMass.resize(n);
+    inverseInertia.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        updateInverses(i);
+    }
+
+    // Accumulated forces are zero between steps; effects start fresh
+    accelerationX.assign(n, 0.f);
+    accelerationY.assign(n, 0.f);
+    angularAcceleration.assign(n, 0.f);
+    previousPositionX = positionX;
+    previousPositionY = positionY;
+    previousRotation = rotation;
+    impactIntensity.assign(n, 0.f);
+    squashStretch.assign(n, 1.f);
+    trailTimer.assign(n, 0.f);
+    appliedForce.assign(n, sf::Vector2f(0.f, 0.f));
+    trailPoints.assign(n * RigidBody::MAX_TRAIL_LENGTH, sf::Vector2f(0.f, 0.f));
+    trailHead.assign(n, 0);
+    trailLength.assign(n, 0);
+    return true;
+}
@@ -0,0 +1,267 @@
+#pragma once
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "RigidBody.hpp"
+#include "Snapshot.hpp"
+
+/**
+ * BODY HANDLE - A STABLE NAME FOR A BODY
+ * ======================================
+ *
+ * Bodies live in tightly packed arrays (see BodyStore below). When a body is
+ * removed, the survivors are moved down to close the gap, so a body's ARRAY
+ * INDEX can change. Code outside the engine (mouse dragging, game logic) needs
+ * a name that survives those moves - that's what a handle is.
+ *
+ * HOW IT WORKS:
+ * - slot:       index into an indirection table that maps to the current array index
+ * - generation: bumped every time a slot is reused
+ *
+ * If you keep a handle to a body that has since been removed, its generation
+ * no longer matches the slot's generation and the handle is rejected instead
+ * of silently pointing at whatever body moved into that slot.
+ */
+struct BodyHandle {
+    static constexpr uint32_t InvalidSlot = 0xFFFFFFFFu;
+
+    uint32_t slot = InvalidSlot;
+    uint32_t generation = 0;
+
+    bool isValid() const { return slot != InvalidSlot; }
+    bool operator==(const BodyHandle& other) const {
+        return slot == other.slot && generation == other.generation;
+    }
+    bool operator!=(const BodyHandle& other) const { return !(*this == other); }
+};
+
+/**
+ * BODY STORE - STRUCTURE OF ARRAYS (SoA)
+ * ======================================
+ *
+ * PROBLEM: An array of objects ("Array of Structures", AoS)
+ * - std::vector<std::unique_ptr<RigidBody>> means one heap object per body
+ * - Every physics loop chases a pointer to somewhere random in memory
+ * - Each object also carries a trail deque and debug vectors, so the handful of
+ *   floats the physics loop needs are spread over several cache lines
+ *
+ * SOLUTION: One array per field ("Structure of Arrays", SoA)
+ *
+ *   AoS:  [pos vel radius trail... | pos vel radius trail... | ...]
+ *   SoA:  positionX: [x0 x1 x2 ...]
+ *         positionY: [y0 y1 y2 ...]
+ *         radius:    [r0 r1 r2 ...]
+ *
+ * - The integrator walks positionX/velocityX linearly - every byte fetched is used
+ * - The CPU prefetcher loves linear scans
+ * - The same layout is what SIMD (4-16 bodies per instruction) needs later
+ *
+ * HOT vs COLD DATA:
+ * - HOT: read/written by integration and collision every step (position, velocity, ...)
+ * - COLD: only needed for drawing (colour, trails, debug info)
+ * Keeping them in separate arrays means the physics loops never pull visual
+ * data into the cache.
+ *
+ * Arrays are public on purpose - this is plain data for the engine's loops.
+ * Index i refers to the same body in every array. Use handles (not indices)
+ * to remember a body across frames.
+ */
+class BodyStore {
+public:
+    // ------------------------------------------------------------------
+    // HOT DATA - integration and collision
+    // ------------------------------------------------------------------
+    std::vector<float> positionX, positionY;          // pixels
+    std::vector<float> velocityX, velocityY;          // pixels/second
+    std::vector<float> accelerationX, accelerationY;  // pixels/second²
+
+    std::vector<float> rotation;             // radians
+    std::vector<float> angularVelocity;      // radians/second
+    std::vector<float> angularAcceleration;  // radians/second²
+
+    std::vector<float> radius;
+    std::vector<float> mass;
+    std::vector<float> inertia;
+
+    /**
+     * CACHED INVERSES - 1/mass and 1/inertia, 0 for static bodies
+     * The solver multiplies by these instead of dividing by mass and inertia
+     * in every impulse, and a static body needs no special case: an infinite
+     * mass is simply an inverse of 0. Derived from mass, radius and isStatic -
+     * change those through setMassAndRadius() so these follow.
+     */
+    std::vector<float> inverseMass;
+    std::vector<float> inverseInertia;
+
+    std::vector<float> restitution;
+    std::vector<float> friction;
+
+    // uint8_t instead of std::vector<bool> - vector<bool> packs bits and
+    // turns every read into a shift-and-mask
+    std::vector<uint8_t> isStatic;
+    std::vector<uint8_t> isResting;   // Asleep: skipped by integration, the grid and the broad phase
+    std::vector<float> sleepTime;      // Seconds this body has been still (see IslandManager)
+    std::vector<float> sleepAnchorX, sleepAnchorY, sleepAnchorRotation;  // Where the still spell began
+
+    // ------------------------------------------------------------------
+    // PREVIOUS STEP - written at the start of each step, read when drawing
+    // to interpolate between two physics steps (see PhysicsEngine::update)
+    // ------------------------------------------------------------------
+    std::vector<float> previousPositionX, previousPositionY;
+    std::vector<float> previousRotation;
+
+    // ------------------------------------------------------------------
+    // COLD DATA - visualization only
+    // ------------------------------------------------------------------
+    std::vector<sf::Color> colour;
+    std::vector<float> impactIntensity;   // 0-1, drives flash/squash
+    std::vector<float> squashStretch;
+    std::vector<float> trailTimer;
+    std::vector<sf::Vector2f> appliedForce;
+
+    /**
+     * MOTION TRAILS - ONE RING BUFFER FOR EVERY BODY
+     *
+     * Body i owns MAX_TRAIL_LENGTH consecutive slots of trailPoints:
+     *
+     *   trailPoints: [ body 0: p p p ... p | body 1: p p p ... p | ... ]
+     *                            ^ trailHead[0] = newest point
+     *
+     * A new point overwrites the oldest slot, so a trail never allocates once
+     * its body exists. Points store no alpha: a point's age follows from how
+     * far it is behind the head (see trailAge), so nothing has to fade them
+     * every step and the renderer reads the whole buffer in one linear pass.
+     */
+    std::vector<sf::Vector2f> trailPoints;
+    std::vector<uint8_t> trailHead;    // Slot of the newest point
+    std::vector<uint8_t> trailLength;  // Points written so far (up to MAX_TRAIL_LENGTH)
+
+    size_t size() const { return positionX.size(); }
+    bool empty() const { return positionX.empty(); }
+
+    /**
+     * Copy a body description into the arrays
+     * @return Stable handle for the new body
+     */
+    BodyHandle add(const RigidBody& body);
+
+    /**
+     * Add many bodies at once
+     * Every array is grown once for the whole batch instead of step by step
+     * @param outHandles - if given, the new handles are appended in order
+     */
+    void addBodies(std::span<const RigidBody> newBodies, std::vector<BodyHandle>* outHandles = nullptr);
+
+    // Room for `count` bodies in every array: adding up to that many never reallocates
+    void reserve(size_t count);
+
+    /**
+     * Remove one body in O(1) - SWAP AND POP
+     * The last body moves into the gap, so only ITS index changes:
+     *
+     *   [a b c d e]   remove b   →   [a e c d]
+     *
+     * Order is not kept (removeIf keeps it, at O(n) per call)
+     */
+    void removeSwap(size_t index);
+
+    /**
+     * Remove every body for which pred(index) returns true
+     * Survivors keep their relative order (stable compaction)
+     */
+    template <typename Predicate>
+    void removeIf(Predicate pred) {
+        size_t write = 0;
+        for (size_t read = 0; read < size(); ++read) {
+            if (pred(read)) {
+                releaseSlot(read);
+                continue;
+            }
+            if (write != read) {
+                moveBody(read, write);
+            }
+            ++write;
+        }
+        truncate(write);
+    }
+
+    void clear();
+
+    // Handle <-> index conversion
+    bool contains(BodyHandle handle) const;
+    size_t indexOf(BodyHandle handle) const;  // Caller must check contains() first
+    BodyHandle handleAt(size_t index) const;
+
+    /**
+     * Fingerprint of the simulation state: the exact bits of every body's
+     * position, rotation, velocities and sleep flag, in index order.
+     * Two runs that hash the same after every step are bit-for-bit identical.
+     */
+    uint64_t computeStateHash() const;
+
+    /**
+     * Snapshot of every body (see Snapshot.hpp): the simulation arrays, the
+     * colours and the handle table, so handles saved with a scene stay valid.
+     * Trails, flashes and other effects start empty after a load.
+     * readSnapshot() should be called on an empty store; on failure its
+     * contents are unspecified (load into a temporary, then move it in).
+     */
+    void writeSnapshot(SnapshotWriter& out) const;
+    bool readSnapshot(SnapshotReader& in);
+
+    // Convenience accessors for non-hot code
+    sf::Vector2f getPosition(size_t i) const { return sf::Vector2f(positionX[i], positionY[i]); }
+    sf::Vector2f getVelocity(size_t i) const { return sf::Vector2f(velocityX[i], velocityY[i]); }
+    void setPosition(size_t i, const sf::Vector2f& p) { positionX[i] = p.x; positionY[i] = p.y; }
+
+    /**
+     * Position/rotation blended between the previous and current step
+     * @param alpha - 0 = previous step, 1 = current step
+     */
+    sf::Vector2f getInterpolatedPosition(size_t i, float alpha) const {
+        return sf::Vector2f(previousPositionX[i] + (positionX[i] - previousPositionX[i]) * alpha,
+                            previousPositionY[i] + (positionY[i] - previousPositionY[i]) * alpha);
+    }
+    float getInterpolatedRotation(size_t i, float alpha) const {
+        return previousRotation[i] + (rotation[i] - previousRotation[i]) * alpha;
+    }
+    void setVelocity(size_t i, const sf::Vector2f& v) { velocityX[i] = v.x; velocityY[i] = v.y; isResting[i] = 0; }
+
+    // New mass and radius for body i; inertia and the cached inverses are recomputed
+    void setMassAndRadius(size_t i, float newMass, float newRadius);
+
+    // Trail ring of body i (MAX_TRAIL_LENGTH slots, newest at trailHead[i])
+    const sf::Vector2f* trailRing(size_t i) const { return &trailPoints[i * RigidBody::MAX_TRAIL_LENGTH]; }
+
+    // Overwrite the oldest trail slot of body i with a new newest point
+    void pushTrailPoint(size_t i, const sf::Vector2f& point) {
+        uint8_t head = trailHead[i] + 1;
+        if (head == RigidBody::MAX_TRAIL_LENGTH) head = 0;
+        trailPoints[i * RigidBody::MAX_TRAIL_LENGTH + head] = point;
+        trailHead[i] = head;
+        if (trailLength[i] < RigidBody::MAX_TRAIL_LENGTH) ++trailLength[i];
+    }
+
+    /**
+     * Seconds since the k-th newest trail point of body i was recorded
+     * (k = 0 is the newest). Points are TRAIL_UPDATE_INTERVAL apart and the
+     * newest is trailTimer old, so no per-point timestamp is needed.
+     */
+    float trailAge(size_t i, size_t k) const {
+        return trailTimer[i] + k * RigidBody::TRAIL_UPDATE_INTERVAL;
+    }
+
+private:
+    void moveBody(size_t from, size_t to);
+    void releaseSlot(size_t index);
+    void truncate(size_t newSize);
+    void updateInverses(size_t i);
+
+    // Handle indirection table
+    std::vector<uint32_t> slotToIndex;     // slot -> current array index
+    std::vector<uint32_t> slotGeneration;  // slot -> generation of its current owner
+    std::vector<uint32_t> indexToSlot;     // array index -> slot (parallel to the data arrays)
+    std::vector<uint32_t> freeSlots;       // slots available for reuse
+};
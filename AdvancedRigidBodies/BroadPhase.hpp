@@ -0,0 +1,108 @@
+#pragma once
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <vector>
+
+/**
+ * A candidate pair from the broad phase
+ * Indices refer to the BodyStore arrays; first < second is NOT guaranteed
+ */
+struct CollisionPair {
+    uint32_t first;
+    uint32_t second;
+};
+
+// The broad phases PhysicsEngine can switch between
+enum class BroadPhaseType {
+    Grid,           // HierarchicalGrid (default)
+    SweepAndPrune
+};
+
+inline const char* getBroadPhaseName(BroadPhaseType type) {
+    return type == BroadPhaseType::SweepAndPrune ? "sap" : "grid";
+}
+
+/**
+ * Receives the candidates of a ray query (see BroadPhase::queryRay)
+ * visit() tests the body exactly and returns how far along the ray anything
+ * can still matter: the closest hit so far, or the ray's full length.
+ * A body may be visited more than once.
+ */
+class RayVisitor {
+public:
+    virtual float visit(uint32_t bodyIndex) = 0;
+
+protected:
+    ~RayVisitor() = default;
+};
+
+/**
+ * BROAD PHASE - WHICH PAIRS ARE WORTH A CLOSER LOOK?
+ * ==================================================
+ *
+ * Every broad phase answers the same question - which bodies' bounding
+ * boxes might overlap - but each suits a different kind of world:
+ *
+ *   Grid (HierarchicalGrid)     bodies spread over the world, any motion;
+ *                               cost follows the bodies per cell
+ *   Sweep and prune (SweepAndPrune)
+ *                               coherent motion (bodies sliding on a floor);
+ *                               last frame's sort order is nearly right, so
+ *                               re-sorting is close to O(n)
+ *
+ * PhysicsEngine only talks to this interface, so the choice is made at
+ * runtime (PhysicsEngine::setBroadPhase) and the benchmark can run them
+ * side by side.
+ *
+ * CONTRACT (same for every implementation):
+ * - clear() + insert() every body after BodyStore indices change
+ * - update() moved bodies every step; static and settled bodies may be skipped
+ * - rebuildIfDirty() once after the inserts/updates, before any query
+ * - Bodies are boxes: a body's circle, or a fast body's swept box
+ */
+class BroadPhase {
+public:
+    virtual ~BroadPhase() = default;
+
+    virtual void clear() = 0;
+    virtual void insert(uint32_t bodyIndex, const sf::Vector2f& position, float radius) = 0;
+
+    /**
+     * Give an inserted body a new bounding box min..max
+     * @return true if the structure had to change (the grid: cells changed)
+     */
+    virtual bool update(uint32_t bodyIndex, const sf::Vector2f& min, const sf::Vector2f& max) = 0;
+
+    // Same, for the body's circle
+    bool update(uint32_t bodyIndex, const sf::Vector2f& position, float radius) {
+        sf::Vector2f extent(radius, radius);
+        return update(bodyIndex, position - extent, position + extent);
+    }
+
+    virtual void rebuildIfDirty() = 0;
+
+    // Every pair of bodies whose boxes may overlap; outPairs is cleared first
+    virtual void getPotentialCollisions(std::vector<CollisionPair>& outPairs) const = 0;
+
+    // Every body whose box may touch min..max, in no particular order; outBodies is cleared first
+    virtual void queryRect(const sf::Vector2f& min, const sf::Vector2f& max, std::vector<uint32_t>& outBodies) const = 0;
+
+    /**
+     * Bodies whose boxes may touch the ray origin + t * direction, t in
+     * 0..maxDistance, widened by thickness on every side
+     * @param direction - unit length; maxDistance must be finite
+     * Candidates come roughly nearest first, and the search stops once the
+     * visitor's returned distance rules out everything left.
+     */
+    virtual void queryRay(const sf::Vector2f& origin, const sf::Vector2f& direction, float maxDistance,
+                          float thickness, RayVisitor& visitor) const = 0;
+
+    /**
+     * Per-body flags: nonzero = not moving (static or asleep). Pairs of two
+     * such bodies are not reported. Not owned; nullptr = report all pairs.
+     */
+    virtual void setSleepFlags(const uint8_t* flags) = 0;
+
+    // One past the highest body index inserted since the last clear()
+    virtual size_t getBodyCount() const = 0;
+};
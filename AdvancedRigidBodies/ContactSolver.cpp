@@ -0,0 +1,622 @@
+#include "ContactSolver.hpp"
+#include "Vector2Utils.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <numeric>
+
+using namespace PhysicsUtils;
+
+namespace {
+    /**
+     * Below this approach speed (pixels/second) contacts don't bounce
+     * Without it, a body resting on the floor "bounces" by the tiny speed gravity
+     * adds every frame and never settles
+     */
+    constexpr float RESTITUTION_VELOCITY_THRESHOLD = 20.0f;
+
+    constexpr int MAX_COLOURS = 64;
+    constexpr int OVERFLOW_COLOUR = MAX_COLOURS;
+    constexpr size_t MIN_PARALLEL_BATCH = 128;
+
+    /**
+     * Velocity of a point on a spinning body
+     * v_point = v_center + ω × r, and in 2D: ω × r = (-ω * r.y, ω * r.x)
+     */
+    sf::Vector2f pointVelocity(const BodyStore& b, size_t i, const sf::Vector2f& r) {
+        float w = b.angularVelocity[i];
+        return sf::Vector2f(b.velocityX[i] - w * r.y, b.velocityY[i] + w * r.x);
+    }
+}
+
+void ContactSolver::setSettings(const SolverSettings& newSettings) {
+    settings = newSettings;
+    settings.velocityIterations = std::max(1, settings.velocityIterations);
+    settings.positionIterations = std::max(0, settings.positionIterations);
+}
+
+/**
+ * STAGE 1: CONTACT GENERATION (Narrow Phase)
+ * ==========================================
+ *
+ * Circle-circle test for every broad-phase pair. Overlapping pairs become a
+ * Contact; everything else is dropped.
+ *
+ * This stage only READS bodies, so any number of threads can run it at once.
+ * Each thread fills its own list; the lists are joined in thread order, which
+ * gives exactly the order a single thread would have produced.
+ */
+void ContactSolver::generateContacts(const BodyStore& bodies, const std::vector<CollisionPair>& pairs) {
+    unsigned threads = threadPool ? threadPool->getThreadCount() : 1;
+    threadContacts.resize(threads);
+    for (auto& list : threadContacts) {
+        list.clear();
+    }
+
+    auto generateRange = [&](unsigned chunk, size_t begin, size_t end) {
+        std::vector<Contact>& out = threadContacts[chunk];
+
+        for (size_t p = begin; p < end; ++p) {
+            uint32_t a = pairs[p].first;
+            uint32_t b = pairs[p].second;
+            if (deterministic && bodies.handleAt(b).slot < bodies.handleAt(a).slot) {
+                std::swap(a, b);  // Lower handle slot is always A - same normal whichever way the pair came
+            }
+
+            sf::Vector2f diff = bodies.getPosition(b) - bodies.getPosition(a);
+            float minDistance = bodies.radius[a] + bodies.radius[b];  // Sum of radii
+
+            // Compare squared distances - no sqrt for the (common) miss case
+            float distanceSq = lengthSquared(diff);
+            if (distanceSq >= minDistance * minDistance) {
+                continue;
+            }
+
+            /**
+             * COLLISION NORMAL: Direction to push bodies apart
+             * Points from body A toward body B
+             *
+             * VISUAL:
+             *     bodyA  →  normal  →  bodyB
+             *       O    ----------->    O
+             */
+            float distance = std::sqrt(distanceSq);
+            sf::Vector2f normal;
+            if (distance < 0.001f) {
+                // EDGE CASE: Bodies exactly on top of each other
+                // Prevent division by zero - push apart horizontally
+                distance = 0.001f;
+                normal = sf::Vector2f(1.0f, 0.0f);
+            } else {
+                normal = diff / distance;
+            }
+
+            // Stable key: lower slot in the high half, so key(A,B) == key(B,A)
+            uint64_t slotA = bodies.handleAt(a).slot;
+            uint64_t slotB = bodies.handleAt(b).slot;
+            uint64_t key = slotA < slotB ? (slotA << 32) | slotB : (slotB << 32) | slotA;
+
+            Contact c{};
+            c.bodyA = a;
+            c.bodyB = b;
+            c.key = key;
+            c.normal = normal;
+            c.tangent = sf::Vector2f(-normal.y, normal.x);
+
+            /**
+             * OVERLAP/PENETRATION: How much circles are intersecting
+             * This shouldn't happen in reality, but due to discrete timesteps, it does
+             *
+             * Example: radii are 20 and 30, distance is 45
+             * - minDistance = 50 (they should be 50 apart)
+             * - penetration = 50 - 45 = 5 pixels
+             */
+            c.penetration = minDistance - distance;
+
+            /**
+             * CONTACT POINT: Where the collision occurred
+             * Located on body A's surface, along the collision normal
+             */
+            c.point = bodies.getPosition(a) + normal * bodies.radius[a];
+
+            /**
+             * COMBINED MATERIALS
+             * - Restitution: MINIMUM of both (less bouncy wins)
+             *   Rubber ball (e=0.8) hits concrete (e=0.3) → use 0.3
+             * - Friction: AVERAGE of both
+             *   Rubber (0.8) on ice (0.1) → 0.45
+             */
+            c.restitution = std::min(bodies.restitution[a], bodies.restitution[b]);
+            c.friction = (bodies.friction[a] + bodies.friction[b]) * 0.5f;
+
+            out.push_back(c);
+        }
+    };
+
+    if (threadPool) {
+        threadPool->parallelFor(pairs.size(), generateRange);
+    } else {
+        generateRange(0, 0, pairs.size());
+    }
+
+    contacts.clear();
+    for (const auto& list : threadContacts) {
+        contacts.insert(contacts.end(), list.begin(), list.end());
+    }
+
+    // Deterministic mode: solve in key order, not in the broad phase's pair order
+    if (deterministic) {
+        std::sort(contacts.begin(), contacts.end(),
+            [](const Contact& x, const Contact& y) { return x.key < y.key; });
+    }
+
+    /**
+     * MATCH WITH LAST FRAME (for warm starting)
+     *
+     * Both lists are sorted by key, so one linear walk finds every match:
+     *
+     *   previous: [3 7 9 12]        current: [3 8 9 15]
+     *              ^                          ^
+     *   3 == 3 → copy impulses, advance both
+     *   7 <  8 → contact ended, advance previous
+     *   ...
+     */
+    sortedByKey.resize(contacts.size());
+    std::iota(sortedByKey.begin(), sortedByKey.end(), 0u);
+    std::sort(sortedByKey.begin(), sortedByKey.end(),
+        [this](uint32_t x, uint32_t y) { return contacts[x].key < contacts[y].key; });
+
+    size_t prev = 0;
+    for (uint32_t index : sortedByKey) {
+        Contact& c = contacts[index];
+        while (prev < previousImpulses.size() && previousImpulses[prev].key < c.key) {
+            ++prev;
+        }
+        if (prev < previousImpulses.size() && previousImpulses[prev].key == c.key) {
+            c.normalImpulse = previousImpulses[prev].normalImpulse;
+            c.tangentImpulse = previousImpulses[prev].tangentImpulse;
+        }
+    }
+}
+
+/**
+ * STAGE 2: PREPARE
+ * ================
+ *
+ * Precompute everything that stays constant while the solver iterates.
+ *
+ * EFFECTIVE MASS along a direction d:
+ *
+ *   k = 1/mA + 1/mB + (rA × d)²/IA + (rB × d)²/IB
+ *
+ * - 1/m terms: how easily the impulse changes linear velocity
+ *   (static bodies have infinite mass, so 1/∞ = 0 - easy to handle!
+ *   BodyStore caches these inverses, and each contact copies its pair's here)
+ * - (r × d)²/I terms: how easily it changes spin
+ *   Off-center impacts (large r × d) turn more of the impulse into rotation
+ *
+ * An impulse of size 1/k changes the relative velocity along d by exactly 1,
+ * so "normalMass" = 1/k converts a velocity error into the impulse that fixes it.
+ *
+ * RESTITUTION TARGET:
+ * e = (separating speed after) / (approach speed before)
+ * So the normal solve aims for a separating speed of e × approach speed.
+ *
+ * BAUMGARTE TARGET (Baumgarte mode only):
+ * Separate fast enough to remove β of the overlap this step:
+ *   bias = β × (penetration - slop) / dt
+ */
+void ContactSolver::prepare(const BodyStore& bodies, float deltaTime) {
+    bool useBaumgarte = settings.positionCorrection == PositionCorrection::Baumgarte && deltaTime > 0.0f;
+
+    auto prepareRange = [&](unsigned, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Contact& c = contacts[i];
+            size_t a = c.bodyA;
+            size_t b = c.bodyB;
+
+            c.rA = c.point - bodies.getPosition(a);
+            c.rB = c.point - bodies.getPosition(b);
+
+            c.invMassA = bodies.inverseMass[a];
+            c.invMassB = bodies.inverseMass[b];
+            c.invInertiaA = bodies.inverseInertia[a];
+            c.invInertiaB = bodies.inverseInertia[b];
+            float invMassSum = c.invMassA + c.invMassB;
+
+            float rnA = cross(c.rA, c.normal);
+            float rnB = cross(c.rB, c.normal);
+            float kNormal = invMassSum + rnA * rnA * c.invInertiaA + rnB * rnB * c.invInertiaB;
+            c.normalMass = kNormal > 0.0f ? 1.0f / kNormal : 0.0f;
+
+            float rtA = cross(c.rA, c.tangent);
+            float rtB = cross(c.rB, c.tangent);
+            float kTangent = invMassSum + rtA * rtA * c.invInertiaA + rtB * rtB * c.invInertiaB;
+            c.tangentMass = kTangent > 0.0f ? 1.0f / kTangent : 0.0f;
+
+            /**
+             * RELATIVE VELOCITY: How fast objects are approaching/separating
+             * Positive along normal = separating
+             * Negative along normal = approaching (need to bounce apart)
+             */
+            sf::Vector2f relativeVelocity = pointVelocity(bodies, b, c.rB) - pointVelocity(bodies, a, c.rA);
+            float velocityAlongNormal = dot(relativeVelocity, c.normal);
+            c.approachSpeed = -velocityAlongNormal;
+            c.velocityBias = velocityAlongNormal < -RESTITUTION_VELOCITY_THRESHOLD
+                ? -c.restitution * velocityAlongNormal
+                : 0.0f;
+
+            if (useBaumgarte) {
+                float depth = std::max(c.penetration - settings.linearSlop, 0.0f);
+                c.velocityBias = std::max(c.velocityBias, settings.baumgarte * depth / deltaTime);
+            }
+        }
+    };
+
+    if (threadPool) {
+        threadPool->parallelFor(contacts.size(), prepareRange);
+    } else {
+        prepareRange(0, 0, contacts.size());
+    }
+    if (threadPool || deterministic) {
+        buildColourBatches(bodies);
+    }
+}
+
+/**
+ * APPLY IMPULSE - NEWTON'S THIRD LAW!
+ *
+ * "For every action, there is an equal and opposite reaction"
+ *
+ * VELOCITY CHANGE from impulse:          Δv = J / m
+ * ANGULAR VELOCITY CHANGE from impulse:  Δω = (r × J) / I
+ *
+ * - Body A gets -impulse, body B gets +impulse
+ * - Equal magnitude, opposite directions → total momentum is conserved
+ * - Heavier objects change velocity less (larger m in denominator)
+ *
+ * Multiplies by the contact's cached inverses - no divisions. A static body
+ * (inverse 0) would get a change of exactly 0, but it is still not written:
+ * in a parallel batch many contacts share the same floor, and a write of an
+ * unchanged value from several threads is still a data race.
+ */
+void ContactSolver::applyImpulse(BodyStore& bodies, const Contact& c, const sf::Vector2f& impulse) {
+    size_t a = c.bodyA;
+    size_t b = c.bodyB;
+
+    if (c.invMassA > 0.0f) {
+        bodies.velocityX[a] -= impulse.x * c.invMassA;
+        bodies.velocityY[a] -= impulse.y * c.invMassA;
+        bodies.angularVelocity[a] -= cross(c.rA, impulse) * c.invInertiaA;
+    }
+    if (c.invMassB > 0.0f) {
+        bodies.velocityX[b] += impulse.x * c.invMassB;
+        bodies.velocityY[b] += impulse.y * c.invMassB;
+        bodies.angularVelocity[b] += cross(c.rB, impulse) * c.invInertiaB;
+    }
+}
+
+/**
+ * Run fn(contact) over every contact
+ * - Serial mode: generation order
+ * - Parallel mode: colour batch by colour batch, each batch split across threads
+ *   (no two contacts in a batch share a dynamic body, so no data races)
+ * - Deterministic mode: colour batches even without a pool (run serially).
+ *   Contacts in a batch touch different bodies, so their order inside the
+ *   batch can't change any result - only the batch order can, and that is
+ *   the same for any thread count
+ */
+template <typename Function>
+void ContactSolver::forEachContact(Function fn) {
+    if (!threadPool && !deterministic) {
+        for (auto& c : contacts) {
+            fn(c);
+        }
+        return;
+    }
+
+    size_t colourCount = colourOffsets.size() - 1;
+    for (size_t colour = 0; colour < colourCount; ++colour) {
+        size_t begin = colourOffsets[colour];
+        size_t end = colourOffsets[colour + 1];
+        if (begin == end) continue;
+
+        bool isOverflow = (colour == colourCount - 1);
+        if (!threadPool || isOverflow || end - begin < MIN_PARALLEL_BATCH) {
+            for (size_t i = begin; i < end; ++i) {
+                fn(contacts[colouredContacts[i]]);
+            }
+            continue;
+        }
+
+        threadPool->parallelFor(end - begin, [&](unsigned, size_t first, size_t last) {
+            for (size_t i = begin + first; i < begin + last; ++i) {
+                fn(contacts[colouredContacts[i]]);
+            }
+        });
+    }
+}
+
+/**
+ * STAGE 3: WARM START
+ * Re-apply the impulses that solved each contact last frame
+ * A resting stack starts the frame already (almost) balanced
+ */
+void ContactSolver::warmStart(BodyStore& bodies) {
+    forEachContact([&](Contact& c) {
+        sf::Vector2f impulse = c.normal * c.normalImpulse + c.tangent * c.tangentImpulse;
+        applyImpulse(bodies, c, impulse);
+    });
+}
+
+/**
+ * STAGE 4: VELOCITY SOLVE - SEQUENTIAL IMPULSES
+ * =============================================
+ *
+ * IMPULSE-BASED PHYSICS:
+ * Instead of applying forces over time (F = ma), we apply instant velocity changes
+ * - Impulse J = change in momentum = Δ(mv)
+ * - For instantaneous collisions, this is more stable than force-based
+ * - Used in most modern game physics engines (Box2D, Bullet, PhysX)
+ *
+ * ACCUMULATED (CLAMPED) IMPULSES:
+ * Each contact remembers the TOTAL impulse applied to it this frame.
+ * A new correction is added to that total, and the total is clamped:
+ * - Normal: total ≥ 0 (contacts can push, never pull)
+ * - Friction: |total| ≤ μ × normal total (Coulomb's law)
+ * Clamping the total (not each correction) lets a later correction undo an
+ * earlier over-shoot - the key to stable stacks.
+ *
+ * ITERATIONS:
+ * Fixing one contact disturbs its neighbours, so we sweep all contacts
+ * settings.velocityIterations times. Each sweep converges a little further
+ * (Gauss-Seidel iteration) - a stack of 10 needs several sweeps before the
+ * floor's push reaches the top.
+ */
+void ContactSolver::solveVelocities(BodyStore& bodies) {
+    for (int iteration = 0; iteration < settings.velocityIterations; ++iteration) {
+        solveVelocityIteration(bodies);
+    }
+}
+
+void ContactSolver::solveVelocityIteration(BodyStore& bodies) {
+    forEachContact([&](Contact& c) {
+        // NORMAL IMPULSE
+        sf::Vector2f relativeVelocity = pointVelocity(bodies, c.bodyB, c.rB) - pointVelocity(bodies, c.bodyA, c.rA);
+        float velocityAlongNormal = dot(relativeVelocity, c.normal);
+
+        float lambda = c.normalMass * (c.velocityBias - velocityAlongNormal);
+        float newImpulse = std::max(c.normalImpulse + lambda, 0.0f);
+        lambda = newImpulse - c.normalImpulse;
+        c.normalImpulse = newImpulse;
+        applyImpulse(bodies, c, c.normal * lambda);
+
+        /**
+         * FRICTION (Tangential Impulse)
+         * Opposes sliding along the contact surface
+         *
+         *        normal ↑
+         *               |
+         *    ← tangent--O-→ tangent (sliding motion)
+         *
+         * COULOMB FRICTION LAW: J_friction ≤ μ × J_normal
+         * - Can't have more friction than the normal force allows
+         * - Pushing down on an object makes it harder to slide
+         */
+        relativeVelocity = pointVelocity(bodies, c.bodyB, c.rB) - pointVelocity(bodies, c.bodyA, c.rA);
+        float velocityAlongTangent = dot(relativeVelocity, c.tangent);
+
+        float lambdaT = -c.tangentMass * velocityAlongTangent;
+        float frictionLimit = c.friction * c.normalImpulse;
+        float newTangent = std::clamp(c.tangentImpulse + lambdaT, -frictionLimit, frictionLimit);
+        lambdaT = newTangent - c.tangentImpulse;
+        c.tangentImpulse = newTangent;
+        applyImpulse(bodies, c, c.tangent * lambdaT);
+    });
+}
+
+/**
+ * STAGE 5: POSITION CORRECTION (Split Impulse)
+ * ============================================
+ *
+ * Separate the overlapping bodies so they don't get "stuck" inside each other.
+ * Works on positions only - velocities are left exactly as the velocity solve
+ * found them, so the correction can't add bounce energy.
+ *
+ * Each sweep re-measures overlap from CURRENT positions (a body already
+ * pushed out by another contact isn't pushed twice) and removes a fraction β
+ * of whatever exceeds the slop:
+ *
+ *   C = β × (overlap - slop), clamped to maxCorrection
+ *
+ * MASS-WEIGHTED SPLIT:
+ * The correction is shared by inverse mass, like an impulse would be:
+ *   moveA = C × invMassA / (invMassA + invMassB)
+ * - Equal masses: each moves half
+ * - One static: only the dynamic one moves (static = infinite mass)
+ * - Both static: never reaches here (invMassSum = 0)
+ *
+ * For circles the contact normal passes through both centres, so this push
+ * never needs to rotate anything.
+ */
+void ContactSolver::solvePositions(BodyStore& bodies) {
+    if (settings.positionCorrection != PositionCorrection::SplitImpulse) return;
+
+    for (int iteration = 0; iteration < settings.positionIterations; ++iteration) {
+        solvePositionIteration(bodies);
+    }
+}
+
+void ContactSolver::solvePositionIteration(BodyStore& bodies) {
+    forEachContact([&](Contact& c) {
+        size_t a = c.bodyA;
+        size_t b = c.bodyB;
+
+        float invMassA = c.invMassA;
+        float invMassB = c.invMassB;
+        float invMassSum = invMassA + invMassB;
+        if (invMassSum <= 0.0f) return;
+
+        sf::Vector2f diff = bodies.getPosition(b) - bodies.getPosition(a);
+        float distance = length(diff);
+        float overlap = bodies.radius[a] + bodies.radius[b] - distance;
+        if (overlap <= settings.linearSlop) return;
+
+        sf::Vector2f normal = distance > 0.001f ? diff / distance : c.normal;
+        float correction = std::min(settings.baumgarte * (overlap - settings.linearSlop), settings.maxCorrection);
+        sf::Vector2f push = normal * (correction / invMassSum);
+
+        // Static bodies are never written - other threads may be reading them
+        if (invMassA > 0.0f) bodies.setPosition(a, bodies.getPosition(a) - push * invMassA);
+        if (invMassB > 0.0f) bodies.setPosition(b, bodies.getPosition(b) + push * invMassB);
+    });
+}
+
+/**
+ * STAGE 6: REMEMBER IMPULSES
+ * Saved in key order, ready for next frame's linear matching walk
+ */
+void ContactSolver::storeImpulses() {
+    previousImpulses.clear();
+    for (uint32_t index : sortedByKey) {
+        const Contact& c = contacts[index];
+        previousImpulses.push_back({c.key, c.normalImpulse, c.tangentImpulse});
+    }
+}
+
+void ContactSolver::clearPersistentContacts() {
+    previousImpulses.clear();
+    contacts.clear();
+    sortedByKey.clear();
+}
+
+void ContactSolver::forgetBodies(const std::vector<uint32_t>& sortedSlots) {
+    auto removed = [&](uint64_t slot) {
+        return std::binary_search(sortedSlots.begin(), sortedSlots.end(), static_cast<uint32_t>(slot));
+    };
+    // erase_if keeps the survivors in key order
+    std::erase_if(previousImpulses, [&](const CachedImpulse& cached) {
+        return removed(cached.key >> 32) || removed(cached.key & 0xFFFFFFFFu);
+    });
+    contacts.clear();
+    sortedByKey.clear();
+}
+
+void ContactSolver::writeSnapshot(SnapshotWriter& out) const {
+    out.write(static_cast<uint64_t>(previousImpulses.size()));
+    out.writeArray(previousImpulses, previousImpulses.size());
+}
+
+bool ContactSolver::readSnapshot(SnapshotReader& in) {
+    uint64_t count = 0;
+    if (!in.read(count) || !in.fits(count, sizeof(CachedImpulse))) return false;
+
+    std::vector<CachedImpulse> impulses;
+    if (!in.readArray(impulses, static_cast<size_t>(count))) return false;
+
+    // The matching walk in generateContacts() needs them in key order
+    for (size_t i = 1; i < impulses.size(); ++i) {
+        if (!(impulses[i - 1].key < impulses[i].key)) return false;
+    }
+
+    clearPersistentContacts();
+    previousImpulses = std::move(impulses);
+    return true;
+}
+
+/**
+ * Visual effect: one spark burst per contact that was approaching
+ * Intensity scales with the normal impulse (normalised for visuals)
+ *
+ * Resting contacts (approach speed below the bounce threshold) are skipped -
+ * a pile sitting on the floor shouldn't spray sparks every frame.
+ */
+void ContactSolver::emitImpactEvents(const BodyStore& bodies, std::vector<std::vector<ImpactEvent>>& threadImpacts) const {
+    auto emitRange = [&](unsigned chunk, size_t begin, size_t end) {
+        auto& out = threadImpacts[chunk];
+        for (size_t i = begin; i < end; ++i) {
+            const Contact& c = contacts[i];
+            if (c.approachSpeed < RESTITUTION_VELOCITY_THRESHOLD) continue;
+
+            sf::Color colourA = bodies.colour[c.bodyA];
+            sf::Color colourB = bodies.colour[c.bodyB];
+            sf::Color averageColour(
+                (colourA.r + colourB.r) / 2,
+                (colourA.g + colourB.g) / 2,
+                (colourA.b + colourB.b) / 2
+            );
+            float intensity = std::min(1.0f, c.normalImpulse / 100.0f);
+            out.push_back({c.point, c.normal, averageColour, intensity});
+        }
+    };
+
+    if (threadPool && threadImpacts.size() >= threadPool->getThreadCount()) {
+        threadPool->parallelFor(contacts.size(), emitRange);
+    } else {
+        emitRange(0, 0, contacts.size());
+    }
+}
+
+/**
+ * GRAPH COLOURING - FINDING WORK THAT CAN RUN AT THE SAME TIME
+ * ============================================================
+ *
+ * Applying a contact's impulse writes to BOTH of its bodies. Two threads
+ * solving (A,B) and (B,C) at the same moment would both write B - a data race.
+ *
+ * Think of bodies as nodes and contacts as edges. We give every edge a COLOUR
+ * so that no two edges of the same colour touch the same node:
+ *
+ *     A ---red--- B ---blue--- C ---red--- D
+ *
+ * All red contacts can run in parallel, then all blue contacts, and so on.
+ *
+ * GREEDY ALGORITHM:
+ * - Each body keeps a 64-bit mask of colours it already has
+ * - A contact gets the lowest colour free in BOTH bodies' masks
+ * - Circles touch only a handful of neighbours, so ~6-12 colours is typical
+ * - Contacts that can't fit in 64 colours go to an overflow batch solved serially
+ *
+ * STATIC BODIES don't count: the solver never writes to them, so any number
+ * of threads may read a static peg at once. Without this rule, a peg touching
+ * 20 bodies would force 20 colours.
+ */
+void ContactSolver::buildColourBatches(const BodyStore& bodies) {
+    bodyColourMask.assign(bodies.size(), 0);
+    contactColour.resize(contacts.size());
+
+    std::array<size_t, MAX_COLOURS + 1> colourCounts{};
+
+    for (size_t i = 0; i < contacts.size(); ++i) {
+        uint32_t a = contacts[i].bodyA;
+        uint32_t b = contacts[i].bodyB;
+        uint64_t maskA = bodies.isStatic[a] ? 0 : bodyColourMask[a];
+        uint64_t maskB = bodies.isStatic[b] ? 0 : bodyColourMask[b];
+        uint64_t used = maskA | maskB;
+
+        int colour = OVERFLOW_COLOUR;
+        if (used != ~uint64_t(0)) {
+            colour = std::countr_zero(~used);  // Lowest colour neither body has
+            uint64_t bit = uint64_t(1) << colour;
+            if (!bodies.isStatic[a]) bodyColourMask[a] |= bit;
+            if (!bodies.isStatic[b]) bodyColourMask[b] |= bit;
+        }
+
+        contactColour[i] = static_cast<uint8_t>(colour);
+        ++colourCounts[colour];
+    }
+
+    // Counting sort: lay contacts out colour by colour (stable, so deterministic)
+    colourOffsets.assign(MAX_COLOURS + 2, 0);
+    for (int c = 0; c <= MAX_COLOURS; ++c) {
+        colourOffsets[c + 1] = colourOffsets[c] + colourCounts[c];
+    }
+
+    colouredContacts.resize(contacts.size());
+    std::array<size_t, MAX_COLOURS + 1> cursor;
+    std::copy(colourOffsets.begin(), colourOffsets.end() - 1, cursor.begin());
+    for (size_t i = 0; i < contacts.size(); ++i) {
+        colouredContacts[cursor[contactColour[i]]++] = static_cast<uint32_t>(i);
+    }
+}
@@ -0,0 +1,193 @@
+#pragma once
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <vector>
+#include "BodyStore.hpp"
+#include "ImpactQueue.hpp"
+#include "SpatialGrid.hpp"
+#include "Snapshot.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * ONE CONTACT BETWEEN TWO CIRCLES
+ *
+ * Everything the solver needs is computed once in the contact generation pass
+ * and stored here, so the (repeated) solve loops only do multiply-adds.
+ */
+struct Contact {
+    uint32_t bodyA;          // BodyStore index
+    uint32_t bodyB;          // BodyStore index
+    uint64_t key;            // Stable pair id (handle slots) - survives index changes
+
+    sf::Vector2f normal;     // Unit vector from A toward B
+    sf::Vector2f tangent;    // Perpendicular to normal (friction direction)
+    sf::Vector2f point;      // World contact point (on A's surface)
+    sf::Vector2f rA;         // Contact point relative to A's center
+    sf::Vector2f rB;         // Contact point relative to B's center
+    float penetration;       // Overlap depth at generation time
+
+    float invMassA;          // Copied from BodyStore::inverseMass / inverseInertia (0 = static),
+    float invMassB;          // so the solve loops read one contact and
+    float invInertiaA;       // never gather from the body arrays
+    float invInertiaB;
+
+    float normalMass;        // 1 / (effective inverse mass along the normal)
+    float tangentMass;       // 1 / (effective inverse mass along the tangent)
+    float restitution;       // Combined bounciness
+    float friction;          // Combined friction coefficient
+    float velocityBias;      // Target separating speed (restitution, plus Baumgarte push in that mode)
+    float approachSpeed;     // How fast the bodies were closing before solving (> 0 = approaching)
+
+    float normalImpulse;     // ACCUMULATED normal impulse (kept across frames)
+    float tangentImpulse;    // ACCUMULATED friction impulse (kept across frames)
+};
+
+/**
+ * HOW OVERLAP IS REMOVED
+ *
+ * - Baumgarte:    feed the overlap back into the velocity solve as extra
+ *                 separating speed (β × overlap / dt). Cheap, but the push
+ *                 becomes real velocity, so deep overlaps make bodies pop.
+ * - SplitImpulse: leave velocities alone and move positions directly in a
+ *                 separate pass. The correction never turns into kinetic
+ *                 energy, so stacks stay calm. (default)
+ */
+enum class PositionCorrection {
+    Baumgarte,
+    SplitImpulse
+};
+
+/**
+ * SOLVER SETTINGS - ACCURACY vs THROUGHPUT
+ *
+ * Each velocity iteration sweeps every contact once. One sweep only fixes
+ * each contact against the velocities it sees at that moment; a stack needs
+ * several sweeps for the push from the floor to reach the top body.
+ *
+ *   iterations:  1    4     8     16
+ *   stacks:      mush  ok   good  stiff      (cost grows linearly)
+ */
+struct SolverSettings {
+    int velocityIterations = 8;
+    int positionIterations = 3;      // Only used by SplitImpulse
+    PositionCorrection positionCorrection = PositionCorrection::SplitImpulse;
+
+    float baumgarte = 0.2f;          // Fraction of the overlap removed per step (β)
+    float linearSlop = 0.5f;         // Overlap allowed without correction (pixels) - stops jitter
+    float maxCorrection = 8.0f;      // Largest push per position iteration (pixels)
+};
+
+/**
+ * CONTACT SOLVER - A STAGED NARROW PHASE
+ * ======================================
+ *
+ * The old narrow phase did everything for one pair at a time:
+ * detect → push apart → bounce → friction → sparks, then the next pair.
+ * Splitting that into stages over a flat Contact array makes each stage
+ * simple, cache friendly and easy to run in parallel:
+ *
+ *   broad phase pairs
+ *        │
+ *   1. generateContacts()  - circle test, build Contact array (read-only on bodies)
+ *   2. prepare()           - r vectors, effective masses, restitution targets
+ *   3. warmStart()         - re-apply last frame's impulses for matching pairs
+ *   4. solveVelocities()   - N sweeps of sequential impulses, clamped accumulation
+ *   5. solvePositions()    - M sweeps pushing overlapping bodies apart
+ *   6. storeImpulses()     - remember impulses for next frame
+ *
+ * PERSISTENT CONTACTS (WARM STARTING):
+ * A box resting on the floor needs roughly the same impulse every frame to
+ * cancel gravity. Instead of rediscovering it from zero each frame, we start
+ * from last frame's answer. Contacts are matched by a stable key built from
+ * the two bodies' handle slots (array indices can change when bodies are
+ * removed, handle slots don't).
+ *
+ * PARALLEL MODE:
+ * With a ThreadPool attached, stages 3-5 run over colour batches - groups of
+ * contacts that share no dynamic body (see buildColourBatches()).
+ *
+ * DETERMINISTIC MODE:
+ * The broad phase hands pairs over in its own order (grid cells, sort order),
+ * and sequential impulses give slightly different floats for a different
+ * order. setDeterministic(true) removes every order that isn't part of the
+ * world state:
+ * - each pair is oriented so A has the lower handle slot
+ * - contacts are sorted by key before solving
+ * - stages 3-5 always run by colour batch, so 1 thread and 8 threads
+ *   apply the impulses in the same order
+ */
+class ContactSolver {
+public:
+    void setThreadPool(ThreadPool* pool) { threadPool = pool; }
+    void setDeterministic(bool enabled) { deterministic = enabled; }
+
+    void setSettings(const SolverSettings& newSettings);
+    const SolverSettings& getSettings() const { return settings; }
+
+    void generateContacts(const BodyStore& bodies, const std::vector<CollisionPair>& pairs);
+    void prepare(const BodyStore& bodies, float deltaTime);
+    void warmStart(BodyStore& bodies);
+    void solveVelocities(BodyStore& bodies);
+    void solvePositions(BodyStore& bodies);
+    void storeImpulses();
+
+    /**
+     * Write one ImpactEvent per contact that hit hard enough to matter
+     * into per-thread buffers (merged later by ImpactQueue::flush())
+     * @param threadImpacts - one buffer per pool thread (at least one)
+     */
+    void emitImpactEvents(const BodyStore& bodies, std::vector<std::vector<ImpactEvent>>& threadImpacts) const;
+
+    /**
+     * Forget all persistent contacts
+     * Call when bodies are removed, so a reused handle slot can't inherit
+     * the impulses of the body that used to own it
+     */
+    void clearPersistentContacts();
+
+    /**
+     * Forget the persistent contacts of removed bodies only (the rest of
+     * the world keeps warm starting). Also drops this step's contact list,
+     * whose indices are stale after a removal.
+     * @param sortedSlots - handle slots of the removed bodies, ascending
+     */
+    void forgetBodies(const std::vector<uint32_t>& sortedSlots);
+
+    // Snapshot of the warm-start impulses, so a loaded stack starts balanced
+    void writeSnapshot(SnapshotWriter& out) const;
+    bool readSnapshot(SnapshotReader& in);
+
+    const std::vector<Contact>& getContacts() const { return contacts; }
+
+private:
+    struct CachedImpulse {
+        uint64_t key;
+        float normalImpulse;
+        float tangentImpulse;
+    };
+
+    void buildColourBatches(const BodyStore& bodies);
+    void solveVelocityIteration(BodyStore& bodies);
+    void solvePositionIteration(BodyStore& bodies);
+
+    template <typename Function>
+    void forEachContact(Function fn);
+
+    static void applyImpulse(BodyStore& bodies, const Contact& c, const sf::Vector2f& impulse);
+
+    ThreadPool* threadPool = nullptr;  // Not owned
+    SolverSettings settings;
+    bool deterministic = false;
+
+    std::vector<Contact> contacts;
+    std::vector<std::vector<Contact>> threadContacts;  // Per-thread generation output
+    std::vector<CachedImpulse> previousImpulses;       // Sorted by key
+    std::vector<uint32_t> sortedByKey;                 // Contact indices in key order
+
+    // Colour batches (parallel mode)
+    std::vector<uint64_t> bodyColourMask;
+    std::vector<uint8_t> contactColour;
+    std::vector<uint32_t> colouredContacts;  // Contact indices grouped by colour
+    std::vector<size_t> colourOffsets;       // Colour c = colouredContacts[offsets[c], offsets[c+1])
+};
@@ -0,0 +1,94 @@
+#include "ContinuousCollision.hpp"
+#include <algorithm>
+#include <cmath>
+
+void ContinuousCollision::findFastBodies(const BodyStore& bodies) {
+    fastBodies.clear();
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        if (bodies.isStatic[i] || bodies.isResting[i]) continue;
+
+        float dx = bodies.positionX[i] - bodies.previousPositionX[i];
+        float dy = bodies.positionY[i] - bodies.previousPositionY[i];
+        float limit = motionFraction * bodies.radius[i];
+        if (dx * dx + dy * dy > limit * limit) {
+            fastBodies.push_back(static_cast<uint32_t>(i));
+        }
+    }
+}
+
+void ContinuousCollision::getSweptBounds(const BodyStore& bodies, uint32_t i, sf::Vector2f& min, sf::Vector2f& max) {
+    float r = bodies.radius[i];
+    min.x = std::min(bodies.positionX[i], bodies.previousPositionX[i]) - r;
+    min.y = std::min(bodies.positionY[i], bodies.previousPositionY[i]) - r;
+    max.x = std::max(bodies.positionX[i], bodies.previousPositionX[i]) + r;
+    max.y = std::max(bodies.positionY[i], bodies.previousPositionY[i]) + r;
+}
+
+/**
+ * TIME OF IMPACT OF TWO MOVING CIRCLES
+ *
+ * Both bodies move in a straight line from their previous to their current
+ * position. Their offset at time t is d(t) = d0 + v·t, where d0 is the
+ * offset at the start and v the change of offset over the step. They touch
+ * when |d(t)| = R:
+ *
+ *   (v·v) t² + 2 (d0·v) t + (d0·d0 - R²) = 0
+ *
+ * The smaller root is the moment they first touch. No impact if:
+ * - they are moving apart (d0·v >= 0), or miss entirely (no real root)
+ * - the root lies beyond the end of the step
+ * Already touching at t = 0 and moving closer → impact at t = 0: a fast
+ * body pressed into a pile must not be pushed on through what it touches.
+ */
+void ContinuousCollision::clampToImpact(BodyStore& bodies, const BroadPhase& broadPhase, float depth) {
+    // Every impact is found before any body moves, so each query sees the
+    // whole step's motion of the other bodies
+    impactTime.resize(fastBodies.size());
+
+    for (size_t f = 0; f < fastBodies.size(); ++f) {
+        uint32_t a = fastBodies[f];
+        sf::Vector2f min, max;
+        getSweptBounds(bodies, a, min, max);
+        broadPhase.queryRect(min, max, candidates);  // Other fast bodies are filed by their sweeps too
+
+        float stepX = bodies.positionX[a] - bodies.previousPositionX[a];
+        float stepY = bodies.positionY[a] - bodies.previousPositionY[a];
+        float earliest = 1.0f;
+
+        for (uint32_t b : candidates) {
+            if (b == a) continue;
+
+            float d0x = bodies.previousPositionX[a] - bodies.previousPositionX[b];
+            float d0y = bodies.previousPositionY[a] - bodies.previousPositionY[b];
+            float vx = stepX - (bodies.positionX[b] - bodies.previousPositionX[b]);
+            float vy = stepY - (bodies.positionY[b] - bodies.previousPositionY[b]);
+
+            float sumRadii = bodies.radius[a] + bodies.radius[b];
+            float touching = std::max(sumRadii - depth, sumRadii * 0.5f);
+
+            float c = d0x * d0x + d0y * d0y - touching * touching;
+            float halfB = d0x * vx + d0y * vy;
+            if (halfB >= 0.0f) continue;
+
+            float t = 0.0f;
+            if (c > 0.0f) {
+                float quadA = vx * vx + vy * vy;
+                float discriminant = halfB * halfB - quadA * c;
+                if (discriminant < 0.0f) continue;
+
+                t = (-halfB - std::sqrt(discriminant)) / quadA;
+            }
+            earliest = std::min(earliest, t);
+        }
+        impactTime[f] = earliest;
+    }
+
+    for (size_t f = 0; f < fastBodies.size(); ++f) {
+        float t = impactTime[f];
+        if (t >= 1.0f) continue;
+
+        uint32_t i = fastBodies[f];
+        bodies.positionX[i] = bodies.previousPositionX[i] + (bodies.positionX[i] - bodies.previousPositionX[i]) * t;
+        bodies.positionY[i] = bodies.previousPositionY[i] + (bodies.positionY[i] - bodies.previousPositionY[i]) * t;
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <vector>
+#include "BodyStore.hpp"
+#include "BroadPhase.hpp"
+
+/**
+ * CONTINUOUS COLLISION DETECTION - BULLETS THAT DON'T TUNNEL
+ * ==========================================================
+ *
+ * PROBLEM: Discrete detection only looks at where bodies END each step
+ *
+ *   step n         step n+1
+ *     ●→    ▌        ▌    ●      a fast body jumps past a thin peg:
+ *                                 it never overlaps it at a step boundary
+ *
+ * - A body moving farther per step than it is wide can skip straight over
+ *   small bodies and pegs (Main.cpp's mouse drag easily does this)
+ * - The classic fix - more substeps for the whole world - multiplies the
+ *   cost of every body to save a handful of fast ones
+ *
+ * SOLUTION: Sweep only the FAST bodies
+ * 1. After integration, a body whose step moved it more than motionFraction
+ *    × its radius is fast (everything else is handled the discrete way)
+ * 2. The broad phase files a fast body under the box its whole step sweeps,
+ *    so it is paired with everything along its path:
+ *
+ *      ┌───────────────┐
+ *      │ ○ · · · · · ● │     previous ○, current ●: one box covering both
+ *      └───────────────┘
+ *
+ * 3. The broad phase is asked for the bodies under that box; for each, the TIME OF
+ *    IMPACT t (0 = start of the step, 1 = end) is where the two moving
+ *    circles first come within touching distance - a quadratic in t
+ *    (see clampToImpact). Cost follows the number of fast bodies, not the
+ *    number of pairs in the world
+ * 4. The body is moved back to its earliest impact. It is left overlapping
+ *    by `depth` (the solver's slop), so the narrow phase right after sees an
+ *    ordinary contact and the solver bounces it with its velocity intact
+ *
+ * The rest of its motion for that step is given up (a "TOI clamp"): the body
+ * arrives at the obstacle a fraction of a step late, but never through it.
+ * Walls are not swept - boundary collision already clamps positions.
+ */
+class ContinuousCollision {
+public:
+    /**
+     * A step longer than this fraction of the body's radius makes it fast
+     * One radius: beyond that even a tiny obstacle can end up past the
+     * body's centre, and the discrete contact would push it out the far side
+     */
+    static constexpr float DEFAULT_MOTION_FRACTION = 1.0f;
+
+    void setMotionFraction(float fraction) { motionFraction = fraction; }
+    float getMotionFraction() const { return motionFraction; }
+
+    /**
+     * Collect the awake dynamic bodies that moved too far this step
+     * Call right after integration; results are in ascending index order
+     */
+    void findFastBodies(const BodyStore& bodies);
+    const std::vector<uint32_t>& getFastBodies() const { return fastBodies; }
+    void clear() { fastBodies.clear(); }
+
+    // Box covering body i at both the previous and the current position
+    static void getSweptBounds(const BodyStore& bodies, uint32_t i, sf::Vector2f& min, sf::Vector2f& max);
+
+    /**
+     * Move every fast body back to its first time of impact with anything
+     * under its swept box (see the header). Bodies that hit nothing keep
+     * their position.
+     * @param broadPhase - already updated with this step's (swept) boxes
+     * @param depth      - overlap left at the impact, so the contact is detected
+     */
+    void clampToImpact(BodyStore& bodies, const BroadPhase& broadPhase, float depth);
+
+private:
+    float motionFraction = DEFAULT_MOTION_FRACTION;
+    std::vector<uint32_t> fastBodies;
+    std::vector<float> impactTime;      // Earliest impact (0-1) of each fast body, same order
+    std::vector<uint32_t> candidates;   // Query scratch
+};
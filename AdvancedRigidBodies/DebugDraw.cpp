@@ -0,0 +1,29 @@
+#include "DebugDraw.hpp"
+#include "Vector2Utils.hpp"
+
+using namespace PhysicsUtils;
+
+namespace {
+    // Head strokes point back 2.7 radians (~155°) from the shaft direction
+    constexpr float HEAD_COS = -0.9040730f;  // cos(2.7)
+    constexpr float HEAD_SIN = 0.4273799f;   // sin(2.7)
+}
+
+void DebugDrawList::clear() {
+    points.clear();
+    lines.clear();
+}
+
+void DebugDrawList::addArrow(sf::Vector2f from, sf::Vector2f to, sf::Color colour, float headLength) {
+    lines.push_back({from, to, colour});
+
+    sf::Vector2f shaft = to - from;
+    if (length(shaft) < 1e-4f) return;
+    sf::Vector2f d = normalise(shaft);
+
+    // Shaft direction rotated by ±2.7 radians (constant angle - no trig per arrow)
+    sf::Vector2f left(d.x * HEAD_COS - d.y * HEAD_SIN, d.x * HEAD_SIN + d.y * HEAD_COS);
+    sf::Vector2f right(d.x * HEAD_COS + d.y * HEAD_SIN, -d.x * HEAD_SIN + d.y * HEAD_COS);
+    lines.push_back({to, to + left * headLength, colour});
+    lines.push_back({to, to + right * headLength, colour});
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <vector>
+
+/**
+ * Which debug layers to show (all on by default)
+ */
+struct DebugCategories {
+    bool contactPoints = true;    // Red dots where bodies touched
+    bool contactNormals = true;   // Cyan arrows along each collision normal
+    bool forces = true;           // Orange lines for the force applied this step
+};
+
+/**
+ * DEBUG DRAW COMMAND LIST
+ * =======================
+ *
+ * Debug view used to draw every contact marker as its own sf::CircleShape
+ * plus four separate line draws - thousands of draw calls exactly when
+ * there are thousands of contacts to look at.
+ *
+ * Instead, whoever has something to show (PhysicsEngine::fillDebugDraw)
+ * just RECORDS primitives here, and the renderer flushes them all at once:
+ *
+ *   fill:   addPoint addArrow addArrow addLine addPoint ...
+ *   flush:  [all points → 1 draw] [all lines → 1 draw]
+ *
+ * The list knows nothing about windows, so the engine can fill it without
+ * depending on the graphics module. Clearing keeps the capacity, so after
+ * the first few frames recording never allocates.
+ */
+class DebugDrawList {
+public:
+    struct Point {
+        sf::Vector2f position;
+        float radius;
+        sf::Color colour;
+    };
+
+    struct Line {
+        sf::Vector2f from;
+        sf::Vector2f to;
+        sf::Color colour;
+    };
+
+    void clear();
+
+    void addPoint(sf::Vector2f position, float radius, sf::Color colour) { points.push_back({position, radius, colour}); }
+    void addLine(sf::Vector2f from, sf::Vector2f to, sf::Color colour) { lines.push_back({from, to, colour}); }
+
+    /**
+     * A line with a two-stroke head at `to`
+     *
+     *            ╲
+     *   from ─────▶ to
+     *            ╱
+     */
+    void addArrow(sf::Vector2f from, sf::Vector2f to, sf::Color colour, float headLength = 5.0f);
+
+    const std::vector<Point>& getPoints() const { return points; }
+    const std::vector<Line>& getLines() const { return lines; }
+
+private:
+    std::vector<Point> points;
+    std::vector<Line> lines;
+};
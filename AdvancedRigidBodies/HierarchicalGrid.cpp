@@ -0,0 +1,167 @@
+#include "HierarchicalGrid.hpp"
+#include <algorithm>
+#include <cmath>
+
+HierarchicalGrid::HierarchicalGrid(float worldWidth, float worldHeight, float baseCellSize)
+    : worldWidth(worldWidth), worldHeight(worldHeight), baseCellSize(baseCellSize) {
+    levels.emplace_back(worldWidth, worldHeight, baseCellSize);  // Level 0 always exists
+}
+
+void HierarchicalGrid::setMaxLevels(int levelCount) {
+    maxLevels = std::clamp(levelCount, 1, MAX_LEVELS);
+    if (levels.size() > static_cast<size_t>(maxLevels)) {
+        levels.erase(levels.begin() + maxLevels, levels.end());
+    }
+    clear();
+}
+
+void HierarchicalGrid::setBaseCellSize(float cellSize) {
+    SpatialGrid::Mode currentMode = getMode();
+    baseCellSize = cellSize;
+    levels.clear();
+    levels.emplace_back(worldWidth, worldHeight, baseCellSize);
+    levels[0].setMode(currentMode);
+    levels[0].setSleepFlags(sleepFlags);
+    clear();
+}
+
+void HierarchicalGrid::setWorldSize(float width, float height) {
+    worldWidth = width;
+    worldHeight = height;
+    levels.clear();
+    levels.emplace_back(worldWidth, worldHeight, baseCellSize);
+    levels[0].setSleepFlags(sleepFlags);
+    clear();
+}
+
+void HierarchicalGrid::setMode(SpatialGrid::Mode newMode) {
+    for (SpatialGrid& level : levels) {
+        level.setMode(newMode);
+    }
+    clear();
+}
+
+void HierarchicalGrid::clear() {
+    for (SpatialGrid& level : levels) {
+        level.clear();
+    }
+    bodyLevel.clear();
+    largeBodies.clear();
+    largeSlot.clear();
+}
+
+/**
+ * Finest level whose cells are at least as wide as the body
+ *
+ * EXAMPLE with 100px base cells:
+ * - radius 20  (40px wide)  → level 0 (100px cells)
+ * - radius 150 (300px wide) → level 1 (400px cells)
+ * - radius 500 (1000px)     → level 2 (1600px cells)
+ */
+int HierarchicalGrid::levelFor(float radius) const {
+    float cellSize = baseCellSize;
+    int level = 0;
+    while (level + 1 < maxLevels && radius * 2.0f > cellSize) {
+        cellSize *= LEVEL_SCALE;
+        ++level;
+    }
+    return level;
+}
+
+SpatialGrid& HierarchicalGrid::levelAt(int level) {
+    while (levels.size() <= static_cast<size_t>(level)) {
+        float cellSize = baseCellSize * std::pow(LEVEL_SCALE, static_cast<float>(levels.size()));
+        levels.emplace_back(worldWidth, worldHeight, cellSize);
+        levels.back().setMode(levels[0].getMode());
+        levels.back().setSleepFlags(sleepFlags);
+    }
+    return levels[level];
+}
+
+void HierarchicalGrid::insert(uint32_t bodyIndex, const sf::Vector2f& position, float radius) {
+    int level = levelFor(radius);
+    if (bodyIndex >= bodyLevel.size()) {
+        bodyLevel.resize(bodyIndex + 1, 0);
+        largeSlot.resize(bodyIndex + 1, 0);
+    }
+    bodyLevel[bodyIndex] = static_cast<uint8_t>(level);
+    levelAt(level).insert(bodyIndex, position, radius);
+
+    if (level > 0) {
+        sf::Vector2f extent(radius, radius);
+        largeSlot[bodyIndex] = static_cast<uint32_t>(largeBodies.size());
+        largeBodies.push_back({bodyIndex, position - extent, position + extent});
+    }
+}
+
+bool HierarchicalGrid::update(uint32_t bodyIndex, const sf::Vector2f& min, const sf::Vector2f& max) {
+    // The level stays the one chosen at insert() - a swept box only covers more cells there
+    int level = bodyLevel[bodyIndex];
+    if (level > 0) {
+        LargeBody& large = largeBodies[largeSlot[bodyIndex]];
+        large.min = min;
+        large.max = max;
+    }
+    return levels[level].update(bodyIndex, min, max);
+}
+
+void HierarchicalGrid::rebuildIfDirty() {
+    for (SpatialGrid& level : levels) {
+        level.rebuildIfDirty();
+    }
+}
+
+void HierarchicalGrid::getPotentialCollisions(std::vector<CollisionPair>& outPairs) const {
+    // Pairs within each level (level 0 first - usually nearly all of them)
+    levels[0].getPotentialCollisions(outPairs);
+    for (size_t level = 1; level < levels.size(); ++level) {
+        levels[level].getPotentialCollisions(levelPairs);
+        outPairs.insert(outPairs.end(), levelPairs.begin(), levelPairs.end());
+    }
+
+    // Pairs across levels: every large body against the finer levels under it
+    for (const LargeBody& large : largeBodies) {
+        int level = bodyLevel[large.index];
+        bool sleeping = sleepFlags && sleepFlags[large.index];
+        for (int finer = 0; finer < level; ++finer) {
+            levels[finer].queryRect(large.min, large.max, queryScratch);
+            for (uint32_t other : queryScratch) {
+                if (sleeping && sleepFlags[other]) continue;
+                outPairs.push_back({large.index, other});
+            }
+        }
+    }
+}
+
+void HierarchicalGrid::setSleepFlags(const uint8_t* flags) {
+    sleepFlags = flags;
+    for (SpatialGrid& level : levels) {
+        level.setSleepFlags(flags);
+    }
+}
+
+void HierarchicalGrid::queryRect(const sf::Vector2f& min, const sf::Vector2f& max, std::vector<uint32_t>& outBodies) const {
+    // A body lives in one level only, so the union has no duplicates
+    levels[0].queryRect(min, max, outBodies);
+    for (size_t level = 1; level < levels.size(); ++level) {
+        levels[level].queryRect(min, max, queryScratch);
+        outBodies.insert(outBodies.end(), queryScratch.begin(), queryScratch.end());
+    }
+}
+
+void HierarchicalGrid::queryRay(const sf::Vector2f& origin, const sf::Vector2f& direction, float maxDistance,
+                                float thickness, RayVisitor& visitor) const {
+    // A hit found in a finer level shortens the walk through the coarser ones
+    float distance = maxDistance;
+    for (const SpatialGrid& level : levels) {
+        distance = level.queryRay(origin, direction, distance, thickness, visitor);
+    }
+}
+
+size_t HierarchicalGrid::getCellCount() const {
+    size_t count = 0;
+    for (const SpatialGrid& level : levels) {
+        count += level.getCellCount();
+    }
+    return count;
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <vector>
+#include "BroadPhase.hpp"
+#include "SpatialGrid.hpp"
+
+/**
+ * HIERARCHICAL GRID - ONE CELL SIZE PER BODY SIZE
+ * ===============================================
+ *
+ * PROBLEM: A single cell size can't suit very different body sizes
+ * - 100px cells suit 8-35px bodies
+ * - A 250px boulder covers 6 × 6 = 36 of those cells: 36 entries, and it
+ *   shows up as a candidate for every small body in every one of them
+ * - Cells big enough for the boulder put hundreds of small bodies in each
+ *   cell, and the per-cell pair test is O(k²)
+ *
+ * SOLUTION: Several grids (LEVELS), each LEVEL_SCALE times coarser:
+ *
+ *   level 2 (1600px)  ┌───────────────────────────────┐
+ *                     │                               │   mountains
+ *   level 1 (400px)   ├───────┬───────┬───────┬───────┤
+ *                     │   ●   │       │       │       │   boulders
+ *   level 0 (100px)   ├─┬─┬─┬─┼─┬─┬─┬─┼─┬─┬─┬─┼─┬─┬─┬─┤
+ *                     │·│·│ │·│ │·│·│ │ │·│ │ │·│ │·│·│   everyday bodies
+ *
+ * Every body lives in exactly ONE level: the finest whose cells are at least
+ * as wide as the body, so it covers at most 2 × 2 cells there.
+ *
+ * PAIRS:
+ * - Same level: that level's own broad phase (owner-cell rule and all)
+ * - Across levels: each body of a coarser level asks every finer level for
+ *   the bodies under its bounding box (SpatialGrid::queryRect)
+ *
+ * Each cross-level pair is found once - from its larger body. Large bodies
+ * are rare, so these queries cost little next to the level-0 broad phase.
+ * When every body fits level 0 there is only one level, and this is exactly
+ * the single fixed grid it replaces.
+ *
+ * Body indices are the same in every level; a level simply never sees the
+ * bodies kept elsewhere (they cover no cells there).
+ *
+ * This is the engine's default BroadPhase.
+ */
+class HierarchicalGrid : public BroadPhase {
+public:
+    static constexpr float LEVEL_SCALE = 4.0f;  // Each level's cells are 4× wider than the last
+    static constexpr int MAX_LEVELS = 6;
+
+    HierarchicalGrid(float worldWidth, float worldHeight, float baseCellSize);
+
+    /**
+     * Cap the number of levels (1 = single fixed grid, bodies of any size in
+     * level 0). Empties the grid - insert everything again.
+     */
+    void setMaxLevels(int levels);
+    int getMaxLevels() const { return maxLevels; }
+
+    // Cell size of level 0 (default 100px); empties the grid
+    void setBaseCellSize(float cellSize);
+    float getBaseCellSize() const { return baseCellSize; }
+
+    // World the grid covers; storage mode re-picked for the new size (as in the constructor), empties the grid
+    void setWorldSize(float width, float height);
+
+    // Storage mode for every level (see SpatialGrid::Mode); empties the grid
+    void setMode(SpatialGrid::Mode newMode);
+    SpatialGrid::Mode getMode() const { return levels[0].getMode(); }
+
+    // Same contract as SpatialGrid (see BroadPhase)
+    using BroadPhase::update;
+    void clear() override;
+    void insert(uint32_t bodyIndex, const sf::Vector2f& position, float radius) override;
+    bool update(uint32_t bodyIndex, const sf::Vector2f& min, const sf::Vector2f& max) override;
+    void rebuildIfDirty() override;
+    void getPotentialCollisions(std::vector<CollisionPair>& outPairs) const override;
+    void queryRect(const sf::Vector2f& min, const sf::Vector2f& max, std::vector<uint32_t>& outBodies) const override;
+    void queryRay(const sf::Vector2f& origin, const sf::Vector2f& direction, float maxDistance,
+                  float thickness, RayVisitor& visitor) const override;  // Level by level, each cut short by the last
+    void setSleepFlags(const uint8_t* flags) override;  // See SpatialGrid::setSleepFlags; applies to every level
+
+    size_t getBodyCount() const override { return bodyLevel.size(); }
+    size_t getCellCount() const;
+    size_t getLevelCount() const { return levels.size(); }
+
+private:
+    int levelFor(float radius) const;
+    SpatialGrid& levelAt(int level);  // Creates missing levels on first use
+
+    float worldWidth;
+    float worldHeight;
+    float baseCellSize;
+    int maxLevels = MAX_LEVELS;
+    const uint8_t* sleepFlags = nullptr;  // Not owned
+
+    std::vector<SpatialGrid> levels;   // levels[0] is the finest
+    std::vector<uint8_t> bodyLevel;    // Level of every inserted body
+
+    // Bodies above level 0 with their current bounding boxes (for cross-level queries)
+    struct LargeBody {
+        uint32_t index;
+        sf::Vector2f min;
+        sf::Vector2f max;
+    };
+    std::vector<LargeBody> largeBodies;
+    std::vector<uint32_t> largeSlot;   // Body index → position in largeBodies (large bodies only)
+
+    // Scratch reused between calls (no allocation once warmed up)
+    mutable std::vector<CollisionPair> levelPairs;
+    mutable std::vector<uint32_t> queryScratch;
+};
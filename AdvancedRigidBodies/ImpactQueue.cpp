@@ -0,0 +1,114 @@
+#include "ImpactQueue.hpp"
+#include "ParticleSystem.hpp"
+#include "Vector2Utils.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace PhysicsUtils;
+
+ImpactQueue::ImpactQueue() : threadBuffers(1) {
+}
+
+void ImpactQueue::setThreadCount(unsigned count) {
+    threadBuffers.resize(std::max(1u, count));
+}
+
+/**
+ * Pack the square an event falls in into one sortable key
+ * (signed cell coordinates stored as two 32-bit halves)
+ */
+static uint64_t cellKeyFor(sf::Vector2f point, float cellSize) {
+    auto cellX = static_cast<int32_t>(std::floor(point.x / cellSize));
+    auto cellY = static_cast<int32_t>(std::floor(point.y / cellSize));
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cellX)) << 32) | static_cast<uint32_t>(cellY);
+}
+
+/**
+ * Buffers are replayed in thread order so particle RNG is consumed
+ * identically every run
+ */
+void ImpactQueue::flush(ParticleSystem& particles) {
+    merged.clear();
+    eventCount = 0;
+
+    // Merge + cull
+    uint32_t order = 0;
+    bool merging = settings.coalesceRadius > 0.0f;
+    for (auto& buffer : threadBuffers) {
+        eventCount += buffer.size();
+        for (const ImpactEvent& event : buffer) {
+            if (event.intensity < settings.minIntensity) continue;
+
+            // Without coalescing every event gets a square of its own
+            uint64_t key = merging ? cellKeyFor(event.point, settings.coalesceRadius) : order;
+            merged.push_back({key, order++, event});
+        }
+        buffer.clear();
+    }
+
+    coalesce();
+
+    // Limit: keep the strongest bursts (nth_element = O(n), no full sort)
+    if (bursts.size() > settings.maxBurstsPerStep) {
+        std::nth_element(bursts.begin(), bursts.begin() + settings.maxBurstsPerStep, bursts.end(),
+            [](const ImpactEvent& a, const ImpactEvent& b) { return a.intensity > b.intensity; });
+        bursts.resize(settings.maxBurstsPerStep);
+    }
+
+    for (const ImpactEvent& burst : bursts) {
+        particles.createImpactBurst(burst.point, burst.normal, burst.colour, burst.intensity);
+    }
+    burstCount = bursts.size();
+}
+
+/**
+ * Turn each run of same-square events into one burst
+ *
+ * Sorting by key puts events from the same square next to each other:
+ *
+ *   keys:  [7 7 7 | 9 | 12 12]  →  3 bursts
+ *
+ * Each burst gets:
+ * - point, normal: averages weighted by intensity (strong hits dominate)
+ * - colour: the strongest event's
+ * - intensity: the sum, capped at 1 (many small hits = one bigger one)
+ */
+void ImpactQueue::coalesce() {
+    bursts.clear();
+    std::sort(merged.begin(), merged.end(), [](const KeyedEvent& a, const KeyedEvent& b) {
+        return a.cellKey != b.cellKey ? a.cellKey < b.cellKey : a.order < b.order;
+    });
+
+    for (size_t begin = 0; begin < merged.size();) {
+        size_t end = begin + 1;
+        while (end < merged.size() && merged[end].cellKey == merged[begin].cellKey) {
+            ++end;
+        }
+
+        if (end - begin == 1) {
+            bursts.push_back(merged[begin].event);
+            begin = end;
+            continue;
+        }
+
+        const ImpactEvent* strongest = &merged[begin].event;
+        sf::Vector2f pointSum(0.f, 0.f);
+        sf::Vector2f normalSum(0.f, 0.f);
+        float weightSum = 0.0f;
+        for (size_t i = begin; i < end; ++i) {
+            const ImpactEvent& event = merged[i].event;
+            float weight = std::max(event.intensity, 1e-4f);
+            pointSum += event.point * weight;
+            normalSum += event.normal * weight;
+            weightSum += weight;
+            if (event.intensity > strongest->intensity) {
+                strongest = &event;
+            }
+        }
+
+        // Opposing normals can cancel out - fall back to the strongest one
+        sf::Vector2f normal = length(normalSum) > 1e-3f ? normalise(normalSum) : strongest->normal;
+        bursts.push_back({pointSum / weightSum, normal, strongest->colour, std::min(1.0f, weightSum)});
+        begin = end;
+    }
+}
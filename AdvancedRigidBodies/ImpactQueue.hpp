@@ -0,0 +1,98 @@
+#pragma once
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <vector>
+
+class ParticleSystem;
+
+/**
+ * A collision worth showing sparks for
+ * Produced by the solver, consumed later by the particle system
+ */
+struct ImpactEvent {
+    sf::Vector2f point;
+    sf::Vector2f normal;
+    sf::Color colour;
+    float intensity;   // 0-1
+};
+
+/**
+ * IMPACT FILTERING
+ *
+ *   minIntensity      - weaker impacts are dropped before anything else
+ *   coalesceRadius    - impacts in the same square of this size become one burst
+ *   maxBurstsPerStep  - only the strongest bursts survive past this many
+ */
+struct ImpactSettings {
+    float minIntensity = 0.05f;
+    float coalesceRadius = 24.0f;   // Pixels (0 = never merge)
+    size_t maxBurstsPerStep = 32;
+};
+
+/**
+ * DEFERRED IMPACT QUEUE - SPARKS OUT OF THE SOLVER
+ * ================================================
+ *
+ * Spawning particles means random numbers and memory writes - work that
+ * doesn't belong inside the contact loops (and can't run there in parallel,
+ * because the particle pool and its RNG are shared). So the solver only
+ * writes small ImpactEvents into one buffer PER THREAD, and this queue turns
+ * them into bursts later, on one thread:
+ *
+ *   thread 0: [e e e]   thread 1: [e e]   thread 2: [e e e e]
+ *        └──────────── merge (thread order) ─────────────┘
+ *                              │
+ *                  cull   (too weak → gone)
+ *                  coalesce (same area → one burst)
+ *                  limit  (keep the strongest maxBurstsPerStep)
+ *                              │
+ *                     ParticleSystem bursts
+ *
+ * WHY COALESCE?
+ * When a pile collapses, dozens of contacts in a hand-sized area fire in the
+ * same step. Their sparks would overlap into one blob anyway, so one burst
+ * with their combined intensity looks the same for a fraction of the cost.
+ * With the per-step limit, particle work stays bounded however many
+ * contacts there are.
+ */
+class ImpactQueue {
+public:
+    ImpactQueue();
+
+    // One buffer per pool thread (call when the thread count changes)
+    void setThreadCount(unsigned count);
+
+    // Per-thread buffers for the solver to fill (see ContactSolver::emitImpactEvents)
+    std::vector<std::vector<ImpactEvent>>& getThreadBuffers() { return threadBuffers; }
+
+    void setSettings(const ImpactSettings& newSettings) { settings = newSettings; }
+    const ImpactSettings& getSettings() const { return settings; }
+
+    /**
+     * Merge, cull, coalesce and limit this step's events, spawn their bursts,
+     * and empty every buffer
+     */
+    void flush(ParticleSystem& particles);
+
+    // Last flush's workload
+    size_t getEventCount() const { return eventCount; }
+    size_t getBurstCount() const { return burstCount; }
+
+private:
+    void coalesce();
+
+    struct KeyedEvent {
+        uint64_t cellKey;   // Coalescing square the event falls in
+        uint32_t order;     // Arrival order - keeps the sort deterministic
+        ImpactEvent event;
+    };
+
+    ImpactSettings settings;
+    std::vector<std::vector<ImpactEvent>> threadBuffers;
+    std::vector<KeyedEvent> merged;    // Scratch, keeps its capacity
+    std::vector<ImpactEvent> bursts;   // Scratch, keeps its capacity
+
+    size_t eventCount = 0;
+    size_t burstCount = 0;
+};
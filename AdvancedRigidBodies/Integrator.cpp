@@ -0,0 +1,350 @@
+#include "Integrator.hpp"
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define RIGIDBODY_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #endif
+#endif
+
+/**
+ * GCC/Clang only allow AVX instructions in functions marked for them
+ * (MSVC allows intrinsics anywhere, so the macro is empty there)
+ */
+#if defined(__GNUC__) || defined(__clang__)
+    #define RIGIDBODY_TARGET(isa) __attribute__((target(isa)))
+#else
+    #define RIGIDBODY_TARGET(isa)
+#endif
+
+/**
+ * NO FUSED MULTIPLY-ADD
+ * AVX-512 includes FMA, and compilers will happily turn a*b + c into one
+ * fused instruction - which rounds once instead of twice and so gives a
+ * slightly different answer than the other levels. Keep every level exact.
+ */
+#if defined(__clang__)
+    #pragma clang fp contract(off)
+#elif defined(__GNUC__)
+    #pragma GCC optimize("fp-contract=off")
+#endif
+
+namespace {
+    constexpr float LINEAR_DAMPING = 0.99f;
+    constexpr float ANGULAR_DAMPING = 0.98f;
+
+    /**
+     * SCALAR REFERENCE
+     * The SIMD versions do exactly this, lane by lane. Also used for the
+     * leftover bodies at the end of the arrays (count not a multiple of the width).
+     */
+    void integrateScalar(BodyStore& b, const IntegrationParams& p, size_t begin, size_t end) {
+        float dt = p.deltaTime;
+
+        for (size_t i = begin; i < end; ++i) {
+            // Sleeping bodies are frozen until their island wakes (see IslandManager)
+            if (b.isStatic[i] || b.isResting[i]) continue;
+
+            // Remember where this step started, for render interpolation
+            b.previousPositionX[i] = b.positionX[i];
+            b.previousPositionY[i] = b.positionY[i];
+            b.previousRotation[i] = b.rotation[i];
+
+            // NEWTON'S SECOND LAW: a = F/m, and gravity's force is F = m*g, so a = g
+            float ax = b.accelerationX[i] + p.gravityX;
+            float ay = b.accelerationY[i] + p.gravityY;
+
+            // SEMI-IMPLICIT EULER: velocity first, then position with the NEW velocity
+            float vx = b.velocityX[i] + ax * dt;
+            float vy = b.velocityY[i] + ay * dt;
+            b.positionX[i] += vx * dt;
+            b.positionY[i] += vy * dt;
+            b.velocityX[i] = vx * LINEAR_DAMPING;
+            b.velocityY[i] = vy * LINEAR_DAMPING;
+
+            float w = b.angularVelocity[i] + b.angularAcceleration[i] * dt;
+            b.rotation[i] += w * dt;
+            b.angularVelocity[i] = w * ANGULAR_DAMPING;
+
+            b.accelerationX[i] = 0.f;
+            b.accelerationY[i] = 0.f;
+            b.angularAcceleration[i] = 0.f;
+        }
+    }
+
+#if RIGIDBODY_X86
+    /**
+     * SSE2: 4 bodies at a time
+     * No blend instruction in SSE2, so select = (mask & a) | (~mask & b)
+     */
+    RIGIDBODY_TARGET("sse2")
+    inline __m128 select4(__m128 mask, __m128 a, __m128 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    RIGIDBODY_TARGET("sse2")
+    inline __m128 loadFlags4(const uint8_t* flags) {
+        int32_t packed;
+        std::memcpy(&packed, flags, sizeof(packed));
+        __m128i bytes = _mm_cvtsi32_si128(packed);
+        __m128i zero = _mm_setzero_si128();
+        __m128i ints = _mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero);
+        return _mm_castsi128_ps(_mm_cmpgt_epi32(ints, zero));  // All ones where flag != 0
+    }
+
+    RIGIDBODY_TARGET("sse2")
+    void integrateSSE2(BodyStore& b, const IntegrationParams& p) {
+        const size_t n = b.size();
+        const __m128 dt = _mm_set1_ps(p.deltaTime);
+        const __m128 gx = _mm_set1_ps(p.gravityX);
+        const __m128 gy = _mm_set1_ps(p.gravityY);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 allOnes = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m128 isStatic = loadFlags4(&b.isStatic[i]);
+            __m128 isResting = loadFlags4(&b.isResting[i]);
+            // Only awake dynamic lanes change; static and sleeping lanes keep every value
+            __m128 awake = _mm_andnot_ps(_mm_or_ps(isStatic, isResting), allOnes);
+
+            __m128 x = _mm_loadu_ps(&b.positionX[i]);
+            __m128 y = _mm_loadu_ps(&b.positionY[i]);
+            __m128 rot = _mm_loadu_ps(&b.rotation[i]);
+            _mm_storeu_ps(&b.previousPositionX[i], select4(awake, x, _mm_loadu_ps(&b.previousPositionX[i])));
+            _mm_storeu_ps(&b.previousPositionY[i], select4(awake, y, _mm_loadu_ps(&b.previousPositionY[i])));
+            _mm_storeu_ps(&b.previousRotation[i], select4(awake, rot, _mm_loadu_ps(&b.previousRotation[i])));
+
+            __m128 accelX = _mm_loadu_ps(&b.accelerationX[i]);
+            __m128 accelY = _mm_loadu_ps(&b.accelerationY[i]);
+            __m128 ax = _mm_add_ps(accelX, gx);
+            __m128 ay = _mm_add_ps(accelY, gy);
+
+            __m128 vx = _mm_loadu_ps(&b.velocityX[i]);
+            __m128 vy = _mm_loadu_ps(&b.velocityY[i]);
+            __m128 w = _mm_loadu_ps(&b.angularVelocity[i]);
+            __m128 alpha = _mm_loadu_ps(&b.angularAcceleration[i]);
+
+            // SEMI-IMPLICIT EULER + DAMPING (computed for all lanes, kept where awake)
+            __m128 nvx = _mm_add_ps(vx, _mm_mul_ps(ax, dt));
+            __m128 nvy = _mm_add_ps(vy, _mm_mul_ps(ay, dt));
+            __m128 nx = _mm_add_ps(x, _mm_mul_ps(nvx, dt));
+            __m128 ny = _mm_add_ps(y, _mm_mul_ps(nvy, dt));
+            __m128 nw = _mm_add_ps(w, _mm_mul_ps(alpha, dt));
+            __m128 nrot = _mm_add_ps(rot, _mm_mul_ps(nw, dt));
+            nvx = _mm_mul_ps(nvx, _mm_set1_ps(LINEAR_DAMPING));
+            nvy = _mm_mul_ps(nvy, _mm_set1_ps(LINEAR_DAMPING));
+            nw = _mm_mul_ps(nw, _mm_set1_ps(ANGULAR_DAMPING));
+
+            _mm_storeu_ps(&b.positionX[i], select4(awake, nx, x));
+            _mm_storeu_ps(&b.positionY[i], select4(awake, ny, y));
+            _mm_storeu_ps(&b.rotation[i], select4(awake, nrot, rot));
+            _mm_storeu_ps(&b.velocityX[i], select4(awake, nvx, vx));
+            _mm_storeu_ps(&b.velocityY[i], select4(awake, nvy, vy));
+            _mm_storeu_ps(&b.angularVelocity[i], select4(awake, nw, w));
+
+            _mm_storeu_ps(&b.accelerationX[i], select4(awake, zero, accelX));
+            _mm_storeu_ps(&b.accelerationY[i], select4(awake, zero, accelY));
+            _mm_storeu_ps(&b.angularAcceleration[i], select4(awake, zero, alpha));
+        }
+
+        integrateScalar(b, p, i, n);
+    }
+
+    /**
+     * AVX2: 8 bodies at a time, with a real blend instruction
+     * _mm256_blendv_ps(b, a, mask) = mask ? a : b
+     */
+    RIGIDBODY_TARGET("avx2")
+    inline __m256 loadFlags8(const uint8_t* flags) {
+        __m256i ints = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(flags)));
+        return _mm256_castsi256_ps(_mm256_cmpgt_epi32(ints, _mm256_setzero_si256()));
+    }
+
+    RIGIDBODY_TARGET("avx2")
+    void integrateAVX2(BodyStore& b, const IntegrationParams& p) {
+        const size_t n = b.size();
+        const __m256 dt = _mm256_set1_ps(p.deltaTime);
+        const __m256 gx = _mm256_set1_ps(p.gravityX);
+        const __m256 gy = _mm256_set1_ps(p.gravityY);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 allOnes = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256 isStatic = loadFlags8(&b.isStatic[i]);
+            __m256 isResting = loadFlags8(&b.isResting[i]);
+            __m256 awake = _mm256_andnot_ps(_mm256_or_ps(isStatic, isResting), allOnes);
+
+            __m256 x = _mm256_loadu_ps(&b.positionX[i]);
+            __m256 y = _mm256_loadu_ps(&b.positionY[i]);
+            __m256 rot = _mm256_loadu_ps(&b.rotation[i]);
+            _mm256_storeu_ps(&b.previousPositionX[i], _mm256_blendv_ps(_mm256_loadu_ps(&b.previousPositionX[i]), x, awake));
+            _mm256_storeu_ps(&b.previousPositionY[i], _mm256_blendv_ps(_mm256_loadu_ps(&b.previousPositionY[i]), y, awake));
+            _mm256_storeu_ps(&b.previousRotation[i], _mm256_blendv_ps(_mm256_loadu_ps(&b.previousRotation[i]), rot, awake));
+
+            __m256 accelX = _mm256_loadu_ps(&b.accelerationX[i]);
+            __m256 accelY = _mm256_loadu_ps(&b.accelerationY[i]);
+            __m256 ax = _mm256_add_ps(accelX, gx);
+            __m256 ay = _mm256_add_ps(accelY, gy);
+
+            __m256 vx = _mm256_loadu_ps(&b.velocityX[i]);
+            __m256 vy = _mm256_loadu_ps(&b.velocityY[i]);
+            __m256 w = _mm256_loadu_ps(&b.angularVelocity[i]);
+            __m256 alpha = _mm256_loadu_ps(&b.angularAcceleration[i]);
+
+            __m256 nvx = _mm256_add_ps(vx, _mm256_mul_ps(ax, dt));
+            __m256 nvy = _mm256_add_ps(vy, _mm256_mul_ps(ay, dt));
+            __m256 nx = _mm256_add_ps(x, _mm256_mul_ps(nvx, dt));
+            __m256 ny = _mm256_add_ps(y, _mm256_mul_ps(nvy, dt));
+            __m256 nw = _mm256_add_ps(w, _mm256_mul_ps(alpha, dt));
+            __m256 nrot = _mm256_add_ps(rot, _mm256_mul_ps(nw, dt));
+            nvx = _mm256_mul_ps(nvx, _mm256_set1_ps(LINEAR_DAMPING));
+            nvy = _mm256_mul_ps(nvy, _mm256_set1_ps(LINEAR_DAMPING));
+            nw = _mm256_mul_ps(nw, _mm256_set1_ps(ANGULAR_DAMPING));
+
+            _mm256_storeu_ps(&b.positionX[i], _mm256_blendv_ps(x, nx, awake));
+            _mm256_storeu_ps(&b.positionY[i], _mm256_blendv_ps(y, ny, awake));
+            _mm256_storeu_ps(&b.rotation[i], _mm256_blendv_ps(rot, nrot, awake));
+            _mm256_storeu_ps(&b.velocityX[i], _mm256_blendv_ps(vx, nvx, awake));
+            _mm256_storeu_ps(&b.velocityY[i], _mm256_blendv_ps(vy, nvy, awake));
+            _mm256_storeu_ps(&b.angularVelocity[i], _mm256_blendv_ps(w, nw, awake));
+
+            _mm256_storeu_ps(&b.accelerationX[i], _mm256_blendv_ps(accelX, zero, awake));
+            _mm256_storeu_ps(&b.accelerationY[i], _mm256_blendv_ps(accelY, zero, awake));
+            _mm256_storeu_ps(&b.angularAcceleration[i], _mm256_blendv_ps(alpha, zero, awake));
+        }
+
+        integrateScalar(b, p, i, n);
+    }
+
+    /**
+     * AVX-512: 16 bodies at a time
+     * Comparisons produce a 16-bit MASK REGISTER (one bit per lane) instead of
+     * a vector, and most instructions take a mask directly:
+     *   _mm512_mask_add_ps(src, mask, a, b) = mask ? a + b : src
+     */
+    RIGIDBODY_TARGET("avx512f")
+    void integrateAVX512(BodyStore& b, const IntegrationParams& p) {
+        const size_t n = b.size();
+        const __m512 dt = _mm512_set1_ps(p.deltaTime);
+        const __m512 gx = _mm512_set1_ps(p.gravityX);
+        const __m512 gy = _mm512_set1_ps(p.gravityY);
+        const __m512 zero = _mm512_setzero_ps();
+        const __m512i zeroInt = _mm512_setzero_si512();
+
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            __m128i staticBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&b.isStatic[i]));
+            __m128i restingBytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&b.isResting[i]));
+            // maskz form with all lanes on == plain widen (avoids a GCC false-positive warning)
+            __mmask16 isStatic = _mm512_cmpneq_epi32_mask(_mm512_maskz_cvtepu8_epi32(0xFFFF, staticBytes), zeroInt);
+            __mmask16 isResting = _mm512_cmpneq_epi32_mask(_mm512_maskz_cvtepu8_epi32(0xFFFF, restingBytes), zeroInt);
+            __mmask16 awake = static_cast<__mmask16>(~(isStatic | isResting));
+
+            __m512 x = _mm512_loadu_ps(&b.positionX[i]);
+            __m512 y = _mm512_loadu_ps(&b.positionY[i]);
+            __m512 rot = _mm512_loadu_ps(&b.rotation[i]);
+            _mm512_mask_storeu_ps(&b.previousPositionX[i], awake, x);
+            _mm512_mask_storeu_ps(&b.previousPositionY[i], awake, y);
+            _mm512_mask_storeu_ps(&b.previousRotation[i], awake, rot);
+
+            __m512 ax = _mm512_add_ps(_mm512_loadu_ps(&b.accelerationX[i]), gx);
+            __m512 ay = _mm512_add_ps(_mm512_loadu_ps(&b.accelerationY[i]), gy);
+
+            __m512 vx = _mm512_loadu_ps(&b.velocityX[i]);
+            __m512 vy = _mm512_loadu_ps(&b.velocityY[i]);
+            __m512 w = _mm512_loadu_ps(&b.angularVelocity[i]);
+            __m512 alpha = _mm512_loadu_ps(&b.angularAcceleration[i]);
+
+            __m512 nvx = _mm512_add_ps(vx, _mm512_mul_ps(ax, dt));
+            __m512 nvy = _mm512_add_ps(vy, _mm512_mul_ps(ay, dt));
+            __m512 nx = _mm512_add_ps(x, _mm512_mul_ps(nvx, dt));
+            __m512 ny = _mm512_add_ps(y, _mm512_mul_ps(nvy, dt));
+            __m512 nw = _mm512_add_ps(w, _mm512_mul_ps(alpha, dt));
+            __m512 nrot = _mm512_add_ps(rot, _mm512_mul_ps(nw, dt));
+            nvx = _mm512_mul_ps(nvx, _mm512_set1_ps(LINEAR_DAMPING));
+            nvy = _mm512_mul_ps(nvy, _mm512_set1_ps(LINEAR_DAMPING));
+            nw = _mm512_mul_ps(nw, _mm512_set1_ps(ANGULAR_DAMPING));
+
+            _mm512_mask_storeu_ps(&b.positionX[i], awake, nx);
+            _mm512_mask_storeu_ps(&b.positionY[i], awake, ny);
+            _mm512_mask_storeu_ps(&b.rotation[i], awake, nrot);
+            _mm512_mask_storeu_ps(&b.velocityX[i], awake, nvx);
+            _mm512_mask_storeu_ps(&b.velocityY[i], awake, nvy);
+            _mm512_mask_storeu_ps(&b.angularVelocity[i], awake, nw);
+
+            _mm512_mask_storeu_ps(&b.accelerationX[i], awake, zero);
+            _mm512_mask_storeu_ps(&b.accelerationY[i], awake, zero);
+            _mm512_mask_storeu_ps(&b.angularAcceleration[i], awake, zero);
+        }
+
+        integrateScalar(b, p, i, n);
+    }
+#endif
+}
+
+namespace Integrator {
+    /**
+     * CPU FEATURE DETECTION
+     * CPUID reports what the CPU supports; XGETBV reports whether the OS saves
+     * the wide registers on a context switch (if not, AVX can't be used safely)
+     */
+    SimdLevel detectSimdLevel() {
+#if RIGIDBODY_X86
+    #if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        int maxLeaf = info[0];
+
+        __cpuid(info, 1);
+        bool sse2 = (info[3] & (1 << 26)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+        bool osAvx = (xcr0 & 0x6) == 0x6;        // XMM + YMM state
+        bool osAvx512 = (xcr0 & 0xE6) == 0xE6;   // + opmask and ZMM state
+
+        bool avx2 = false;
+        bool avx512 = false;
+        if (maxLeaf >= 7) {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+            avx512 = (info[1] & (1 << 16)) != 0;
+        }
+
+        if (avx512 && osAvx512) return SimdLevel::AVX512;
+        if (avx2 && osAvx) return SimdLevel::AVX2;
+        if (sse2) return SimdLevel::SSE2;
+    #else
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+        if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+        if (__builtin_cpu_supports("sse2")) return SimdLevel::SSE2;
+    #endif
+#endif
+        return SimdLevel::Scalar;
+    }
+
+    const char* getSimdLevelName(SimdLevel level) {
+        switch (level) {
+            case SimdLevel::SSE2:   return "SSE2";
+            case SimdLevel::AVX2:   return "AVX2";
+            case SimdLevel::AVX512: return "AVX-512";
+            default:                return "Scalar";
+        }
+    }
+
+    void integrate(BodyStore& bodies, const IntegrationParams& params, SimdLevel level) {
+#if RIGIDBODY_X86
+        switch (level) {
+            case SimdLevel::AVX512: integrateAVX512(bodies, params); return;
+            case SimdLevel::AVX2:   integrateAVX2(bodies, params); return;
+            case SimdLevel::SSE2:   integrateSSE2(bodies, params); return;
+            default: break;
+        }
+#endif
+        integrateScalar(bodies, params, 0, bodies.size());
+    }
+}
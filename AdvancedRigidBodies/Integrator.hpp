@@ -0,0 +1,68 @@
+#pragma once
+#include "BodyStore.hpp"
+
+/**
+ * SIMD INTEGRATOR - MANY BODIES PER INSTRUCTION
+ * =============================================
+ *
+ * SIMD = Single Instruction, Multiple Data. One CPU instruction does the same
+ * math on a whole register of floats at once:
+ *
+ *   scalar:  x0 += v0*dt                         (1 body per instruction)
+ *   SSE:     [x0 x1 x2 x3] += [v0 v1 v2 v3]*dt     (4 bodies)
+ *   AVX2:    8 bodies      AVX-512: 16 bodies
+ *
+ * This only works because BodyStore keeps each field in its own array
+ * (SoA) - positionX[i..i+7] is one contiguous load.
+ *
+ * Integration is the perfect candidate: every body does exactly the same
+ * steps with no dependence on any other body.
+ *
+ * BRANCHES BECOME MASKS:
+ * SIMD lanes can't take different branches, so "if asleep, skip" becomes:
+ * compute the result for every lane, then SELECT per lane:
+ *
+ *   result = mask ? newValue : oldValue     (blend / and-or)
+ *
+ * RUNTIME DISPATCH:
+ * Not every CPU has AVX2 or AVX-512. detectSimdLevel() asks the CPU (CPUID)
+ * at startup, and integrate() calls the widest version it supports. Each
+ * version is compiled for its own instruction set, so one executable runs
+ * everywhere.
+ *
+ * EXACTNESS:
+ * Every version does the same float operations in the same order (no fused
+ * multiply-add), so all levels produce bit-identical results.
+ */
+
+enum class SimdLevel {
+    Scalar,
+    SSE2,     // 4 lanes
+    AVX2,     // 8 lanes
+    AVX512    // 16 lanes
+};
+
+struct IntegrationParams {
+    float deltaTime;
+    float gravityX;
+    float gravityY;
+};
+
+namespace Integrator {
+    /**
+     * Widest instruction set this CPU (and OS) supports
+     */
+    SimdLevel detectSimdLevel();
+
+    const char* getSimdLevelName(SimdLevel level);
+
+    /**
+     * Gravity, semi-implicit Euler and damping for every awake dynamic body
+     * Also saves the previous position/rotation and clears accelerations.
+     * Static and sleeping bodies are left untouched (IslandManager decides
+     * who sleeps). Wall collisions are NOT handled here.
+     *
+     * @param level - Must not exceed detectSimdLevel()
+     */
+    void integrate(BodyStore& bodies, const IntegrationParams& params, SimdLevel level);
+}
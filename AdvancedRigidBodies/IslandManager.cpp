@@ -0,0 +1,205 @@
+#include "IslandManager.hpp"
+#include <algorithm>
+#include <cmath>
+
+void IslandManager::wakeFlagged(BodyStore& bodies) {
+    // New bodies are appended awake
+    nextSleeper.resize(bodies.size(), NO_BODY);
+
+    for (uint32_t i = 0; i < nextSleeper.size(); ++i) {
+        if (nextSleeper[i] != NO_BODY && !bodies.isResting[i]) {
+            wakeIsland(bodies, i);
+        }
+    }
+}
+
+void IslandManager::wakeTouched(BodyStore& bodies, const std::vector<Contact>& contacts) {
+    for (const Contact& c : contacts) {
+        bool awakeA = !bodies.isStatic[c.bodyA] && !bodies.isResting[c.bodyA];
+        bool awakeB = !bodies.isStatic[c.bodyB] && !bodies.isResting[c.bodyB];
+        if (awakeA && bodies.isResting[c.bodyB]) wakeIsland(bodies, c.bodyB);
+        if (awakeB && bodies.isResting[c.bodyA]) wakeIsland(bodies, c.bodyA);
+    }
+}
+
+void IslandManager::update(BodyStore& bodies, const std::vector<Contact>& contacts, float deltaTime) {
+    const uint32_t n = static_cast<uint32_t>(bodies.size());
+    nextSleeper.resize(n, NO_BODY);
+    parent.resize(n);
+    islandTime.resize(n);
+    islandRing.resize(n);
+
+    // How long has each awake body been still? (see the header: slow, or shaking in place)
+    const float stepDistance = RigidBody::REST_VELOCITY_THRESHOLD * deltaTime;
+    const float stepDistanceSq = stepDistance * stepDistance;
+    const float driftSq = SLEEP_DRIFT * SLEEP_DRIFT;
+
+    for (uint32_t i = 0; i < n; ++i) {
+        parent[i] = i;
+        islandTime[i] = TIME_TO_SLEEP;
+        islandRing[i] = NO_BODY;
+        if (bodies.isStatic[i] || bodies.isResting[i]) continue;
+
+        float r = bodies.radius[i];
+        float sx = bodies.positionX[i] - bodies.previousPositionX[i];
+        float sy = bodies.positionY[i] - bodies.previousPositionY[i];
+        float stepRim = std::fabs(bodies.rotation[i] - bodies.previousRotation[i]) * r;
+        bool slow = sx * sx + sy * sy < stepDistanceSq && stepRim < stepDistance;
+
+        float dx = bodies.positionX[i] - bodies.sleepAnchorX[i];
+        float dy = bodies.positionY[i] - bodies.sleepAnchorY[i];
+        float driftRim = std::fabs(bodies.rotation[i] - bodies.sleepAnchorRotation[i]) * r;
+        bool inPlace = dx * dx + dy * dy < driftSq && driftRim < SLEEP_DRIFT;
+
+        if (slow || inPlace) {
+            bodies.sleepTime[i] += deltaTime;
+        } else {
+            bodies.sleepTime[i] = 0.0f;  // Moved on - start a new still spell here
+            bodies.sleepAnchorX[i] = bodies.positionX[i];
+            bodies.sleepAnchorY[i] = bodies.positionY[i];
+            bodies.sleepAnchorRotation[i] = bodies.rotation[i];
+        }
+    }
+
+    // Contacts between two awake dynamic bodies join their islands
+    // (wakeTouched already woke any sleeper touched by an awake body)
+    for (const Contact& c : contacts) {
+        if (bodies.isStatic[c.bodyA] || bodies.isStatic[c.bodyB]) continue;
+        if (bodies.isResting[c.bodyA] || bodies.isResting[c.bodyB]) continue;
+        uint32_t rootA = find(c.bodyA);
+        uint32_t rootB = find(c.bodyB);
+        if (rootA != rootB) parent[rootA] = rootB;
+    }
+
+    // An island is as restless as its most restless body
+    for (uint32_t i = 0; i < n; ++i) {
+        if (bodies.isStatic[i] || bodies.isResting[i]) continue;
+        uint32_t root = find(i);
+        islandTime[root] = std::min(islandTime[root], bodies.sleepTime[i]);
+    }
+
+    for (uint32_t i = 0; i < n; ++i) {
+        if (bodies.isStatic[i] || bodies.isResting[i]) continue;
+        uint32_t root = find(i);
+        if (islandTime[root] >= TIME_TO_SLEEP) {
+            putToSleep(bodies, i, root);
+        }
+    }
+}
+
+/**
+ * Find with PATH HALVING: every visited node skips to its grandparent,
+ * so repeated finds flatten the tree without a second pass
+ */
+uint32_t IslandManager::find(uint32_t i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+/**
+ * Freeze body i and link it into its island's ring
+ *   empty ring:  i → i
+ *   otherwise:   insert i right after the ring's entry body
+ */
+void IslandManager::putToSleep(BodyStore& bodies, uint32_t i, uint32_t root) {
+    uint32_t entry = islandRing[root];
+    if (entry == NO_BODY) {
+        islandRing[root] = i;
+        nextSleeper[i] = i;
+        ++sleepingIslands;
+    } else {
+        nextSleeper[i] = nextSleeper[entry];
+        nextSleeper[entry] = i;
+    }
+
+    bodies.velocityX[i] = 0.0f;
+    bodies.velocityY[i] = 0.0f;
+    bodies.angularVelocity[i] = 0.0f;
+    bodies.isResting[i] = 1;
+
+    // Drawn where it stopped, not blended from the last step's position
+    bodies.previousPositionX[i] = bodies.positionX[i];
+    bodies.previousPositionY[i] = bodies.positionY[i];
+    bodies.previousRotation[i] = bodies.rotation[i];
+}
+
+void IslandManager::wakeIsland(BodyStore& bodies, uint32_t i) {
+    if (i >= nextSleeper.size() || nextSleeper[i] == NO_BODY) return;
+
+    uint32_t body = i;
+    do {
+        uint32_t next = nextSleeper[body];
+        nextSleeper[body] = NO_BODY;
+        bodies.isResting[body] = 0;
+        bodies.sleepTime[body] = 0.0f;  // Stays awake at least TIME_TO_SLEEP
+        body = next;
+    } while (body != i);
+
+    --sleepingIslands;
+}
+
+void IslandManager::wakeAll(BodyStore& bodies) {
+    std::fill(bodies.isResting.begin(), bodies.isResting.end(), uint8_t(0));
+    std::fill(bodies.sleepTime.begin(), bodies.sleepTime.end(), 0.0f);
+    nextSleeper.assign(bodies.size(), NO_BODY);
+    sleepingIslands = 0;
+}
+
+/**
+ * The last body takes index i, so whoever pointed at it in its ring must
+ * point at i instead:
+ *
+ *   ring:  a → last → c → a      becomes      a → i → c → a
+ */
+void IslandManager::removeBody(BodyStore& bodies, uint32_t i) {
+    const uint32_t last = static_cast<uint32_t>(bodies.size()) - 1;
+    nextSleeper.resize(bodies.size(), NO_BODY);
+    wakeIsland(bodies, i);
+
+    if (i != last && nextSleeper[last] != NO_BODY) {
+        uint32_t before = last;
+        while (nextSleeper[before] != last) {
+            before = nextSleeper[before];
+        }
+        nextSleeper[before] = i;
+        nextSleeper[i] = (nextSleeper[last] == last) ? i : nextSleeper[last];
+    }
+    nextSleeper.pop_back();
+}
+
+void IslandManager::writeSnapshot(SnapshotWriter& out, const BodyStore& bodies) const {
+    // Bodies added since the last step are awake and not in nextSleeper yet
+    for (uint32_t i = 0; i < bodies.size(); ++i) {
+        out.write(i < nextSleeper.size() ? nextSleeper[i] : NO_BODY);
+    }
+}
+
+bool IslandManager::readSnapshot(SnapshotReader& in, const BodyStore& bodies) {
+    const uint32_t n = static_cast<uint32_t>(bodies.size());
+    std::vector<uint32_t> rings;
+    if (!in.readArray(rings, n)) return false;
+
+    // Every ring must be a closed loop of sleeping bodies - anything else
+    // would send wakeIsland() round forever
+    std::vector<uint8_t> visited(n, 0);
+    size_t islandCount = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        if ((rings[i] != NO_BODY) != (bodies.isResting[i] != 0)) return false;
+        if (rings[i] == NO_BODY || visited[i]) continue;
+
+        uint32_t body = i;
+        do {
+            if (body >= n || visited[body] || rings[body] == NO_BODY) return false;
+            visited[body] = 1;
+            body = rings[body];
+        } while (body != i);
+        ++islandCount;
+    }
+
+    nextSleeper = std::move(rings);
+    sleepingIslands = islandCount;
+    return true;
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "BodyStore.hpp"
+#include "ContactSolver.hpp"
+#include "Snapshot.hpp"
+
+/**
+ * ISLAND SLEEPING - WHOLE PILES SLEEP AND WAKE TOGETHER
+ * =====================================================
+ *
+ * PROBLEM with deciding sleep body by body:
+ * - A body in a pile is held up by its neighbours. Put one to sleep and the
+ *   ones resting on it push on something that no longer moves or pushes back
+ * - Under gravity a supported body is never "unaccelerated", so a per-body
+ *   test that includes gravity never lets a pile sleep at all
+ * - Waking one body by contact and leaving its neighbours asleep makes it
+ *   fall into bodies that won't get out of the way
+ *
+ * SOLUTION: Sleep by ISLAND - a group of dynamic bodies linked by contacts:
+ *
+ *       (a)(b)        (e)          islands: {a, b, c, d}  {e}
+ *      (c)(d)                      static bodies and walls link nothing -
+ *   ════════════════════════       otherwise the floor joins every pile
+ *
+ * FINDING ISLANDS (UNION-FIND):
+ * Every body starts as its own set. Each contact between two awake dynamic
+ * bodies merges their sets: find() walks up to the set's root, union hangs
+ * one root under the other. With path halving each step is nearly O(1), so
+ * the whole pass is linear in bodies + contacts.
+ *
+ * WHEN AN ISLAND SLEEPS:
+ * - Each body counts how long it has been still. A step counts as still if
+ *   the body is SLOW (centre and rim moved less than REST_VELOCITY_THRESHOLD
+ *   × dt) or SHAKING IN PLACE (still within SLEEP_DRIFT of the anchor, where
+ *   the still spell began):
+ *
+ *        ·-----·
+ *       /   ●   \     anchor ● - jitter inside the circle is still;
+ *       \       /     leaving it at speed resets the timer and the anchor
+ *        ·-----·
+ *
+ *   Measured on position, not velocity: the floor pushes a settled body up
+ *   and its neighbours push it back down every step, at speeds no velocity
+ *   test would call "asleep", while it goes nowhere
+ * - An island's time is its most restless body's time (the minimum)
+ * - At TIME_TO_SLEEP the whole island goes to sleep: velocities zeroed,
+ *   isResting set, members linked into a ring
+ *
+ * WHILE ASLEEP the bodies skip integration (and gravity), the grid update,
+ * and pair generation against other sleeping or static bodies.
+ *
+ * WAKING walks the ring, so the whole island wakes at once:
+ *
+ *   nextSleeper:  a → b → d → c → a      wake(b) wakes a, b, c and d
+ *
+ * Causes: an awake body touching a sleeping one, anything clearing isResting
+ * from outside (BodyStore::setVelocity, PhysicsEngine::wakeBody), or a
+ * region wake. Rings hold body indices, so anything that reorders the
+ * BodyStore must call wakeAll() (the engine does in clearDynamicBodies) or,
+ * for a swap-and-pop removal, removeBody().
+ */
+class IslandManager {
+public:
+    static constexpr float TIME_TO_SLEEP = 0.5f;  // Seconds an island must stay still
+    // Farthest a shaking body may stray from its anchor (pixels): rest speed for the whole spell
+    static constexpr float SLEEP_DRIFT = RigidBody::REST_VELOCITY_THRESHOLD * TIME_TO_SLEEP;
+
+    /**
+     * Wake the islands of bodies whose isResting was cleared from outside
+     * Call at the start of a step, before integration
+     */
+    void wakeFlagged(BodyStore& bodies);
+
+    /**
+     * Wake sleeping islands touched by an awake body this step
+     * Call right after contact generation, so they take part in this solve
+     */
+    void wakeTouched(BodyStore& bodies, const std::vector<Contact>& contacts);
+
+    /**
+     * Build this step's islands from the solved contacts and put the ones
+     * that stayed still for TIME_TO_SLEEP to sleep
+     */
+    void update(BodyStore& bodies, const std::vector<Contact>& contacts, float deltaTime);
+
+    // Wake the island body i sleeps in (no-op for awake or static bodies)
+    void wakeIsland(BodyStore& bodies, uint32_t i);
+
+    // Wake everything and forget all rings (after gravity changes or body removal)
+    void wakeAll(BodyStore& bodies);
+
+    /**
+     * Call just BEFORE bodies.removeSwap(i): wakes the island of body i
+     * (whatever it held up may fall) and re-points the ring of the last
+     * body, which is about to move into index i. Cost: one island, not the world.
+     */
+    void removeBody(BodyStore& bodies, uint32_t i);
+
+    size_t getSleepingIslandCount() const { return sleepingIslands; }
+
+    /**
+     * Snapshot of the sleep rings, so a loaded pile is still asleep and
+     * still wakes island by island. readSnapshot() needs the loaded bodies
+     * (ring length and sleep flags are checked against them).
+     */
+    void writeSnapshot(SnapshotWriter& out, const BodyStore& bodies) const;
+    bool readSnapshot(SnapshotReader& in, const BodyStore& bodies);
+
+private:
+    static constexpr uint32_t NO_BODY = 0xFFFFFFFFu;
+
+    uint32_t find(uint32_t i);
+    void putToSleep(BodyStore& bodies, uint32_t i, uint32_t root);
+
+    std::vector<uint32_t> nextSleeper;  // Ring of a sleeping island; NO_BODY while awake
+    size_t sleepingIslands = 0;
+
+    // Per-step scratch (kept between steps - no allocation once warmed up)
+    std::vector<uint32_t> parent;       // Union-find forest; parent[root] == root
+    std::vector<float> islandTime;      // Root → shortest sleepTime in its island
+    std::vector<uint32_t> islandRing;   // Root → first member put to sleep (ring entry)
+};
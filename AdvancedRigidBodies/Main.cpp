@@ -1,36 +1,77 @@
 #include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
 #include <random>
 #include <iostream>
 #include "PhysicsEngine.hpp"
+#include "PhysicsRenderer.hpp"
+#include "SimulationThread.hpp"
 #include "UIControls.hpp"
 
-int main() {
+/**
+ * --seed N: start from a known scene and run in deterministic mode, so the
+ * same seed (and the same mouse input on the same steps) replays the same run.
+ * Without it the scene is random; the seed is printed so a run can be repeated.
+ *
+ * --threaded: step the physics on its own thread, overlapping the drawing of
+ * the previous frame (see SimulationThread). Input then reaches the engine
+ * one frame later, so a seeded run only replays if the frame times match.
+ * The profiler panel shows the render thread; F5/F6 also write the
+ * simulation thread's profile to profile_sim.csv / profile_sim_trace.json.
+ */
+int main(int argc, char** argv) {
+    bool seeded = false;
+    bool threaded = false;
+    uint32_t seed = std::random_device{}();
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = static_cast<uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+            seeded = true;
+        } else if (std::strcmp(argv[i], "--threaded") == 0) {
+            threaded = true;
+        }
+    }
+    std::cout << "Seed: " << seed << std::endl;
+
+
     sf::VideoMode videoMode(sf::Vector2u(1200, 800));
     sf::RenderWindow window(videoMode, "Advanced Rigid Body Physics");
     window.setFramerateLimit(60);
 
     PhysicsEngine physics(1200.0f, 800.0f);
+    physics.setFixedTimestep(120.0f);  // Physics at 120Hz, whatever the display rate
+    physics.setDeterministic(seeded, seed);
+    PhysicsRenderer renderer;
 
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    Profiler profiler;
+    Profiler simProfiler;  // --threaded: the engine's own, a Profiler is single-threaded
+    physics.setProfiler(threaded ? &simProfiler : &profiler);
+
+    TrajectoryRecorder recorder;  // R starts/stops recording to trajectory.rbtr
+    physics.setRecorder(&recorder);
+    renderer.setProfiler(&profiler);
+
+    std::mt19937 gen(seed);
     std::uniform_real_distribution<float> posX(350.0f, 1100.0f);
     std::uniform_real_distribution<float> posY(100.0f, 300.0f);
     std::uniform_real_distribution<float> radiusDist(8.0f, 20.0f);
     std::uniform_real_distribution<float> massDist(1.0f, 5.0f);
     std::uniform_int_distribution<int> colourDist(120, 255);
 
-    physics.addBody(std::make_unique<RigidBody>(
+    physics.addBody(RigidBody(
         sf::Vector2f(500.0f, 500.0f), 35.0f, 10.0f, sf::Color(80, 80, 90), true));
-    physics.addBody(std::make_unique<RigidBody>(
+    physics.addBody(RigidBody(
         sf::Vector2f(700.0f, 400.0f), 30.0f, 10.0f, sf::Color(80, 80, 90), true));
-    physics.addBody(std::make_unique<RigidBody>(
+    physics.addBody(RigidBody(
         sf::Vector2f(900.0f, 500.0f), 35.0f, 10.0f, sf::Color(80, 80, 90), true));
 
     for (int i = 0; i < 15; ++i) {
         float radius = radiusDist(gen);
         float mass = massDist(gen) * (radius / 20.0f);
         sf::Color colour(colourDist(gen), colourDist(gen), colourDist(gen));
-        physics.addBody(std::make_unique<RigidBody>(
+        physics.addBody(RigidBody(
             sf::Vector2f(posX(gen), posY(gen)), radius, mass, colour));
     }
 
@@ -40,22 +81,44 @@ int main() {
         return 1;
     }
 
+    BodyHandle draggedBody;   // Only touched inside commands (engine side)
+    sf::Vector2f dragOffset;
+
+    // From here on the engine belongs to the simulation thread when there is one
+    // (declared after everything its commands use, so it is joined first)
+    std::optional<SimulationThread> simulation;
+    if (threaded) {
+        simulation.emplace(physics, &simProfiler);
+    }
+
+    // Everything that changes the engine goes through send(): run straight
+    // away single-threaded, queued for the next simulation frame otherwise
+    auto send = [&](SimulationThread::Command command) {
+        if (simulation) {
+            simulation->post(std::move(command));
+        } else {
+            command(physics);
+        }
+    };
+
     UIControls ui(font);
 
     ui.onGravityChange = [&](float value) {
-        physics.setGravity(sf::Vector2f(0.0f, value));
+        send([value](PhysicsEngine& engine) { engine.setGravity(sf::Vector2f(0.0f, value)); });
     };
 
     sf::Clock clock;
     sf::Clock fpsTimer;
     int frameCount = 0;
     float fps = 60.0f;
-    RigidBody* draggedBody = nullptr;
-    sf::Vector2f dragOffset;
     bool gravityOn = true;
 
+    // Camera over the world; the UI keeps the window's default view
+    sf::View worldView = window.getDefaultView();
+
     while (window.isOpen()) {
         float deltaTime = clock.restart().asSeconds();
+        profiler.beginFrame();
 
         frameCount++;
         if (fpsTimer.getElapsedTime().asSeconds() >= 1.0f) {
@@ -69,85 +132,201 @@ int main() {
                 window.close();
             }
 
-            sf::Vector2f mousePos(0.0f, 0.0f);
+            sf::Vector2i mousePixel(0, 0);
             if (const auto* mousePressed = event->getIf<sf::Event::MouseButtonPressed>()) {
-                mousePos = sf::Vector2f(static_cast<float>(mousePressed->position.x),
-                                       static_cast<float>(mousePressed->position.y));
+                mousePixel = mousePressed->position;
             }
             if (const auto* mouseMoved = event->getIf<sf::Event::MouseMoved>()) {
-                mousePos = sf::Vector2f(static_cast<float>(mouseMoved->position.x),
-                                       static_cast<float>(mouseMoved->position.y));
+                mousePixel = mouseMoved->position;
             }
+            sf::Vector2f mousePos(static_cast<float>(mousePixel.x), static_cast<float>(mousePixel.y));  // Screen (UI)
+            sf::Vector2f worldPos = window.mapPixelToCoords(mousePixel, worldView);                      // World (bodies)
 
             ui.handleEvent(event, mousePos);
 
+            // Zoom about the cursor: the world point under it stays put
+            if (const auto* wheel = event->getIf<sf::Event::MouseWheelScrolled>()) {
+                sf::Vector2f before = window.mapPixelToCoords(wheel->position, worldView);
+                worldView.zoom(wheel->delta > 0 ? 0.9f : 1.0f / 0.9f);
+                worldView.move(before - window.mapPixelToCoords(wheel->position, worldView));
+            }
+
             if (const auto* mousePressed = event->getIf<sf::Event::MouseButtonPressed>()) {
                 if (!ui.isMouseOverUI(mousePos)) {
                     if (mousePressed->button == sf::Mouse::Button::Right) {
-                        draggedBody = physics.getBodyAt(mousePos);
-                        if (draggedBody) {
-                            dragOffset = draggedBody->getPosition() - mousePos;
-                            draggedBody->wake();
-                        }
+                        send([&, worldPos](PhysicsEngine& engine) {
+                            draggedBody = engine.getBodyAt(worldPos);
+                            if (engine.isValid(draggedBody)) {
+                                dragOffset = engine.getBodyPosition(draggedBody) - worldPos;
+                                engine.wakeBody(draggedBody);
+                            }
+                        });
                     }
                     if (mousePressed->button == sf::Mouse::Button::Left) {
                         float radius = radiusDist(gen);
                         float mass = massDist(gen) * (radius / 20.0f);
                         sf::Color colour(colourDist(gen), colourDist(gen), colourDist(gen));
-                        auto body = std::make_unique<RigidBody>(mousePos, radius, mass, colour);
-                        body->setRestitution(ui.getRestitution());
-                        body->setFriction(ui.getFriction());
-                        physics.addBody(std::move(body));
+                        RigidBody body(worldPos, radius, mass, colour);
+                        body.setRestitution(ui.getRestitution());
+                        body.setFriction(ui.getFriction());
+                        send([body](PhysicsEngine& engine) { engine.addBody(body); });
                     }
                 }
             }
 
             if (event->is<sf::Event::MouseButtonReleased>()) {
-                draggedBody = nullptr;
+                send([&](PhysicsEngine&) { draggedBody = BodyHandle{}; });
             }
 
-            if (const auto* mouseMoved = event->getIf<sf::Event::MouseMoved>()) {
-                if (draggedBody && !draggedBody->getIsStatic()) {
-                    sf::Vector2f targetPos = mousePos + dragOffset;
-                    draggedBody->setVelocity((targetPos - draggedBody->getPosition()) * 10.0f);
-                }
+            if (event->is<sf::Event::MouseMoved>()) {
+                send([&, worldPos](PhysicsEngine& engine) {
+                    if (engine.isValid(draggedBody) && !engine.isBodyStatic(draggedBody)) {
+                        sf::Vector2f targetPos = worldPos + dragOffset;
+                        engine.setBodyVelocity(draggedBody, (targetPos - engine.getBodyPosition(draggedBody)) * 10.0f);
+                    }
+                });
             }
 
             if (const auto* keyPressed = event->getIf<sf::Event::KeyPressed>()) {
                 if (keyPressed->scancode == sf::Keyboard::Scancode::Space) {
+                    std::vector<RigidBody> spawnBatch;  // Added as one batch
+                    spawnBatch.reserve(8);
                     for (int i = 0; i < 8; ++i) {
                         float radius = radiusDist(gen);
                         float mass = massDist(gen) * (radius / 20.0f);
                         sf::Color colour(colourDist(gen), colourDist(gen), colourDist(gen));
-                        auto body = std::make_unique<RigidBody>(
-                            sf::Vector2f(posX(gen), posY(gen)), radius, mass, colour);
-                        body->setRestitution(ui.getRestitution());
-                        body->setFriction(ui.getFriction());
-                        physics.addBody(std::move(body));
+                        RigidBody body(sf::Vector2f(posX(gen), posY(gen)), radius, mass, colour);
+                        body.setRestitution(ui.getRestitution());
+                        body.setFriction(ui.getFriction());
+                        spawnBatch.push_back(body);
                     }
+                    send([batch = std::move(spawnBatch)](PhysicsEngine& engine) { engine.addBodies(batch); });
                 } else if (keyPressed->scancode == sf::Keyboard::Scancode::C) {
-                    physics.clearDynamicBodies();
+                    send([](PhysicsEngine& engine) { engine.clearDynamicBodies(); });
                 } else if (keyPressed->scancode == sf::Keyboard::Scancode::G) {
                     gravityOn = !gravityOn;
-                    physics.setGravity(gravityOn ? sf::Vector2f(0.0f, ui.getGravity()) :
-                                                   sf::Vector2f(0.0f, 0.0f));
+                    sf::Vector2f gravity = gravityOn ? sf::Vector2f(0.0f, ui.getGravity()) : sf::Vector2f(0.0f, 0.0f);
+                    send([gravity](PhysicsEngine& engine) { engine.setGravity(gravity); });
                 } else if (keyPressed->scancode == sf::Keyboard::Scancode::V) {
                     ui.showVelocityVectors = !ui.showVelocityVectors;
                 } else if (keyPressed->scancode == sf::Keyboard::Scancode::T) {
                     ui.showMotionTrails = !ui.showMotionTrails;
+                } else if (keyPressed->scancode == sf::Keyboard::Scancode::B) {
+                    bool postProcess = renderer.getGlowMode() == PhysicsRenderer::GlowMode::PostProcess;
+                    renderer.setGlowMode(postProcess ? PhysicsRenderer::GlowMode::Geometry
+                                                     : PhysicsRenderer::GlowMode::PostProcess);
                 } else if (keyPressed->scancode == sf::Keyboard::Scancode::D) {
                     ui.showDebugVisualization = !ui.showDebugVisualization;
+                    bool capture = ui.showDebugVisualization;
+                    send([capture](PhysicsEngine& engine) { engine.setDebugCapture(capture); });
+                } else if (keyPressed->scancode == sf::Keyboard::Scancode::Num1 ||
+                           keyPressed->scancode == sf::Keyboard::Scancode::Num2 ||
+                           keyPressed->scancode == sf::Keyboard::Scancode::Num3) {
+                    // Debug layers: 1 = contact points, 2 = normals, 3 = forces
+                    DebugCategories categories = renderer.getDebugCategories();
+                    if (keyPressed->scancode == sf::Keyboard::Scancode::Num1) categories.contactPoints = !categories.contactPoints;
+                    if (keyPressed->scancode == sf::Keyboard::Scancode::Num2) categories.contactNormals = !categories.contactNormals;
+                    if (keyPressed->scancode == sf::Keyboard::Scancode::Num3) categories.forces = !categories.forces;
+                    renderer.setDebugCategories(categories);
+                } else if (keyPressed->scancode == sf::Keyboard::Scancode::Left ||
+                           keyPressed->scancode == sf::Keyboard::Scancode::Right ||
+                           keyPressed->scancode == sf::Keyboard::Scancode::Up ||
+                           keyPressed->scancode == sf::Keyboard::Scancode::Down) {
+                    // Pan by a tenth of what is on screen, whatever the zoom
+                    sf::Vector2f step = worldView.getSize() * 0.1f;
+                    if (keyPressed->scancode == sf::Keyboard::Scancode::Left)  worldView.move(sf::Vector2f(-step.x, 0.f));
+                    if (keyPressed->scancode == sf::Keyboard::Scancode::Right) worldView.move(sf::Vector2f(step.x, 0.f));
+                    if (keyPressed->scancode == sf::Keyboard::Scancode::Up)    worldView.move(sf::Vector2f(0.f, -step.y));
+                    if (keyPressed->scancode == sf::Keyboard::Scancode::Down)  worldView.move(sf::Vector2f(0.f, step.y));
+                } else if (keyPressed->scancode == sf::Keyboard::Scancode::Home) {
+                    worldView = window.getDefaultView();
+                } else if (keyPressed->scancode == sf::Keyboard::Scancode::P) {
+                    ui.showProfiler = !ui.showProfiler;
+                } else if (keyPressed->scancode == sf::Keyboard::Scancode::R) {
+                    // The recorder is fed by the engine, so it is driven from the engine side too
+                    send([&](PhysicsEngine&) {
+                        if (recorder.isRecording()) {
+                            bool written = recorder.stop();
+                            std::cout << "Recorded " << recorder.getFrameCount() << " steps to trajectory.rbtr ("
+                                      << recorder.getEncodedBytes() / 1024 << " KB, raw " << recorder.getRawBytes() / 1024 << " KB)"
+                                      << (written ? "" : " - write failed") << std::endl;
+                        } else if (recorder.start("trajectory.rbtr")) {
+                            std::cout << "Recording to trajectory.rbtr (R to stop)" << std::endl;
+                        }
+                    });
+                } else if (keyPressed->scancode == sf::Keyboard::Scancode::S) {
+                    send([](PhysicsEngine& engine) {
+                        bool grid = engine.getBroadPhase() == BroadPhaseType::Grid;
+                        engine.setBroadPhase(grid ? BroadPhaseType::SweepAndPrune : BroadPhaseType::Grid);
+                        std::cout << "Broad phase: " << getBroadPhaseName(engine.getBroadPhase()) << std::endl;
+                    });
+                } else if (keyPressed->scancode == sf::Keyboard::Scancode::F5) {
+                    if (profiler.exportCSV("profile.csv")) {
+                        std::cout << "Profile written to profile.csv" << std::endl;
+                    }
+                    if (simulation) {
+                        send([&](PhysicsEngine&) {
+                            if (simProfiler.exportCSV("profile_sim.csv")) {
+                                std::cout << "Simulation profile written to profile_sim.csv" << std::endl;
+                            }
+                        });
+                    }
+                } else if (keyPressed->scancode == sf::Keyboard::Scancode::F6) {
+                    if (profiler.exportChromeTrace("profile_trace.json")) {
+                        std::cout << "Trace written to profile_trace.json (open in chrome://tracing)" << std::endl;
+                    }
+                    if (simulation) {
+                        send([&](PhysicsEngine&) {
+                            if (simProfiler.exportChromeTrace("profile_sim_trace.json")) {
+                                std::cout << "Simulation trace written to profile_sim_trace.json" << std::endl;
+                            }
+                        });
+                    }
+                } else if (keyPressed->scancode == sf::Keyboard::Scancode::F8) {
+                    send([](PhysicsEngine& engine) {
+                        if (engine.saveSnapshot("scene.snap")) {
+                            std::cout << "Scene saved to scene.snap" << std::endl;
+                        }
+                    });
+                } else if (keyPressed->scancode == sf::Keyboard::Scancode::F9) {
+                    send([&](PhysicsEngine& engine) {
+                        if (engine.loadSnapshot("scene.snap")) {
+                            draggedBody = BodyHandle{};
+                            std::cout << "Scene loaded from scene.snap" << std::endl;
+                        } else {
+                            std::cout << "No valid scene.snap to load" << std::endl;
+                        }
+                    });
                 }
             }
         }
 
-        physics.update(deltaTime);
+        window.setView(worldView);
+        const RenderState* state = nullptr;
+        if (simulation) {
+            // Start stepping the next frame, then draw the newest finished one meanwhile.
+            // That capture is shown a frame late, so pad it by a pan/zoom step.
+            RenderRequest request = renderer.makeRequest(window, ui.showMotionTrails, ui.showDebugVisualization);
+            sf::Vector2f viewSize = request.view.max - request.view.min;
+            request.view = request.view.inflated(0.25f * std::max(viewSize.x, viewSize.y));
+            simulation->advance(deltaTime, request);
+            state = &simulation->acquire();
+        } else {
+            physics.update(deltaTime);
+        }
         ui.update(deltaTime);
-        ui.updateStats(static_cast<int>(physics.getDynamicBodyCount()), fps);
+        ui.updateStats(static_cast<int>(state ? state->dynamicBodyCount : physics.getDynamicBodyCount()), fps);
+        ui.updateProfiler(profiler);
 
         window.clear(sf::Color(10, 10, 15));
-        physics.draw(window, ui.showVelocityVectors, ui.showMotionTrails, ui.showDebugVisualization);
+        if (state) {
+            renderer.draw(window, *state, ui.showVelocityVectors, ui.showMotionTrails, ui.showDebugVisualization);
+        } else {
+            renderer.draw(window, physics, ui.showVelocityVectors, ui.showMotionTrails, ui.showDebugVisualization);
+        }
+        window.setView(window.getDefaultView());
         ui.draw(window);
+        profiler.endFrame();
         window.display();
     }
 
@@ -1,106 +1,234 @@
 #include "ParticleSystem.hpp"
 #include "Vector2Utils.hpp"
+#include "UnitCircle.hpp"
+#include <algorithm>
+#include <functional>
+#include <numeric>
 
 using namespace PhysicsUtils;
 
-void ParticleSystem::createImpactBurst(sf::Vector2f position, sf::Vector2f normal, sf::Color colour, float intensity) {
-    // Limit particle creation if we're near the max
-    if (particles.size() >= MAX_PARTICLES) {
-        return; // Skip creating new particles if at limit
+namespace {
+    constexpr size_t EVICTION_BATCH_DIVISOR = 8;  // Evict at least budget / 8 at a time
+
+    // Level of detail: below this radius on screen a spark is a bare 4-slice dot
+    constexpr float POINT_DETAIL_PIXELS = 1.0f;
+    constexpr int POINT_SEGMENTS = 4;
+}
+
+ParticleSystem::ParticleSystem(size_t budget) {
+    setBudget(budget);
+}
+
+void ParticleSystem::setBudget(size_t newBudget) {
+    budget = newBudget;
+    count = std::min(count, budget);
+
+    positionX.resize(budget);
+    positionY.resize(budget);
+    velocityX.resize(budget);
+    velocityY.resize(budget);
+    lifetime.resize(budget);
+    maxLifetime.resize(budget);
+    size.resize(budget);
+    colour.resize(budget);
+    evictionScratch.reserve(budget);
+}
+
+void ParticleSystem::copyAliveFrom(const ParticleSystem& source) {
+    if (budget < source.count) {
+        setBudget(source.budget);
     }
+    count = source.count;
+
+    std::copy_n(source.positionX.begin(), count, positionX.begin());
+    std::copy_n(source.positionY.begin(), count, positionY.begin());
+    std::copy_n(source.lifetime.begin(), count, lifetime.begin());
+    std::copy_n(source.maxLifetime.begin(), count, maxLifetime.begin());
+    std::copy_n(source.size.begin(), count, size.begin());
+    std::copy_n(source.colour.begin(), count, colour.begin());
+}
+
+void ParticleSystem::spawn(size_t slot, sf::Vector2f position, sf::Vector2f velocity, sf::Color col, float life, float sz) {
+    positionX[slot] = position.x;
+    positionY[slot] = position.y;
+    velocityX[slot] = velocity.x;
+    velocityY[slot] = velocity.y;
+    lifetime[slot] = life;
+    maxLifetime[slot] = life;
+    size[slot] = sz;
+    colour[slot] = col;
+}
+
+/**
+ * SWAP-REMOVE: the last alive particle takes over this slot
+ *
+ *   before: [A B C D E]  kill(1)  →  after: [A E C D]
+ */
+void ParticleSystem::kill(size_t slot) {
+    size_t last = --count;
+    if (slot != last) {
+        positionX[slot] = positionX[last];
+        positionY[slot] = positionY[last];
+        velocityX[slot] = velocityX[last];
+        velocityY[slot] = velocityY[last];
+        lifetime[slot] = lifetime[last];
+        maxLifetime[slot] = maxLifetime[last];
+        size[slot] = size[last];
+        colour[slot] = colour[last];
+    }
+}
+
+/**
+ * Free up space for a burst of `wanted` particles
+ * @return How many particles the burst may actually spawn
+ *
+ * EVICT OLDEST:
+ * Age = maxLifetime - lifetime. nth_element finds the oldest slots in O(n)
+ * (no full sort), then they are killed from the highest slot down so a
+ * swap-remove never moves a particle that is still waiting to be killed.
+ *
+ * AMORTISED:
+ * A collapsing pile fires hundreds of bursts per step. Selecting just
+ * enough room for each one would cost O(n) per burst, so each selection
+ * frees at least 1/8 of the budget - the next bursts then fit for free.
+ */
+size_t ParticleSystem::makeRoom(size_t wanted) {
+    wanted = std::min(wanted, budget);
+    if (count + wanted <= budget) {
+        return wanted;
+    }
+    if (evictionPolicy == ParticleEvictionPolicy::DropNew) {
+        return budget - count;
+    }
+
+    size_t need = std::min(count, std::max(count + wanted - budget, budget / EVICTION_BATCH_DIVISOR));
+    evictionScratch.resize(count);
+    std::iota(evictionScratch.begin(), evictionScratch.end(), 0u);
+    auto age = [this](uint32_t slot) { return maxLifetime[slot] - lifetime[slot]; };
+    std::nth_element(evictionScratch.begin(), evictionScratch.begin() + (need - 1), evictionScratch.end(),
+        [&](uint32_t a, uint32_t b) { return age(a) > age(b); });
 
-    std::uniform_real_distribution<float> angleDist(-0.5f, 0.5f);
+    std::sort(evictionScratch.begin(), evictionScratch.begin() + need, std::greater<uint32_t>());
+    for (size_t i = 0; i < need; ++i) {
+        kill(evictionScratch[i]);
+    }
+    return wanted;
+}
+
+void ParticleSystem::createImpactBurst(sf::Vector2f position, sf::Vector2f normal, sf::Color col, float intensity) {
+    // tan(0.5): the sideways lean that matches the old ±0.5 radian spread
+    constexpr float SPREAD = 0.5463f;
+
+    std::uniform_real_distribution<float> leanDist(-SPREAD, SPREAD);
     std::uniform_real_distribution<float> speedDist(50.0f, 150.0f);
     std::uniform_real_distribution<float> sizeDist(1.0f, 3.0f);
 
     int particleCount = static_cast<int>(intensity * 20.0f);
     particleCount = std::clamp(particleCount, 5, 30);
 
-    // Further reduce if we're getting close to limit
-    size_t remainingCapacity = MAX_PARTICLES - particles.size();
-    if (remainingCapacity < static_cast<size_t>(particleCount)) {
-        particleCount = static_cast<int>(remainingCapacity);
-    }
+    size_t spawnCount = makeRoom(static_cast<size_t>(particleCount));
+    sf::Vector2f tangent(-normal.y, normal.x);
+    float life = 0.3f + intensity * 0.2f;
 
-    for (int i = 0; i < particleCount; ++i) {
-        float angle = std::atan2(normal.y, normal.x) + angleDist(gen);
+    for (size_t i = 0; i < spawnCount; ++i) {
+        sf::Vector2f direction = normalise(normal + tangent * leanDist(gen));
         float speed = speedDist(gen) * intensity;
-        sf::Vector2f velocity(std::cos(angle) * speed, std::sin(angle) * speed);
-
-        particles.emplace_back(
-            position,
-            velocity,
-            colour,
-            0.3f + intensity * 0.2f,
-            sizeDist(gen)
-        );
+        spawn(count++, position, direction * speed, col, life, sizeDist(gen));
     }
 }
 
+/**
+ * Simple particle physics:
+ * - Move in straight line (no forces except drag)
+ * - Apply drag/air resistance (velocity *= 0.98)
+ * - Count down lifetime
+ *
+ * No complex physics needed - particles are just visual!
+ */
 void ParticleSystem::update(float deltaTime) {
-    for (auto& particle : particles) {
-        particle.update(deltaTime);
+    // Pass 1: no branches, no calls, separate arrays - auto-vectorizes
+    float* px = positionX.data();
+    float* py = positionY.data();
+    float* vx = velocityX.data();
+    float* vy = velocityY.data();
+    float* life = lifetime.data();
+    for (size_t i = 0; i < count; ++i) {
+        px[i] += vx[i] * deltaTime;  // Euler integration (simple!)
+        py[i] += vy[i] * deltaTime;
+        life[i] -= deltaTime;        // Countdown to death
+        vx[i] *= 0.98f;              // Air resistance / drag
+        vy[i] *= 0.98f;
     }
 
-    particles.erase(
-        std::remove_if(particles.begin(), particles.end(),
-            [](const Particle& p) { return p.isDead(); }),
-        particles.end()
-    );
+    // Pass 2: swap-remove the dead (don't advance i - slot i now holds a new particle)
+    for (size_t i = 0; i < count;) {
+        if (lifetime[i] <= 0.0f) {
+            kill(i);
+        } else {
+            ++i;
+        }
+    }
 }
 
-void ParticleSystem::draw(sf::RenderWindow& window) {
-    if (particles.empty()) return;
-
-    // Clear vertex arrays
-    particleVertices.clear();
-    glowVertices.clear();
-    particleVertices.setPrimitiveType(sf::PrimitiveType::Triangles);
-    glowVertices.setPrimitiveType(sf::PrimitiveType::Triangles);
-
-    const int segments = 8; // Reduced segment count for performance
-
-    for (const auto& particle : particles) {
-        sf::Color col = particle.colour;
-        uint8_t alpha = static_cast<uint8_t>(particle.getAlpha());
+void ParticleSystem::draw(sf::RenderTarget& target, const ViewRegion& region, bool streaming) const {
+    constexpr int segments = 8; // Reduced segment count for performance
+    const auto& circle = UNIT_CIRCLE<segments>;
+    const auto& dot = UNIT_CIRCLE<POINT_SEGMENTS>;
+
+    // Storage is only resized when there are more particles than ever before
+    size_t maxVertices = count * segments * 3;
+    sf::Vertex* glowOut = glowBatch.begin(maxVertices);
+    sf::Vertex* particleOut = particleBatch.begin(maxVertices);
+
+    for (size_t p = 0; p < count; ++p) {
+        sf::Vector2f position(positionX[p], positionY[p]);
+        float radius = size[p];
+        float glowSize = radius * 2.0f;
+        if (!region.overlaps(position, glowSize)) continue;
+
+        /**
+         * Fade-out transparency
+         * Alpha goes from 255 (opaque) to 0 (transparent) as lifetime decreases
+         * - Fresh particle: lifetime = maxLifetime → alpha = 255 (solid)
+         * - Half-life: lifetime = maxLifetime/2 → alpha = 127 (translucent)
+         */
+        sf::Color col = colour[p];
+        uint8_t alpha = static_cast<uint8_t>((lifetime[p] / maxLifetime[p]) * 255.0f);
         col.a = alpha;
 
+        // Too small to see the glow or the roundness - one tiny fan only
+        if (region.toPixels(radius) < POINT_DETAIL_PIXELS) {
+            for (int i = 0; i < POINT_SEGMENTS; ++i) {
+                *particleOut++ = sf::Vertex(position, col);
+                *particleOut++ = sf::Vertex(position + dot[i] * radius, col);
+                *particleOut++ = sf::Vertex(position + dot[i + 1] * radius, col);
+            }
+            continue;
+        }
+
         // Draw glow (larger circle with lower alpha)
         sf::Color glowCol = col;
         glowCol.a = static_cast<uint8_t>(alpha * 0.3f);
-        float glowSize = particle.size * 2.0f;
 
         for (int i = 0; i < segments; ++i) {
-            float angle1 = (i * 2.0f * 3.14159f) / segments;
-            float angle2 = ((i + 1) * 2.0f * 3.14159f) / segments;
-
-            sf::Vector2f p1 = particle.position + sf::Vector2f(std::cos(angle1) * glowSize,
-                                                                std::sin(angle1) * glowSize);
-            sf::Vector2f p2 = particle.position + sf::Vector2f(std::cos(angle2) * glowSize,
-                                                                std::sin(angle2) * glowSize);
-
-            glowVertices.append(sf::Vertex(particle.position, glowCol));
-            glowVertices.append(sf::Vertex(p1, glowCol));
-            glowVertices.append(sf::Vertex(p2, glowCol));
+            *glowOut++ = sf::Vertex(position, glowCol);
+            *glowOut++ = sf::Vertex(position + circle[i] * glowSize, glowCol);
+            *glowOut++ = sf::Vertex(position + circle[i + 1] * glowSize, glowCol);
         }
 
         // Draw main particle (smaller circle)
         for (int i = 0; i < segments; ++i) {
-            float angle1 = (i * 2.0f * 3.14159f) / segments;
-            float angle2 = ((i + 1) * 2.0f * 3.14159f) / segments;
-
-            sf::Vector2f p1 = particle.position + sf::Vector2f(std::cos(angle1) * particle.size,
-                                                                std::sin(angle1) * particle.size);
-            sf::Vector2f p2 = particle.position + sf::Vector2f(std::cos(angle2) * particle.size,
-                                                                std::sin(angle2) * particle.size);
-
-            particleVertices.append(sf::Vertex(particle.position, col));
-            particleVertices.append(sf::Vertex(p1, col));
-            particleVertices.append(sf::Vertex(p2, col));
+            *particleOut++ = sf::Vertex(position, col);
+            *particleOut++ = sf::Vertex(position + circle[i] * radius, col);
+            *particleOut++ = sf::Vertex(position + circle[i + 1] * radius, col);
         }
     }
+    glowBatch.end(glowOut);
+    particleBatch.end(particleOut);
 
     // Draw both in 2 draw calls total
-    window.draw(glowVertices);
-    window.draw(particleVertices);
+    glowBatch.setStreaming(streaming);
+    particleBatch.setStreaming(streaming);
+    glowBatch.draw(target);
+    particleBatch.draw(target);
 }
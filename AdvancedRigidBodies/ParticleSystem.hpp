@@ -19,64 +19,44 @@
  */
 #pragma once
 #include <SFML/Graphics.hpp>
+#include <cstdint>
 #include <vector>
 #include <random>
+#include "VertexBatch.hpp"
+#include "ViewRegion.hpp"
 
 /**
- * Individual particle - lightweight, simple physics
+ * What to do when a new burst arrives and the pool is full
  */
-class Particle {
-public:
-    sf::Vector2f position;   // Current position
-    sf::Vector2f velocity;   // Movement direction and speed
-    sf::Color colour;        // Particle color
-    float lifetime;          // Time remaining (seconds)
-    float maxLifetime;       // Initial lifetime (for fade calculation)
-    float size;              // Particle radius
-
-    Particle(sf::Vector2f pos, sf::Vector2f vel, sf::Color col, float life, float sz)
-        : position(pos), velocity(vel), colour(col), lifetime(life), maxLifetime(life), size(sz) {}
-
-    /**
-     * Simple particle physics:
-     * - Move in straight line (no forces except drag)
-     * - Apply drag/air resistance (velocity *= 0.98)
-     * - Count down lifetime
-     *
-     * No complex physics needed - particles are just visual!
-     */
-    void update(float deltaTime) {
-        position += velocity * deltaTime;  // Euler integration (simple!)
-        lifetime -= deltaTime;              // Countdown to death
-        velocity *= 0.98f;                  // Air resistance / drag
-    }
-
-    /**
-     * Should this particle be removed?
-     * Dead particles are erased from the system
-     */
-    bool isDead() const { return lifetime <= 0.0f; }
-
-    /**
-     * Calculate fade-out transparency
-     * Alpha goes from 255 (opaque) to 0 (transparent) as lifetime decreases
-     *
-     * VISUAL EFFECT:
-     * - Fresh particle: lifetime = maxLifetime → alpha = 255 (solid)
-     * - Half-life: lifetime = maxLifetime/2 → alpha = 127 (translucent)
-     * - Nearly dead: lifetime → 0 → alpha → 0 (invisible)
-     */
-    float getAlpha() const {
-        return (lifetime / maxLifetime) * 255.0f;
-    }
+enum class ParticleEvictionPolicy {
+    DropNew,      // Keep the particles we have, skip the new ones
+    EvictOldest   // Replace the particles that have lived longest (default - fresh impacts stay visible)
 };
 
 /**
  * ParticleSystem - Manages collision impact effects
+ *
+ * POOLED, STRUCTURE-OF-ARRAYS STORAGE:
+ * Particles used to be a std::vector<Particle> of objects. Now every field
+ * has its own array, all sized ONCE to the budget:
+ *
+ *   positionX: [x0 x1 x2 ... x(n-1) | unused ...]
+ *   lifetime:  [l0 l1 l2 ... l(n-1) | unused ...]
+ *               └── alive (count) ──┘└─ spare capacity (budget - count)
+ *
+ * - Spawning writes into slot [count] - no allocation, no constructor
+ * - The update loop is plain float arrays, simple enough for the compiler
+ *   to vectorize (4-16 particles per instruction)
+ * - Killing a particle moves the LAST alive particle into its slot
+ *   (swap-remove, O(1)) instead of shifting everything after it
+ *   (erase-remove, O(n)). Draw order changes, which nobody can see.
  */
 class ParticleSystem {
 public:
-    ParticleSystem() = default;
+    /**
+     * @param budget - Maximum particles alive at once (can be changed later)
+     */
+    explicit ParticleSystem(size_t budget = DEFAULT_BUDGET);
 
     /**
      * Create particle burst at collision point
@@ -86,6 +66,14 @@ public:
      * - Each particle has random angle, speed, and size
      * - Creates realistic spray effect
      *
+     * SPRAY DIRECTION WITHOUT TRIG:
+     * Instead of atan2 → add random angle → cos/sin for every particle,
+     * lean the normal sideways by a random amount and renormalise:
+     *
+     *   dir = normalise(normal + tangent × t),  t in ±tan(0.5)
+     *
+     * Same ±0.5 radian cone, one square root per particle.
+     *
      * @param position  - Where the collision occurred
      * @param normal    - Direction to spray particles (away from surface)
      * @param colour    - Base color for particles
@@ -96,9 +84,8 @@ public:
 
     /**
      * Update all particles
-     * - Move particles
-     * - Decrease lifetimes
-     * - Remove dead particles (erase-remove idiom)
+     * - Move particles, decrease lifetimes (one vectorizable pass)
+     * - Remove dead particles (swap-remove pass)
      */
     void update(float deltaTime);
 
@@ -118,40 +105,84 @@ public:
      *
      * HOW IT WORKS:
      * - Create triangles to form circles (approximation)
-     * - Store all triangles in one VertexArray
+     * - Circle points come from a compile-time table (UnitCircle.hpp)
+     * - Store all triangles in one VertexBatch, overwritten in place
      * - GPU draws them all at once
+     *
+     * CULLING AND LEVEL OF DETAIL:
+     * - Particles outside the visible region are skipped
+     * - Particles under a pixel on screen keep only a 4-slice core (no glow)
+     *
+     * @param region    - What the target's view shows (see ViewRegion)
+     * @param streaming - Upload through persistent sf::VertexBuffers (see VertexBatch)
+     */
+    void draw(sf::RenderTarget& target, const ViewRegion& region, bool streaming = false) const;
+
+    /**
+     * PERFORMANCE LIMIT (runtime)
+     * Raise it on fast machines, lower it on slow ones. Shrinking below the
+     * current count kills the newest-slotted particles straight away.
+     * Reallocates the pool - call at setup, not every frame.
      */
-    void draw(sf::RenderWindow& window);
+    void setBudget(size_t newBudget);
+    size_t getBudget() const { return budget; }
+
+    void setEvictionPolicy(ParticleEvictionPolicy policy) { evictionPolicy = policy; }
+    ParticleEvictionPolicy getEvictionPolicy() const { return evictionPolicy; }
 
-    const std::vector<Particle>& getParticles() const { return particles; }
+    size_t getParticleCount() const { return count; }
+
+    /**
+     * Copy source's alive particles for drawing (see RenderState)
+     * Positions, lifetimes, sizes and colours only - the copy is drawn, not
+     * updated. Grows the budget to the source's if needed.
+     */
+    void copyAliveFrom(const ParticleSystem& source);
+
+    // Restart the random sequence (same seed + same bursts = same particles)
+    void setSeed(uint32_t seed) { gen.seed(seed); }
+
+    // Vertices built by the last draw() call
+    size_t getVertexCount() const { return particleBatch.getVertexCount() + glowBatch.getVertexCount(); }
+
+    /**
+     * Why 500 by default?
+     * - Enough for good visual effect
+     * - Low enough to maintain 60 FPS on modest hardware
+     */
+    static constexpr size_t DEFAULT_BUDGET = 500;
 
 private:
-    std::vector<Particle> particles;
+    void spawn(size_t slot, sf::Vector2f position, sf::Vector2f velocity, sf::Color colour, float lifetime, float size);
+    void kill(size_t slot);
+    size_t makeRoom(size_t wanted);
+
+    // Particle fields, [0, count) alive, [count, budget) spare
+    std::vector<float> positionX, positionY;
+    std::vector<float> velocityX, velocityY;
+    std::vector<float> lifetime;      // Time remaining (seconds)
+    std::vector<float> maxLifetime;   // Initial lifetime (for fade calculation)
+    std::vector<float> size;          // Particle radius
+    std::vector<sf::Color> colour;
+
+    size_t count = 0;
+    size_t budget = 0;
+    ParticleEvictionPolicy evictionPolicy = ParticleEvictionPolicy::EvictOldest;
+    std::vector<uint32_t> evictionScratch;  // Slot indices, reused by makeRoom()
 
     /**
      * Random number generator
      * std::mt19937 = Mersenne Twister (high-quality RNG)
      * Used to randomize particle properties
+     * Seeded from the OS until setSeed() is called (deterministic mode does)
      */
     std::mt19937 gen{std::random_device{}()};
 
     /**
      * BATCHED RENDERING - Store all particle triangles
      * Instead of drawing each particle separately,
-     * build one big vertex array and draw once
-     */
-    sf::VertexArray particleVertices;  // Main particle circles
-    sf::VertexArray glowVertices;      // Glow effect circles
-
-    /**
-     * PERFORMANCE LIMIT
-     * Cap particle count to prevent frame rate drops
-     * During intense collisions, skip creating new particles if at limit
-     *
-     * Why 500?
-     * - Enough for good visual effect
-     * - Low enough to maintain 60 FPS
-     * - Can be tuned based on target hardware
+     * build one big vertex batch and draw once
      */
-    static constexpr size_t MAX_PARTICLES = 500;
+    mutable VertexBatch particleBatch{sf::PrimitiveType::Triangles};  // Main particle circles (drawing scratch)
+    mutable VertexBatch glowBatch{sf::PrimitiveType::Triangles};      // Glow effect circles (drawing scratch)
 };
@@ -1,509 +1,812 @@
 #include "PhysicsEngine.hpp"
 #include "Vector2Utils.hpp"
 #include <algorithm>
+#include <array>
+#include <cmath>
 
 using namespace PhysicsUtils;
 
+namespace {
+    /**
+     * Exact ray vs circle for every raycast candidate, keeping the closest
+     *
+     * With m = origin - centre, points on the ray at distance t lie on the
+     * circle where t² + 2(m·d)t + (m·m - r²) = 0. The smaller root is where
+     * the ray enters; no real root (or a circle behind the origin) is a miss.
+     */
+    class ClosestRayHit final : public RayVisitor {
+    public:
+        ClosestRayHit(const BodyStore& bodies, const sf::Vector2f& origin, const sf::Vector2f& direction, float maxDistance)
+            : bodies(bodies), origin(origin), direction(direction), closest(maxDistance) {}
+
+        float visit(uint32_t i) override {
+            sf::Vector2f m = origin - bodies.getPosition(i);
+            float r = bodies.radius[i];
+            float b = dot(m, direction);
+            float c = dot(m, m) - r * r;
+
+            float t = 0.0f;  // c <= 0: the origin is inside
+            if (c > 0.0f) {
+                float discriminant = b * b - c;
+                if (b > 0.0f || discriminant < 0.0f) return closest;
+                t = -b - std::sqrt(discriminant);
+            }
+            if (t < closest || (t == closest && i < body)) {
+                closest = t;
+                body = i;
+            }
+            return closest;
+        }
+
+        const BodyStore& bodies;
+        sf::Vector2f origin;
+        sf::Vector2f direction;
+        float closest;
+        uint32_t body = UINT32_MAX;  // None yet
+    };
+}
+
 PhysicsEngine::PhysicsEngine(float width, float height)
     : worldWidth(width), worldHeight(height), gravity(0.f, 500.f),
-      spatialGrid(width, height, 100.0f) {
+      spatialGrid(width, height, 100.0f),
+      simdLevel(Integrator::detectSimdLevel()) {
+}
+
+void PhysicsEngine::setThreadCount(unsigned count) {
+    if (count == getThreadCount()) return;
+
+    contactSolver.setThreadPool(nullptr);
+    threadPool.reset();
+    if (count > 1) {
+        threadPool = std::make_unique<ThreadPool>(count);
+        contactSolver.setThreadPool(threadPool.get());
+    }
+    impactQueue.setThreadCount(count);
+}
+
+void PhysicsEngine::setSimdLevel(SimdLevel level) {
+    simdLevel = std::min(level, Integrator::detectSimdLevel());
 }
 
-void PhysicsEngine::addBody(std::unique_ptr<RigidBody> body) {
-    bodies.push_back(std::move(body));
+BodyHandle PhysicsEngine::addBody(const RigidBody& body) {
+    gridNeedsRebuild = true;
+    return bodies.add(body);
 }
 
 void PhysicsEngine::clearDynamicBodies() {
-    bodies.erase(
-        std::remove_if(bodies.begin(), bodies.end(),
-            [](const std::unique_ptr<RigidBody>& body) { return !body->getIsStatic(); }),
-        bodies.end()
-    );
+    bodies.removeIf([this](size_t i) { return !bodies.isStatic[i]; });
+    contactSolver.clearPersistentContacts();
+    islands.wakeAll(bodies);  // Indices moved, and survivors may have lost their support
+    gridNeedsRebuild = true;
 }
 
-size_t PhysicsEngine::getDynamicBodyCount() const {
-    return std::count_if(bodies.begin(), bodies.end(),
-        [](const std::unique_ptr<RigidBody>& body) { return !body->getIsStatic(); });
+void PhysicsEngine::reserve(size_t bodyCount) {
+    bodies.reserve(bodyCount);
+    gridSettled.reserve(bodyCount);
 }
 
-void PhysicsEngine::updateSpatialGrid() {
-    spatialGrid.clear();
-    for (auto& body : bodies) {
-        spatialGrid.insert(body.get());
-    }
+void PhysicsEngine::addBodies(std::span<const RigidBody> newBodies, std::vector<BodyHandle>* outHandles) {
+    if (newBodies.empty()) return;
+    gridNeedsRebuild = true;
+    bodies.addBodies(newBodies, outHandles);
+}
+
+bool PhysicsEngine::removeBody(BodyHandle handle) {
+    return removeBodies(std::span<const BodyHandle>(&handle, 1)) == 1;
 }
 
-void PhysicsEngine::update(float deltaTime) {
-    for (auto& body : bodies) {
-        if (!body->getIsStatic() && !body->getIsResting()) {
-            body->applyForce(gravity * body->getMass());
+size_t PhysicsEngine::removeBodies(std::span<const BodyHandle> handles) {
+    // Statics belong to no island, so whatever sleeps on one has to be found
+    // by position - before any swap moves indices under the broad phase
+    for (BodyHandle handle : handles) {
+        if (bodies.contains(handle) && bodies.isStatic[bodies.indexOf(handle)]) {
+            size_t i = bodies.indexOf(handle);
+            wakeAround(bodies.getPosition(i), bodies.radius[i]);
         }
-        body->updateCollisionInfo(deltaTime);
     }
 
-    for (auto& body : bodies) {
-        body->update(deltaTime);
-        body->checkBoundaryCollision(worldWidth, worldHeight);
+    removedSlots.clear();
+    for (BodyHandle handle : handles) {
+        if (!bodies.contains(handle)) continue;  // Stale, or listed twice
+        uint32_t index = static_cast<uint32_t>(bodies.indexOf(handle));
+        islands.removeBody(bodies, index);
+        bodies.removeSwap(index);
+        removedSlots.push_back(handle.slot);
     }
+    if (removedSlots.empty()) return 0;
 
-    // Use spatial grid for collision detection
-    updateSpatialGrid();
-    auto potentialCollisions = spatialGrid.getPotentialCollisions();
-
-    for (const auto& pair : potentialCollisions) {
-        // Skip if both bodies are static or resting
-        if ((pair.first->getIsStatic() || pair.first->getIsResting()) &&
-            (pair.second->getIsStatic() || pair.second->getIsResting())) {
-            continue;
-        }
-        checkCollision(*pair.first, *pair.second);
+    std::sort(removedSlots.begin(), removedSlots.end());
+    contactSolver.forgetBodies(removedSlots);
+    ccd.clear();
+    gridNeedsRebuild = true;  // One body per removal changed index
+    return removedSlots.size();
+}
+
+size_t PhysicsEngine::getDynamicBodyCount() const {
+    return std::count(bodies.isStatic.begin(), bodies.isStatic.end(), uint8_t(0));
+}
+
+size_t PhysicsEngine::getSleepingBodyCount() const {
+    // Only dynamic bodies are ever put to sleep
+    return std::count(bodies.isResting.begin(), bodies.isResting.end(), uint8_t(1));
+}
+
+void PhysicsEngine::setContinuousCollision(bool enabled) {
+    continuousCollision = enabled;
+    if (!enabled) {
+        ccd.clear();
+    }
+}
+
+void PhysicsEngine::setSleepingEnabled(bool enabled) {
+    sleepingEnabled = enabled;
+    if (!enabled) {
+        islands.wakeAll(bodies);
     }
+}
+
+void PhysicsEngine::setBroadPhase(BroadPhaseType type) {
+    if (type == broadPhaseType) return;
+    broadPhase().clear();  // Free the old one's entries
+    broadPhaseType = type;
+    gridNeedsRebuild = true;
+}
+
+BroadPhase& PhysicsEngine::broadPhase() {
+    if (broadPhaseType == BroadPhaseType::SweepAndPrune) return sweepAndPrune;
+    return spatialGrid;
+}
 
-    particleSystem.update(deltaTime);
+const BroadPhase& PhysicsEngine::broadPhase() const {
+    if (broadPhaseType == BroadPhaseType::SweepAndPrune) return sweepAndPrune;
+    return spatialGrid;
 }
 
 /**
- * COLLISION DETECTION & RESPONSE - NARROW PHASE
- * ==============================================
+ * KEEP THE GRID IN SYNC WITH THE BODIES
  *
- * This function implements:
- * 1. Circle-circle collision detection (geometric test)
- * 2. Position correction (separate overlapping objects)
- * 3. IMPULSE-BASED collision response (velocity change)
- * 4. Friction calculation
+ * FULL REBUILD - only after bodies were added or removed, because that is
+ * when BodyStore indices shift and every stored index may be wrong.
  *
- * IMPULSE-BASED PHYSICS:
- * Instead of applying forces over time (F = ma), we apply instant velocity changes
- * - Impulse J = change in momentum = Δ(mv)
- * - For instantaneous collisions, this is more stable than force-based
- * - Used in most modern game physics engines (Box2D, Bullet, PhysX)
+ * INCREMENTAL UPDATE - every other step:
+ * - Static bodies never move → skipped entirely
+ * - Resting bodies don't move either → skipped, but only once their cells
+ *   were refreshed at the moment they fell asleep (the solver may have
+ *   nudged them after the previous grid update)
+ * - Everything else asks the grid to move it; most stay in the same cells
+ *   and return straight away
  *
- * NEWTON'S THIRD LAW IN ACTION:
- * "For every action, there is an equal and opposite reaction"
- * - Body 1 receives impulse J
- * - Body 2 receives impulse -J (same magnitude, opposite direction)
- * - Total momentum is conserved!
+ * gridSettled doubles as the grid's sleep flags: pairs of two settled
+ * bodies are never generated (see SpatialGrid::setSleepFlags).
+ *
+ * Fast bodies (see ContinuousCollision) are filed under the box their whole
+ * step swept instead of their circle, so the broad phase pairs them with
+ * everything they passed.
+ *
+ * The same steps keep sweep and prune in sync when it is the broad phase
+ * in use - "cells" are then its sorted boxes.
  */
-void PhysicsEngine::checkCollision(RigidBody& body1, RigidBody& body2) {
-    // STEP 1: COLLISION DETECTION (Narrow Phase)
-    // Check if two circles are overlapping
-
-    sf::Vector2f diff = body2.getPosition() - body1.getPosition();
-    float distance = length(diff);  // Distance between centers
-    float minDistance = body1.getRadius() + body2.getRadius();  // Sum of radii
-
-    // Are the circles overlapping?
-    if (distance < minDistance) {
-        // EDGE CASE: Bodies exactly on top of each other
-        // Prevent division by zero when normalizing
-        if (distance < 0.001f) {
-            distance = 0.001f;
-            diff = sf::Vector2f(1.0f, 0.0f) * minDistance;  // Push apart horizontally
+void PhysicsEngine::updateSpatialGrid() {
+    BroadPhase& grid = broadPhase();
+    size_t count = bodies.size();
+    gridMoves = 0;
+
+    if (gridNeedsRebuild) {
+        grid.clear();
+        for (size_t i = 0; i < count; ++i) {
+            grid.insert(static_cast<uint32_t>(i), bodies.getPosition(i), bodies.radius[i]);
         }
-
-        // Wake up any sleeping bodies (collision means they're active!)
-        body1.wake();
-        body2.wake();
-
-        // STEP 2: CALCULATE COLLISION GEOMETRY
-        /**
-         * COLLISION NORMAL: Direction to push bodies apart
-         * Points from body1 toward body2
-         *
-         * VISUAL:
-         *     body1  →  normal  →  body2
-         *       O    ----------->    O
-         */
-        sf::Vector2f normal = normalise(diff);
-
-        /**
-         * OVERLAP/PENETRATION: How much circles are intersecting
-         * This shouldn't happen in reality, but due to discrete timesteps, it does
-         *
-         * Example: radii are 20 and 30, distance is 45
-         * - minDistance = 50 (they should be 50 apart)
-         * - overlap = 50 - 45 = 5 pixels of penetration
-         */
-        float overlap = minDistance - distance;
-
-        /**
-         * SEPARATION FACTOR: Slightly over-separate to prevent jitter
-         * 1.01 means separate 1% more than needed
-         * Prevents floating-point errors from causing repeated collisions
-         */
-        float separationFactor = 1.01f;
-
-        /**
-         * CONTACT POINT: Where the collision occurred
-         * Located on body1's surface, along the collision normal
-         */
-        sf::Vector2f contactPoint = body1.getPosition() + normal * body1.getRadius();
-
-        // Store collision data for debug visualization
-        body1.addCollisionInfo(contactPoint, -normal, overlap);
-        body2.addCollisionInfo(contactPoint, normal, overlap);
-
-        // STEP 3: POSITION CORRECTION
-        /**
-         * Separate the overlapping bodies immediately
-         * This prevents objects from getting "stuck" inside each other
-         *
-         * THREE CASES:
-         * 1. Both dynamic: Split the separation (each moves half)
-         * 2. One static: Only move the dynamic one (static = infinite mass)
-         * 3. Both static: No separation needed
-         */
-        if (!body1.getIsStatic() && !body2.getIsStatic()) {
-            // Both dynamic: each moves half the overlap
-            body1.setPosition(body1.getPosition() - normal * (overlap * 0.5f * separationFactor));
-            body2.setPosition(body2.getPosition() + normal * (overlap * 0.5f * separationFactor));
-        } else if (!body1.getIsStatic()) {
-            // Only body1 is dynamic: it moves the full overlap
-            body1.setPosition(body1.getPosition() - normal * (overlap * separationFactor));
-        } else if (!body2.getIsStatic()) {
-            // Only body2 is dynamic: it moves the full overlap
-            body2.setPosition(body2.getPosition() + normal * (overlap * separationFactor));
+        gridSettled.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            gridSettled[i] = bodies.isStatic[i] | bodies.isResting[i];
         }
-
-        // STEP 4: CALCULATE VELOCITY AT CONTACT POINT
-        /**
-         * For rotating objects, velocity at contact point ≠ velocity at center!
-         *
-         * FORMULA: v_contact = v_center + ω × r
-         * Where:
-         * - ω (omega) = angular velocity
-         * - r = vector from center to contact point
-         * - × = cross product (in 2D: produces perpendicular velocity)
-         *
-         * 2D CROSS PRODUCT: ω × r = (-ω * r.y, ω * r.x)
-         * This gives the linear velocity caused by rotation
-         *
-         * EXAMPLE: Spinning basketball hits floor
-         * - Center might be moving horizontally
-         * - But contact point also has velocity from spin
-         * - Total velocity = linear + rotational components
-         */
-        sf::Vector2f r1 = contactPoint - body1.getPosition();  // Radius vector to contact
-        sf::Vector2f r2 = contactPoint - body2.getPosition();
-
-        // Calculate velocity at contact point (linear + rotational)
-        sf::Vector2f v1 = body1.getVelocity() + sf::Vector2f(-body1.getAngularVelocity() * r1.y, body1.getAngularVelocity() * r1.x);
-        sf::Vector2f v2 = body2.getVelocity() + sf::Vector2f(-body2.getAngularVelocity() * r2.y, body2.getAngularVelocity() * r2.x);
-
-        /**
-         * RELATIVE VELOCITY: How fast objects are approaching/separating
-         * Positive along normal = separating (no collision response needed)
-         * Negative along normal = approaching (need to bounce apart)
-         */
-        sf::Vector2f relativeVelocity = v2 - v1;
-        float velocityAlongNormal = dot(relativeVelocity, normal);
-
-        // EARLY EXIT: Objects already separating? Don't apply impulse!
-        if (velocityAlongNormal > 0) {
-            return;  // Moving apart, no bounce needed
+        grid.setSleepFlags(gridSettled.data());
+        for (uint32_t i : ccd.getFastBodies()) {
+            sf::Vector2f min, max;
+            ContinuousCollision::getSweptBounds(bodies, i, min, max);
+            grid.update(i, min, max);
         }
+        gridNeedsRebuild = false;
+        gridMoves = count;
+        grid.rebuildIfDirty();
+        return;
+    }
 
-        // STEP 5: CALCULATE IMPULSE MAGNITUDE
-        /**
-         * COEFFICIENT OF RESTITUTION (e)
-         * Determines how "bouncy" the collision is
-         * - e = 0: Perfectly inelastic (objects stick together)
-         * - e = 1: Perfectly elastic (100% energy conserved)
-         *
-         * We use the MINIMUM of both bodies (less bouncy wins)
-         * Example: Rubber ball (e=0.8) hits concrete (e=0.3) → use 0.3
-         */
-        float e = std::min(body1.restitution, body2.restitution);
-
-        /**
-         * CROSS PRODUCT: r × n
-         * In 2D, cross product gives a SCALAR (in 3D it's a vector)
-         * Used to calculate rotational effect of impulse
-         *
-         * Physics meaning: How much torque will the impulse create?
-         * - Large r × n: Force applied far from center → lots of spin
-         * - Small r × n: Force near center → little spin
-         */
-        float r1CrossN = cross(r1, normal);
-        float r2CrossN = cross(r2, normal);
-
-        /**
-         * INVERSE MASS SUM
-         * For collision resolution, we work with inverse mass (1/m)
-         * Why? Static objects have infinite mass, so 1/∞ = 0 (easy to handle!)
-         *
-         * This sum determines how much the impulse affects linear motion
-         */
-        float invMassSum = 0.0f;
-        if (!body1.getIsStatic()) invMassSum += 1.0f / body1.getMass();
-        if (!body2.getIsStatic()) invMassSum += 1.0f / body2.getMass();
-
-        /**
-         * INVERSE INERTIA SUM (rotational component)
-         * Similar to inverse mass, but for rotation
-         * Weighted by (r × n)² because off-center impacts create more rotation
-         *
-         * Physics: How much will the impulse cause spinning?
-         */
-        float invInertiaSum = 0.0f;
-        if (!body1.getIsStatic()) invInertiaSum += (r1CrossN * r1CrossN) / body1.getInertia();
-        if (!body2.getIsStatic()) invInertiaSum += (r2CrossN * r2CrossN) / body2.getInertia();
-
-        /**
-         * IMPULSE FORMULA (derived from conservation of momentum and energy)
-         *
-         * j = -(1 + e) × v_rel_n / (1/m1 + 1/m2 + rotational_terms)
-         *
-         * Where:
-         * - j = impulse magnitude (scalar)
-         * - e = coefficient of restitution
-         * - v_rel_n = relative velocity along normal
-         * - rotational_terms = angular effects (from cross products)
-         *
-         * DERIVATION (simplified):
-         * 1. Conservation of momentum: m1*v1' + m2*v2' = m1*v1 + m2*v2
-         * 2. Coefficient of restitution: e = (v2' - v1') / (v1 - v2)
-         * 3. Solve for impulse J that satisfies both equations
-         * 4. Include rotational inertia for realistic spinning
-         *
-         * The negative sign is because we're calculating the approach velocity
-         */
-        float j = -(1.0f + e) * velocityAlongNormal;
-        j /= (invMassSum + invInertiaSum);
-
-        /**
-         * IMPULSE VECTOR: Direction and magnitude
-         * Impulse points along the collision normal
-         * Magnitude j was calculated above
-         */
-        sf::Vector2f impulse = j * normal;
-
-        // Visual effect: Create particle burst at impact
-        float impactIntensity = std::abs(j) / 100.0f;  // Normalize for visuals
-        sf::Color averageColour(
-            (body1.getColour().r + body2.getColour().r) / 2,
-            (body1.getColour().g + body2.getColour().g) / 2,
-            (body1.getColour().b + body2.getColour().b) / 2
-        );
-        particleSystem.createImpactBurst(contactPoint, normal, averageColour, std::min(1.0f, impactIntensity));
-
-        // STEP 6: APPLY IMPULSE - NEWTON'S THIRD LAW!
-        /**
-         * "For every action, there is an equal and opposite reaction"
-         *
-         * VELOCITY CHANGE from impulse:
-         * Δv = J / m  (change in velocity = impulse / mass)
-         *
-         * ANGULAR VELOCITY CHANGE from impulse:
-         * Δω = (r × J) / I  (change in angular velocity = torque / inertia)
-         *
-         * KEY OBSERVATIONS:
-         * - Body 1 gets -impulse (negative direction)
-         * - Body 2 gets +impulse (positive direction)
-         * - Equal magnitude, opposite directions → Newton's 3rd Law!
-         * - Heavier objects change velocity less (larger m in denominator)
-         * - Off-center hits create more spin (larger r × J)
-         */
-        if (!body1.getIsStatic()) {
-            // Linear velocity change
-            body1.setVelocity(body1.getVelocity() - impulse / body1.getMass());
-
-            // Angular velocity change (torque from impulse)
-            body1.setAngularVelocity(body1.getAngularVelocity() - cross(r1, impulse) / body1.getInertia());
+    const std::vector<uint32_t>& fastBodies = ccd.getFastBodies();
+    size_t nextFast = 0;  // Both walk up the indices - no per-body lookup
+
+    for (size_t i = 0; i < count; ++i) {
+        if (bodies.isStatic[i]) continue;
+
+        uint8_t resting = bodies.isResting[i];
+        if (resting && gridSettled[i]) continue;
+        gridSettled[i] = resting;
+
+        bool moved;
+        if (nextFast < fastBodies.size() && fastBodies[nextFast] == i) {
+            sf::Vector2f min, max;
+            ContinuousCollision::getSweptBounds(bodies, fastBodies[nextFast++], min, max);
+            moved = grid.update(static_cast<uint32_t>(i), min, max);
+        } else {
+            moved = grid.update(static_cast<uint32_t>(i), bodies.getPosition(i), bodies.radius[i]);
         }
-        if (!body2.getIsStatic()) {
-            // Note the OPPOSITE sign on impulse (+) - Newton's 3rd Law!
-            body2.setVelocity(body2.getVelocity() + impulse / body2.getMass());
-            body2.setAngularVelocity(body2.getAngularVelocity() + cross(r2, impulse) / body2.getInertia());
+        if (moved) {
+            ++gridMoves;
         }
+    }
+    grid.rebuildIfDirty();  // Hashed grid regroups only if someone changed cells; SAP re-sorts
+}
 
-        // STEP 7: FRICTION (Tangential Impulse)
-        /**
-         * FRICTION opposes sliding motion
-         * Acts perpendicular (tangent) to the collision normal
-         *
-         * TANGENT DIRECTION:
-         * - Normal = perpendicular to surface (bounce direction)
-         * - Tangent = parallel to surface (sliding direction)
-         *
-         * VISUAL:
-         *        normal ↑
-         *               |
-         *    ← tangent--O-→ tangent (sliding motion)
-         *               |
-         *               ↓
-         *
-         * We remove the normal component from relative velocity to get tangent
-         */
-        sf::Vector2f tangent = relativeVelocity - normal * velocityAlongNormal;
-
-        // Only apply friction if there's tangential motion
-        if (length(tangent) > 0.001f) {
-            tangent = normalise(tangent);
-
-            /**
-             * COEFFICIENT OF FRICTION
-             * Average the friction coefficients of both materials
-             * Example: Rubber (0.8) on ice (0.1) → average = 0.45
-             */
-            float frictionCoeff = (body1.friction + body2.friction) * 0.5f;
-
-            /**
-             * FRICTION IMPULSE MAGNITUDE
-             * Similar formula to normal impulse, but along tangent direction
-             */
-            float jt = -dot(relativeVelocity, tangent);
-            jt /= (invMassSum + invInertiaSum);
-
-            /**
-             * COULOMB FRICTION LAW
-             * Friction force is limited by normal force
-             * - μ (mu) = coefficient of friction
-             * - F_friction ≤ μ × F_normal
-             *
-             * In impulse terms: J_friction ≤ μ × J_normal
-             *
-             * PHYSICAL MEANING:
-             * - Can't have more friction than the normal force allows
-             * - Heavy normal force → more friction possible
-             * - Light normal force → less friction possible
-             * Example: Pushing down on object makes it harder to slide
-             */
-            float frictionLimit = std::abs(j * frictionCoeff);
-            jt = std::clamp(jt, -frictionLimit, frictionLimit);
-
-            /**
-             * APPLY FRICTION IMPULSE
-             * Same process as normal impulse, but along tangent
-             * This slows down sliding and creates realistic rolling/skidding
-             */
-            sf::Vector2f frictionImpulse = jt * tangent;
-            if (!body1.getIsStatic()) {
-                body1.setVelocity(body1.getVelocity() - frictionImpulse / body1.getMass());
-                body1.setAngularVelocity(body1.getAngularVelocity() - cross(r1, frictionImpulse) / body1.getInertia());
-            }
-            if (!body2.getIsStatic()) {
-                body2.setVelocity(body2.getVelocity() + frictionImpulse / body2.getMass());
-                body2.setAngularVelocity(body2.getAngularVelocity() + cross(r2, frictionImpulse) / body2.getInertia());
-            }
-        }
+/**
+ * FIXED TIMESTEP WITH AN ACCUMULATOR
+ * ==================================
+ *
+ * PROBLEM with "one step per frame, dt = frame time":
+ * - A 200ms hitch becomes one 200ms step - fast bodies tunnel through each other
+ * - 144Hz monitors simulate differently (and cost more) than 60Hz ones
+ *
+ * SOLUTION: Physics always steps by the SAME dt. Real time is collected in an
+ * accumulator and spent in fixed-size steps:
+ *
+ *   frame time:  |---16.7ms---|---16.7ms---|------50ms (hitch)------|
+ *   120Hz steps: |--8.3--8.3--|--8.3--8.3--|-8.3-8.3-8.3-8.3-8.3-8.3|
+ *
+ * SPIRAL OF DEATH:
+ * If steps take longer than the time they simulate, each frame has more time
+ * to catch up than the last. maxStepsPerFrame caps the work; time beyond the
+ * cap is dropped (the simulation briefly runs slower than real time instead
+ * of freezing).
+ *
+ * INTERPOLATION:
+ * The leftover time (less than one step) means the screen is between two
+ * physics states. Drawing blends the previous and the current state by
+ * alpha = leftover / dt, so motion looks smooth even at 120Hz physics / 60Hz display.
+ */
+void PhysicsEngine::setFixedTimestep(float stepsPerSecond, int maxSteps) {
+    fixedDeltaTime = stepsPerSecond > 0.0f ? 1.0f / stepsPerSecond : 0.0f;
+    maxStepsPerFrame = std::max(1, maxSteps);
+    accumulator = 0.0f;
+    interpolationAlpha = 1.0f;
+}
+
+void PhysicsEngine::setDeterministic(bool enabled, uint32_t seed) {
+    deterministic = enabled;
+    contactSolver.setDeterministic(enabled);
+    stateHash = 0;
+    if (!enabled) return;
+
+    particleSystem.setSeed(seed);
+    if (!isFixedTimestep()) {
+        setFixedTimestep(120.0f, maxStepsPerFrame);
     }
 }
 
-void PhysicsEngine::drawBatchedGlows(sf::RenderWindow& window) {
-    glowVertices.clear();
-    glowVertices.setPrimitiveType(sf::PrimitiveType::Triangles);
+void PhysicsEngine::update(float frameTime) {
+    if (!isFixedTimestep()) {
+        step(frameTime);
+        stepsLastFrame = 1;
+        interpolationAlpha = 1.0f;
+        return;
+    }
 
-    const int glowLayers = 3;
-    const int segments = 16; // Reduced from default circle resolution for performance
+    accumulator += frameTime;
+    stepsLastFrame = 0;
+    while (accumulator >= fixedDeltaTime && stepsLastFrame < maxStepsPerFrame) {
+        step(fixedDeltaTime);
+        accumulator -= fixedDeltaTime;
+        ++stepsLastFrame;
+    }
 
-    for (const auto& body : bodies) {
-        if (body->getIsStatic()) continue;
+    // Hit the cap - drop whole steps we couldn't afford, keep the fraction
+    if (accumulator >= fixedDeltaTime) {
+        accumulator = std::fmod(accumulator, fixedDeltaTime);
+    }
+    interpolationAlpha = accumulator / fixedDeltaTime;
+}
 
-        sf::Vector2f pos = body->getPosition();
-        float radius = body->getRadius();
-        sf::Color colour = body->getColour();
-        float impactIntensity = body->impactIntensity;
-        bool isResting = body->getIsResting();
+void PhysicsEngine::step(float deltaTime) {
+    {
+        ScopedTimer timer(profiler, ProfilePhase::Effects);
+        updateVisualEffects(deltaTime);
+    }
+    {
+        ScopedTimer timer(profiler, ProfilePhase::Integrate);
+        islands.wakeFlagged(bodies);  // Bodies woken from outside take their island along
+        integrateBodies(deltaTime);
+    }
+    if (continuousCollision) {
+        ScopedTimer timer(profiler, ProfilePhase::Continuous);
+        ccd.findFastBodies(bodies);
+    }
 
-        // Calculate display color
-        sf::Color displayColour = isResting ?
-            sf::Color(colour.r / 2, colour.g / 2, colour.b / 2) : colour;
+    // Use spatial grid for collision detection
+    {
+        ScopedTimer timer(profiler, ProfilePhase::GridRebuild);
+        updateSpatialGrid();
+    }
+    {
+        ScopedTimer timer(profiler, ProfilePhase::PairGeneration);
+        // Pairs where both bodies are static or asleep are never emitted (gridSettled)
+        broadPhase().getPotentialCollisions(potentialPairs);
+    }
+    if (!ccd.getFastBodies().empty()) {
+        // Fast bodies back to their first impact, just inside the solver's slop
+        ScopedTimer timer(profiler, ProfilePhase::Continuous);
+        ccd.clampToImpact(bodies, broadPhase(), contactSolver.getSettings().linearSlop);
+    }
 
-        float flashIntensity = impactIntensity * 100.0f;
-        displayColour.r = std::min(255, static_cast<int>(displayColour.r + flashIntensity));
-        displayColour.g = std::min(255, static_cast<int>(displayColour.g + flashIntensity));
-        displayColour.b = std::min(255, static_cast<int>(displayColour.b + flashIntensity));
+    solveContacts(deltaTime);
 
-        // Draw glow layers as triangle fans
-        for (int layer = glowLayers; layer > 0; --layer) {
-            float glowRadius = radius + (layer * 4.0f) + (impactIntensity * 5.0f);
-            float alpha = isResting ? 10.0f : 20.0f;
-            alpha = alpha / (layer + 1) + (impactIntensity * 30.0f);
+    if (sleepingEnabled) {
+        ScopedTimer timer(profiler, ProfilePhase::Islands);
+        islands.update(bodies, contactSolver.getContacts(), deltaTime);
+    }
 
-            sf::Color glowColor(displayColour.r, displayColour.g, displayColour.b,
-                               static_cast<uint8_t>(alpha));
+    {
+        ScopedTimer timer(profiler, ProfilePhase::Effects);
+        flushCollisionEvents();
+        particleSystem.update(deltaTime);
+    }
 
-            // Create triangle fan for circle
-            for (int i = 0; i < segments; ++i) {
-                float angle1 = (i * 2.0f * 3.14159f) / segments;
-                float angle2 = ((i + 1) * 2.0f * 3.14159f) / segments;
+    if (deterministic) {
+        stateHash = bodies.computeStateHash();
+    }
 
-                sf::Vector2f p1 = pos + sf::Vector2f(std::cos(angle1) * glowRadius,
-                                                      std::sin(angle1) * glowRadius);
-                sf::Vector2f p2 = pos + sf::Vector2f(std::cos(angle2) * glowRadius,
-                                                      std::sin(angle2) * glowRadius);
+    if (recorder && recorder->isRecording()) {
+        ScopedTimer timer(profiler, ProfilePhase::Record);
+        recorder->capture(bodies);
+    }
 
-                glowVertices.append(sf::Vertex(pos, glowColor));
-                glowVertices.append(sf::Vertex(p1, glowColor));
-                glowVertices.append(sf::Vertex(p2, glowColor));
-            }
-        }
+    if (profiler) {
+        recordCounters();
     }
+}
 
-    window.draw(glowVertices);
+/**
+ * Workload counters for the profiler (values from the latest step)
+ */
+void PhysicsEngine::recordCounters() {
+    profiler->setCounter(ProfileCounter::CandidatePairs, potentialPairs.size());
+    profiler->setCounter(ProfileCounter::Contacts, contactSolver.getContacts().size());
+    profiler->setCounter(ProfileCounter::GridMoves, gridMoves);
+    profiler->setCounter(ProfileCounter::FastBodies, ccd.getFastBodies().size());
+    profiler->setCounter(ProfileCounter::SleepingBodies, getSleepingBodyCount());
+    profiler->setCounter(ProfileCounter::SleepingIslands, islands.getSleepingIslandCount());
+    profiler->setCounter(ProfileCounter::ParticlesAlive, particleSystem.getParticleCount());
+    profiler->setCounter(ProfileCounter::ImpactEvents, impactQueue.getEventCount());
+    profiler->setCounter(ProfileCounter::ImpactBursts, impactQueue.getBurstCount());
 }
 
-void PhysicsEngine::drawBatchedTrails(sf::RenderWindow& window) {
-    trailVertices.clear();
-    trailVertices.setPrimitiveType(sf::PrimitiveType::Lines);
+/**
+ * COLLISION RESPONSE PIPELINE
+ * Each stage runs over the whole contact array before the next one starts
+ * (see ContactSolver.hpp for what each stage does)
+ */
+void PhysicsEngine::solveContacts(float deltaTime) {
+    {
+        ScopedTimer timer(profiler, ProfilePhase::NarrowPhase);
+        contactSolver.generateContacts(bodies, potentialPairs);
 
-    for (const auto& body : bodies) {
-        const auto& trail = body->getMotionTrail();
-        sf::Color colour = body->getColour();
+        // An awake body touching a sleeping one wakes that body's whole island
+        islands.wakeTouched(bodies, contactSolver.getContacts());
+    }
 
-        if (trail.size() < 2) continue;
+    ScopedTimer timer(profiler, ProfilePhase::Solve);
+    contactSolver.prepare(bodies, deltaTime);
+    contactSolver.warmStart(bodies);
+    contactSolver.solveVelocities(bodies);
+    contactSolver.solvePositions(bodies);
+    contactSolver.storeImpulses();
+    contactSolver.emitImpactEvents(bodies, impactQueue.getThreadBuffers());
+}
 
-        for (size_t i = 1; i < trail.size(); ++i) {
-            uint8_t alpha = static_cast<uint8_t>(trail[i].alpha * 150);
-            sf::Color trailColor(colour.r, colour.g, colour.b, alpha);
+/**
+ * Apply the visual side effects of this step's contacts
+ * Sparks go through the impact queue (merged, culled, coalesced, capped)
+ * Debug markers are only recorded while debug capture is on
+ */
+void PhysicsEngine::flushCollisionEvents() {
+    if (debugCapture) {
+        for (const Contact& c : contactSolver.getContacts()) {
+            contactMarkers.push_back({c.point, c.normal, 1.0f});
+        }
 
-            trailVertices.append(sf::Vertex(trail[i - 1].position, trailColor));
-            trailVertices.append(sf::Vertex(trail[i].position, trailColor));
+        // Markers are appended in time order - over the cap, the oldest go first
+        if (contactMarkers.size() > MAX_CONTACT_MARKERS) {
+            contactMarkers.erase(contactMarkers.begin(),
+                                 contactMarkers.begin() + (contactMarkers.size() - MAX_CONTACT_MARKERS));
         }
     }
 
-    window.draw(trailVertices);
+    impactQueue.flush(particleSystem);
+}
+
+/**
+ * NUMERICAL INTEGRATION - Simulating Motion Over Time
+ *
+ * Update every body's state for one timestep using SEMI-IMPLICIT EULER method
+ *
+ * INTEGRATION METHODS (from simple to complex):
+ * 1. Explicit Euler: p += v*dt; v += a*dt (simple but unstable)
+ * 2. Semi-Implicit Euler: v += a*dt; p += v*dt (better stability) ← We use this!
+ * 3. Verlet: More accurate, used in many physics engines
+ * 4. Runge-Kutta (RK4): Very accurate, expensive
+ *
+ * WHY SEMI-IMPLICIT EULER?
+ * - Good balance of accuracy and speed
+ * - Better energy conservation than explicit Euler
+ * - Simpler than Verlet or RK4
+ *
+ * DATA LAYOUT:
+ * Integration only touches HOT arrays in BodyStore, walking them front to back.
+ * Visual-only state (trails, squash, debug info) is handled separately in
+ * updateVisualEffects() so it never competes for cache space here.
+ */
+void PhysicsEngine::integrateBodies(float deltaTime) {
+    // Vectorized: 4/8/16 bodies per instruction depending on the CPU (see Integrator.hpp)
+    Integrator::integrate(bodies, IntegrationParams{deltaTime, gravity.x, gravity.y}, simdLevel);
+
+    // Wall collisions branch a lot and are cheap - plain scalar loop
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        if (!bodies.isStatic[i] && !bodies.isResting[i]) {
+            solveBoundaryCollision(i);
+        }
+    }
 }
 
-void PhysicsEngine::draw(sf::RenderWindow& window, bool showVelocity, bool showTrails, bool showDebug) {
-    // Draw batched glows first (background layer)
-    drawBatchedGlows(window);
+/**
+ * COLLISION DETECTION & RESPONSE: Walls
+ *
+ * Check and resolve collisions with world boundaries
+ * Applies coefficient of restitution (bounciness) and friction
+ */
+void PhysicsEngine::solveBoundaryCollision(size_t i) {
+    BodyStore& b = bodies;
+    float radius = b.radius[i];
+    float restitution = b.restitution[i];
+    float friction = b.friction[i];
+    bool collided = false;
+
+    if (b.positionX[i] - radius < 0) {
+        b.positionX[i] = radius;
+        b.velocityX[i] = -b.velocityX[i] * restitution;
+        b.velocityY[i] *= (1.0f - friction);
+        b.angularVelocity[i] *= (1.0f - friction);
+        collided = true;
+    }
+    if (b.positionX[i] + radius > worldWidth) {
+        b.positionX[i] = worldWidth - radius;
+        b.velocityX[i] = -b.velocityX[i] * restitution;
+        b.velocityY[i] *= (1.0f - friction);
+        b.angularVelocity[i] *= (1.0f - friction);
+        collided = true;
+    }
+    if (b.positionY[i] - radius < 0) {
+        b.positionY[i] = radius;
+        b.velocityY[i] = -b.velocityY[i] * restitution;
+        b.velocityX[i] *= (1.0f - friction);
+        b.angularVelocity[i] *= (1.0f - friction);
+        collided = true;
+    }
+    if (b.positionY[i] + radius > worldHeight) {
+        b.positionY[i] = worldHeight - radius;
+        b.velocityY[i] = -b.velocityY[i] * restitution;
+        b.velocityX[i] *= (1.0f - friction);
+        b.angularVelocity[i] *= (1.0f - friction);
+        collided = true;
+    }
 
-    // Draw batched trails
-    if (showTrails) {
-        drawBatchedTrails(window);
+    if (collided) {
+        float intensity = length(b.getVelocity(i)) / 100.0f;
+        b.impactIntensity[i] = std::min(1.0f, intensity);
     }
+}
 
-    // Draw particles (will be optimized separately)
-    particleSystem.draw(window);
+/**
+ * Visual-only per-body state: trails, impact flash, squash, debug contacts
+ * Runs over the COLD arrays, separate from the physics loops
+ */
+void PhysicsEngine::updateVisualEffects(float deltaTime) {
+    BodyStore& b = bodies;
 
-    // Draw bodies (main shapes, cores, rotation indicators)
-    for (auto& body : bodies) {
-        body->draw(window, showVelocity);
+    // Debug contact markers fade out over half a second
+    for (auto& marker : contactMarkers) {
+        marker.lifetime -= deltaTime * 2.0f;
     }
+    contactMarkers.erase(
+        std::remove_if(contactMarkers.begin(), contactMarkers.end(),
+            [](const ContactMarker& marker) { return marker.lifetime <= 0.0f; }),
+        contactMarkers.end()
+    );
+
+    for (size_t i = 0; i < b.size(); ++i) {
+        if (b.isStatic[i]) continue;
 
-    // Draw debug visualizations
-    if (showDebug) {
-        for (auto& body : bodies) {
-            body->drawDebug(window);
+        // Trails fade by age at draw time; a resting body's trail stays as it was
+        if (!b.isResting[i]) {
+            b.trailTimer[i] += deltaTime;
+            if (b.trailTimer[i] >= RigidBody::TRAIL_UPDATE_INTERVAL) {
+                b.trailTimer[i] = 0.0f;
+                b.pushTrailPoint(i, b.getPosition(i));
+            }
         }
+
+        b.impactIntensity[i] *= 0.9f;
+        b.squashStretch[i] += (1.0f - b.squashStretch[i]) * 0.2f;
+
+        // Force about to be applied this step (for the debug arrow): gravity's F = m*g
+        // Resting bodies don't receive gravity
+        b.appliedForce[i] = b.isResting[i] ? sf::Vector2f(0.f, 0.f) : gravity * b.mass[i];
     }
 }
 
 void PhysicsEngine::setGravity(const sf::Vector2f& g) {
     gravity = g;
-    for (auto& body : bodies) {
-        body->wake();
+    islands.wakeAll(bodies);  // Every pile was balanced against the old gravity
+}
+
+namespace {
+    constexpr uint32_t SNAPSHOT_MAGIC = 0x4E534252u;  // "RBSN" in little-endian byte order
+    constexpr uint32_t SNAPSHOT_VERSION = 1;
+}
+
+/**
+ * SNAPSHOT FILE LAYOUT
+ *
+ *   magic, version               uint32 × 2
+ *   gravity, world width/height  float × 4
+ *   bodies                       BodyStore::writeSnapshot
+ *   sleep rings                  IslandManager::writeSnapshot
+ *   warm-start impulses          ContactSolver::writeSnapshot
+ */
+bool PhysicsEngine::saveSnapshot(const std::string& path) const {
+    SnapshotWriter out;
+    out.write(SNAPSHOT_MAGIC);
+    out.write(SNAPSHOT_VERSION);
+    out.write(gravity);
+    out.write(worldWidth);
+    out.write(worldHeight);
+    bodies.writeSnapshot(out);
+    islands.writeSnapshot(out, bodies);
+    contactSolver.writeSnapshot(out);
+    return out.saveToFile(path);
+}
+
+bool PhysicsEngine::loadSnapshot(const std::string& path) {
+    SnapshotReader in;
+    if (!in.loadFromFile(path)) return false;
+
+    uint32_t magic = 0, version = 0;
+    in.read(magic);
+    in.read(version);
+    if (magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION) return false;
+
+    sf::Vector2f loadedGravity;
+    float width = 0.0f, height = 0.0f;
+    in.read(loadedGravity);
+    in.read(width);
+    in.read(height);
+    if (!in.ok() || !(width > 0.0f) || !(height > 0.0f)) return false;
+
+    // Read into temporaries first: a bad file must leave the world untouched.
+    // The solver goes last - it only changes itself once its part has checked out
+    BodyStore loadedBodies;
+    IslandManager loadedIslands;
+    if (!loadedBodies.readSnapshot(in) ||
+        !loadedIslands.readSnapshot(in, loadedBodies) ||
+        !contactSolver.readSnapshot(in)) {
+        return false;
     }
+
+    bodies = std::move(loadedBodies);
+    islands = std::move(loadedIslands);
+    gravity = loadedGravity;
+    if (width != worldWidth || height != worldHeight) {
+        worldWidth = width;
+        worldHeight = height;
+        spatialGrid.setWorldSize(width, height);
+    }
+
+    // Everything derived from body indices is rebuilt at the next step
+    broadPhase().clear();
+    gridNeedsRebuild = true;
+    ccd.clear();
+    contactMarkers.clear();
+    accumulator = 0.0f;
+    interpolationAlpha = 1.0f;
+    stateHash = deterministic ? bodies.computeStateHash() : 0;
+    return true;
 }
 
-RigidBody* PhysicsEngine::getBodyAt(const sf::Vector2f& point) {
-    for (auto& body : bodies) {
-        sf::Vector2f diff = body->getPosition() - point;
-        if (length(diff) <= body->getRadius()) {
-            return body.get();
+BodyHandle PhysicsEngine::getBodyAt(const sf::Vector2f& point) const {
+    overlapPoint(point, pickScratch);
+    return pickScratch.empty() ? BodyHandle{} : pickScratch.front();
+}
+
+void PhysicsEngine::overlapPoint(const sf::Vector2f& point, std::vector<BodyHandle>& outBodies) const {
+    overlapCircle(point, 0.0f, outBodies);
+}
+
+void PhysicsEngine::overlapRect(const sf::Vector2f& min, const sf::Vector2f& max, std::vector<BodyHandle>& outBodies) const {
+    queryBodiesInRect(min, max, queryScratch);
+    outBodies.clear();
+    for (uint32_t i : queryScratch) {
+        // Closest point of the rectangle to the centre - inside the circle?
+        float x = std::clamp(bodies.positionX[i], min.x, max.x) - bodies.positionX[i];
+        float y = std::clamp(bodies.positionY[i], min.y, max.y) - bodies.positionY[i];
+        if (x * x + y * y <= bodies.radius[i] * bodies.radius[i]) {
+            outBodies.push_back(bodies.handleAt(i));
+        }
+    }
+}
+
+void PhysicsEngine::overlapCircle(const sf::Vector2f& center, float radius, std::vector<BodyHandle>& outBodies) const {
+    sf::Vector2f extent(radius, radius);
+    queryBodiesInRect(center - extent, center + extent, queryScratch);
+    outBodies.clear();
+    for (uint32_t i : queryScratch) {
+        float reach = bodies.radius[i] + radius;
+        if (lengthSquared(bodies.getPosition(i) - center) <= reach * reach) {
+            outBodies.push_back(bodies.handleAt(i));
+        }
+    }
+}
+
+bool PhysicsEngine::raycast(const sf::Vector2f& origin, const sf::Vector2f& direction, float maxDistance,
+                            RayHit& outHit) const {
+    float directionLength = length(direction);
+    if (directionLength == 0.0f || !(maxDistance >= 0.0f)) return false;
+    sf::Vector2f unit = direction / directionLength;
+
+    ClosestRayHit closest(bodies, origin, unit, maxDistance);
+    if (gridNeedsRebuild || broadPhase().getBodyCount() != bodies.size()) {
+        // Indices changed since the last step (see queryBodiesInRect) - test everything
+        for (uint32_t i = 0; i < bodies.size(); ++i) {
+            closest.visit(i);
+        }
+    } else {
+        broadPhase().queryRay(origin, unit, maxDistance, GRID_QUERY_MARGIN, closest);
+    }
+    if (closest.body == UINT32_MAX) return false;
+
+    outHit.body = bodies.handleAt(closest.body);
+    outHit.distance = closest.closest;
+    outHit.point = origin + unit * closest.closest;
+    outHit.normal = closest.closest > 0.0f
+        ? (outHit.point - bodies.getPosition(closest.body)) / bodies.radius[closest.body]
+        : -unit;  // Started inside: push straight back out
+    return true;
+}
+
+void PhysicsEngine::setSpatialGridMode(SpatialGrid::Mode mode) {
+    if (mode == spatialGrid.getMode()) return;
+    spatialGrid.setMode(mode);
+    gridNeedsRebuild = true;
+}
+
+void PhysicsEngine::setMaxGridLevels(int levels) {
+    spatialGrid.setMaxLevels(levels);
+    gridNeedsRebuild = true;
+}
+
+void PhysicsEngine::setGridCellSize(float cellSize) {
+    spatialGrid.setBaseCellSize(cellSize);
+    gridNeedsRebuild = true;
+}
+
+void PhysicsEngine::queryBodiesInRect(const sf::Vector2f& min, const sf::Vector2f& max,
+                                      std::vector<uint32_t>& outBodies) const {
+    // Right after addBody()/clearDynamicBodies() the grid still describes the
+    // old indices until the next step rebuilds it - test every body instead
+    if (gridNeedsRebuild || broadPhase().getBodyCount() != bodies.size()) {
+        outBodies.clear();
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            float r = bodies.radius[i];
+            if (bodies.positionX[i] + r >= min.x && bodies.positionX[i] - r <= max.x &&
+                bodies.positionY[i] + r >= min.y && bodies.positionY[i] - r <= max.y) {
+                outBodies.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        return;
+    }
+
+    sf::Vector2f margin(GRID_QUERY_MARGIN, GRID_QUERY_MARGIN);
+    broadPhase().queryRect(min - margin, max + margin, outBodies);
+
+    // Cell (or sort) order → index order, so overlapping bodies keep a stable draw order
+    std::sort(outBodies.begin(), outBodies.end());
+}
+
+sf::Vector2f PhysicsEngine::getBodyPosition(BodyHandle handle) const {
+    if (!bodies.contains(handle)) return sf::Vector2f();
+    return bodies.getPosition(bodies.indexOf(handle));
+}
+
+bool PhysicsEngine::isBodyStatic(BodyHandle handle) const {
+    if (!bodies.contains(handle)) return false;
+    return bodies.isStatic[bodies.indexOf(handle)] != 0;
+}
+
+void PhysicsEngine::setBodyVelocity(BodyHandle handle, const sf::Vector2f& velocity) {
+    if (!bodies.contains(handle)) return;
+    bodies.setVelocity(bodies.indexOf(handle), velocity);
+}
+
+void PhysicsEngine::wakeBody(BodyHandle handle) {
+    if (!bodies.contains(handle)) return;
+    islands.wakeIsland(bodies, static_cast<uint32_t>(bodies.indexOf(handle)));
+}
+
+void PhysicsEngine::setBodyMassAndRadius(BodyHandle handle, float mass, float radius) {
+    if (!bodies.contains(handle)) return;
+    size_t i = bodies.indexOf(handle);
+    float oldRadius = bodies.radius[i];
+    bodies.setMassAndRadius(i, mass, radius);
+    if (bodies.isStatic[i]) {
+        // Shrinking drops what slept on it, growing pushes into sleepers the
+        // broad phase no longer tests - wake both footprints (grid still valid here)
+        wakeAround(bodies.getPosition(i), std::max(oldRadius, radius));
+        gridNeedsRebuild = true;  // The incremental grid update never looks at static bodies
+    } else {
+        islands.wakeIsland(bodies, static_cast<uint32_t>(i));  // Awake, so the grid refiles it next step
+    }
+}
+
+void PhysicsEngine::wakeRegion(const sf::Vector2f& min, const sf::Vector2f& max) {
+    queryBodiesInRect(min, max, regionScratch);
+    for (uint32_t i : regionScratch) {
+        if (!bodies.isResting[i]) continue;
+
+        // The query is conservative - only wake bodies that really overlap
+        float r = bodies.radius[i];
+        if (bodies.positionX[i] + r >= min.x && bodies.positionX[i] - r <= max.x &&
+            bodies.positionY[i] + r >= min.y && bodies.positionY[i] - r <= max.y) {
+            islands.wakeIsland(bodies, i);
+        }
+    }
+}
+
+void PhysicsEngine::wakeAround(sf::Vector2f centre, float radius) {
+    sf::Vector2f reach(radius + SUPPORT_WAKE_MARGIN, radius + SUPPORT_WAKE_MARGIN);
+    wakeRegion(centre - reach, centre + reach);
+}
+
+void PhysicsEngine::setDebugCapture(bool enabled) {
+    debugCapture = enabled;
+    if (!enabled) {
+        contactMarkers.clear();
+    }
+}
+
+/**
+ * Record this frame's debug primitives into the caller's command list
+ *
+ * Contacts: a dot at the contact point and an arrow each way along the
+ * normal (one per body). Alpha follows the marker's remaining lifetime.
+ * Forces: a line from each awake body along the force applied this step.
+ */
+void PhysicsEngine::fillDebugDraw(DebugDrawList& list, const DebugCategories& categories) const {
+    if (categories.contactPoints || categories.contactNormals) {
+        for (const ContactMarker& marker : contactMarkers) {
+            uint8_t alpha = static_cast<uint8_t>(marker.lifetime * 255.0f);
+            if (categories.contactPoints) {
+                list.addPoint(marker.point, 3.0f, sf::Color(255, 0, 0, alpha));
+            }
+            if (categories.contactNormals) {
+                list.addArrow(marker.point, marker.point + marker.normal * 30.0f, sf::Color(0, 255, 255, alpha));
+                list.addArrow(marker.point, marker.point - marker.normal * 30.0f, sf::Color(0, 255, 255, alpha));
+            }
+        }
+    }
+
+    if (categories.forces) {
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            sf::Vector2f appliedForce = bodies.appliedForce[i];
+            if (length(appliedForce) > 0.1f && !bodies.isResting[i]) {
+                sf::Vector2f position = bodies.getInterpolatedPosition(i, interpolationAlpha);
+                sf::Vector2f forceEnd = position + normalise(appliedForce) * (length(appliedForce) / 50.0f);
+                list.addLine(position, forceEnd, sf::Color(255, 128, 0, 200));
+            }
         }
     }
-    return nullptr;
 }
@@ -1,41 +1,377 @@
 #pragma once
-#include <SFML/Graphics.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <span>
 #include <vector>
 #include <memory>
+#include <string>
 #include "RigidBody.hpp"
+#include "BodyStore.hpp"
 #include "ParticleSystem.hpp"
 #include "SpatialGrid.hpp"
+#include "HierarchicalGrid.hpp"
+#include "SweepAndPrune.hpp"
+#include "ThreadPool.hpp"
+#include "ContactSolver.hpp"
+#include "DebugDraw.hpp"
+#include "ImpactQueue.hpp"
+#include "Profiler.hpp"
+#include "Integrator.hpp"
+#include "IslandManager.hpp"
+#include "ContinuousCollision.hpp"
+#include "Snapshot.hpp"
+#include "TrajectoryRecorder.hpp"
 
+// Closest body along a ray (see PhysicsEngine::raycast)
+struct RayHit {
+    BodyHandle body;
+    float distance = 0.0f;  // Along the ray from its origin (0 = the origin is inside the body)
+    sf::Vector2f point;     // Where the ray enters the body
+    sf::Vector2f normal;    // Surface normal there, pointing out of the body
+};
+
+/**
+ * PHYSICS ENGINE - SIMULATION ONLY
+ *
+ * Owns the bodies and runs the step pipeline. It never touches a window,
+ * so it can be built and run headless (see Benchmark/Benchmark.cpp).
+ * Drawing lives in PhysicsRenderer, which reads the state exposed below.
+ */
 class PhysicsEngine {
 public:
     PhysicsEngine(float width, float height);
 
-    void addBody(std::unique_ptr<RigidBody> body);
+    BodyHandle addBody(const RigidBody& body);
     void clearDynamicBodies();
-    void update(float deltaTime);
-    void draw(sf::RenderWindow& window, bool showVelocity, bool showTrails, bool showDebug);
+
+    /**
+     * BULK CREATION AND REMOVAL
+     * - reserve():      room for that many bodies - spawning up to it never reallocates
+     * - addBodies():    a whole batch, every body array grown once; handles are
+     *                   appended to outHandles if given
+     * - removeBody():   O(1) swap-and-pop (the last body takes the gap, so body
+     *                   order is not kept - clearDynamicBodies() keeps it)
+     * - removeBodies(): several at once; returns how many handles were valid
+     * Removal wakes only the removed bodies' islands and drops only their
+     * warm-start impulses; the broad phase is rebuilt once at the next step
+     * however many bodies went.
+     */
+    void reserve(size_t bodyCount);
+    void addBodies(std::span<const RigidBody> newBodies, std::vector<BodyHandle>* outHandles = nullptr);
+    bool removeBody(BodyHandle handle);
+    size_t removeBodies(std::span<const BodyHandle> handles);
+
+    /**
+     * Advance the simulation by one rendered frame
+     * - Variable mode (default): one step of frameTime
+     * - Fixed mode: as many fixed steps as the accumulated time allows
+     */
+    void update(float frameTime);
+
+    /**
+     * Advance exactly one physics step of deltaTime, bypassing the accumulator
+     */
+    void step(float deltaTime);
 
     void setGravity(const sf::Vector2f& g);
     sf::Vector2f getGravity() const { return gravity; }
+    float getWorldWidth() const { return worldWidth; }
+    float getWorldHeight() const { return worldHeight; }
+
+    /**
+     * SNAPSHOTS (see Snapshot.hpp)
+     * Save: every body (state, materials, sleep, handles), the warm-start
+     * impulses, gravity and the world size, as raw arrays.
+     * Load: replaces all of that - including the world size - and keeps the
+     * engine's settings (threads, broad phase, solver, timestep). Handles
+     * saved with the scene stay valid. On failure nothing changes.
+     * In deterministic mode a loaded world continues bit for bit as the
+     * saved one would have.
+     * @return false if the file can't be written / read or isn't a snapshot
+     */
+    bool saveSnapshot(const std::string& path) const;
+    bool loadSnapshot(const std::string& path);
 
-    RigidBody* getBodyAt(const sf::Vector2f& point);
+    // The body under point (the lowest index if several overlap), invalid handle if none
+    BodyHandle getBodyAt(const sf::Vector2f& point) const;
+
+    /**
+     * SPATIAL QUERIES - "what's near X", "what does this ray hit"
+     * Answered through the broad phase, so the cost follows the size of the
+     * query and not the size of the world. Results are exact (circle tests,
+     * unlike queryBodiesInRect) and written into the caller's vector, cleared
+     * first, in index order - keep the vector between calls and nothing is
+     * allocated. They share scratch space: one thread at a time.
+     */
+    void overlapPoint(const sf::Vector2f& point, std::vector<BodyHandle>& outBodies) const;
+    void overlapRect(const sf::Vector2f& min, const sf::Vector2f& max, std::vector<BodyHandle>& outBodies) const;
+    void overlapCircle(const sf::Vector2f& center, float radius, std::vector<BodyHandle>& outBodies) const;
+
+    /**
+     * Closest body hit by the ray origin + t * direction, t in 0..maxDistance
+     * The grid walks only the cells along the ray (DDA, see SpatialGrid::queryRay)
+     * and stops at the first cell past the closest hit.
+     * @param direction - any length but zero
+     * @return false if nothing is hit (outHit is then left alone)
+     */
+    bool raycast(const sf::Vector2f& origin, const sf::Vector2f& direction, float maxDistance, RayHit& outHit) const;
     size_t getBodyCount() const { return bodies.size(); }
     size_t getDynamicBodyCount() const;
 
+    /**
+     * Handle-based access for code outside the engine (e.g. mouse dragging)
+     * A stale handle (its body was removed) is safe: getters return a
+     * default (origin, not static) and setters do nothing - check isValid()
+     * to tell the two apart.
+     */
+    bool isValid(BodyHandle handle) const { return bodies.contains(handle); }
+    sf::Vector2f getBodyPosition(BodyHandle handle) const;
+    bool isBodyStatic(BodyHandle handle) const;
+    void setBodyVelocity(BodyHandle handle, const sf::Vector2f& velocity);
+    void wakeBody(BodyHandle handle);  // Wakes the body's whole island
+    void setBodyMassAndRadius(BodyHandle handle, float mass, float radius);  // Recomputes inertia and inverses; wakes it (or, if static, what rests on it)
+
+    /**
+     * Wake only the sleeping islands with a body overlapping min..max
+     * (e.g. around an explosion or a dragged body) - the rest of the world
+     * keeps sleeping. See IslandManager.
+     */
+    void wakeRegion(const sf::Vector2f& min, const sf::Vector2f& max);
+    size_t getSleepingIslandCount() const { return islands.getSleepingIslandCount(); }
+    size_t getSleepingBodyCount() const;
+
+    // Island sleeping on (default) or off - off wakes everything and keeps it awake
+    void setSleepingEnabled(bool enabled);
+    bool isSleepingEnabled() const { return sleepingEnabled; }
+
+    const BodyStore& getBodies() const { return bodies; }
+
+    /**
+     * Indices (ascending) of the bodies that may overlap the rectangle min..max
+     * Uses the spatial grid, so the cost follows the size of the rectangle and
+     * not the size of the world. Meant for view culling: results are
+     * conservative (a few bodies just outside may be included).
+     */
+    void queryBodiesInRect(const sf::Vector2f& min, const sf::Vector2f& max, std::vector<uint32_t>& outBodies) const;
+
+    /**
+     * DEBUG VIEW
+     * Capture on = remember recent contacts so they can be shown fading out
+     * (off by default - costs a little per contact per step)
+     * fillDebugDraw() appends this frame's markers/arrows to the caller's list
+     */
+    void setDebugCapture(bool enabled);
+    bool isDebugCapture() const { return debugCapture; }
+    void fillDebugDraw(DebugDrawList& list, const DebugCategories& categories) const;
+    const ParticleSystem& getParticleSystem() const { return particleSystem; }
+
+    /**
+     * IMPACT PARTICLES
+     * budget - most sparks alive at once (pool is sized to it)
+     * policy - what happens to a new burst once the pool is full
+     */
+    void setParticleBudget(size_t budget) { particleSystem.setBudget(budget); }
+    void setParticleEvictionPolicy(ParticleEvictionPolicy policy) { particleSystem.setEvictionPolicy(policy); }
+
+    /**
+     * How contact impacts become bursts (culling, merging, per-step cap)
+     * See ImpactQueue for the pipeline
+     */
+    void setImpactSettings(const ImpactSettings& settings) { impactQueue.setSettings(settings); }
+    const ImpactSettings& getImpactSettings() const { return impactQueue.getSettings(); }
+
+    /**
+     * Attach a profiler to time each stage of step() (nullptr = off)
+     * The profiler is not owned and must outlive the engine's use of it
+     */
+    void setProfiler(Profiler* newProfiler) { profiler = newProfiler; }
+    Profiler* getProfiler() const { return profiler; }
+
+    /**
+     * Attach a trajectory recorder (nullptr = none): while it is recording,
+     * every step() ends with recorder->capture(). Not owned.
+     */
+    void setRecorder(TrajectoryRecorder* newRecorder) { recorder = newRecorder; }
+    TrajectoryRecorder* getRecorder() const { return recorder; }
+
+    // Last step's workload (for stats and benchmarks)
+    size_t getPotentialPairCount() const { return potentialPairs.size(); }
+    size_t getContactCount() const { return contactSolver.getContacts().size(); }
+    size_t getGridMoveCount() const { return gridMoves; }  // Bodies that changed cells
+
+    /**
+     * BROAD PHASE
+     * Grid (default) or sweep and prune, switchable at any time (the new one
+     * is filled at the next step). See BroadPhase.hpp for which suits what.
+     * The grid settings below only matter while the grid is in use.
+     */
+    void setBroadPhase(BroadPhaseType type);
+    BroadPhaseType getBroadPhase() const { return broadPhaseType; }
+
+    /**
+     * SPATIAL GRID STORAGE
+     * Dense (one cell per grid square) or Hashed (occupied cells only).
+     * Huge worlds start Hashed; see SpatialGrid::Mode for the trade-off.
+     */
+    void setSpatialGridMode(SpatialGrid::Mode mode);
+    SpatialGrid::Mode getSpatialGridMode() const { return spatialGrid.getMode(); }
+    size_t getGridCellCount() const { return spatialGrid.getCellCount(); }
+
+    /**
+     * GRID LEVELS FOR MIXED BODY SIZES
+     * Bodies wider than a level-0 cell go to coarser levels (see HierarchicalGrid)
+     * 1 = one fixed grid for every body, as before levels existed
+     */
+    void setMaxGridLevels(int levels);
+    int getMaxGridLevels() const { return spatialGrid.getMaxLevels(); }
+    size_t getGridLevelCount() const { return spatialGrid.getLevelCount(); }
+
+    // Level-0 cell size in pixels (default 100 - suits 8-35px bodies)
+    void setGridCellSize(float cellSize);
+    float getGridCellSize() const { return spatialGrid.getBaseCellSize(); }
+
+    /**
+     * PARALLEL CONTACT SOLVING
+     * 1 (default) = solve every pair on the calling thread, in broad-phase order
+     * N > 1       = colour contacts into conflict-free batches and solve each
+     *               batch on N threads (see ContactSolver)
+     */
+    void setThreadCount(unsigned count);
+    unsigned getThreadCount() const { return threadPool ? threadPool->getThreadCount() : 1; }
+
+    /**
+     * SIMD INTEGRATION
+     * Defaults to the widest instruction set the CPU supports.
+     * Requests above that are clamped (handy for comparing levels in benchmarks).
+     */
+    void setSimdLevel(SimdLevel level);
+    SimdLevel getSimdLevel() const { return simdLevel; }
+
+    /**
+     * FIXED TIMESTEP
+     * @param stepsPerSecond   - Physics rate, independent of the display rate (e.g. 120)
+     * @param maxStepsPerFrame - Cap so one slow frame can't trigger ever more steps
+     * Pass stepsPerSecond <= 0 to go back to one variable step per frame
+     */
+    void setFixedTimestep(float stepsPerSecond, int maxStepsPerFrame = 8);
+    bool isFixedTimestep() const { return fixedDeltaTime > 0.0f; }
+    float getFixedDeltaTime() const { return fixedDeltaTime; }
+    int getStepsLastFrame() const { return stepsLastFrame; }
+
+    /**
+     * How far rendering is between the previous and the current step (0-1)
+     * Always 1 in variable mode
+     */
+    float getInterpolationAlpha() const { return interpolationAlpha; }
+
+    /**
+     * CONTINUOUS COLLISION FOR FAST BODIES
+     * On (default): bodies moving more than motionFraction × their radius in
+     * one step are swept, so they stop at what they would have passed
+     * through (see ContinuousCollision). Slower bodies cost nothing extra.
+     */
+    void setContinuousCollision(bool enabled);
+    bool isContinuousCollision() const { return continuousCollision; }
+    void setFastMotionFraction(float fraction) { ccd.setMotionFraction(fraction); }
+    float getFastMotionFraction() const { return ccd.getMotionFraction(); }
+    size_t getFastBodyCount() const { return ccd.getFastBodies().size(); }  // Last step
+
+    /**
+     * DETERMINISTIC MODE (replays, lockstep networking)
+     * Same start state + same inputs + same number of step() calls
+     * = bit-identical bodies, whatever the thread count or broad phase:
+     * - contacts are solved in stable pair order (see ContactSolver)
+     * - the particle RNG is seeded with `seed`
+     * - the fixed timestep is switched on (120 Hz) if it isn't already
+     *
+     * Still the caller's job: feed inputs on the same steps, and count
+     * steps rather than frames - update() drops steps a slow frame can't
+     * afford. Builds must also agree on floating point (same compiler
+     * flags, no -ffast-math) for two machines to match.
+     */
+    void setDeterministic(bool enabled, uint32_t seed = 0);
+    bool isDeterministic() const { return deterministic; }
+
+    // BodyStore::computeStateHash() after the last step (deterministic mode only, else 0)
+    uint64_t getStateHash() const { return stateHash; }
+
+    /**
+     * SOLVER QUALITY
+     * More iterations = stiffer stacks and quicker settling, at a cost that
+     * grows linearly with the count (see SolverSettings)
+     */
+    void setSolverSettings(const SolverSettings& settings) { contactSolver.setSettings(settings); }
+    const SolverSettings& getSolverSettings() const { return contactSolver.getSettings(); }
+
 private:
-    void checkCollision(RigidBody& body1, RigidBody& body2);
+    void integrateBodies(float deltaTime);
+    void solveBoundaryCollision(size_t i);
+    void updateVisualEffects(float deltaTime);
+    void solveContacts(float deltaTime);
+    void flushCollisionEvents();
+    void recordCounters();
     void updateSpatialGrid();
-    void drawBatchedGlows(sf::RenderWindow& window);
-    void drawBatchedTrails(sf::RenderWindow& window);
+    BroadPhase& broadPhase();
+    const BroadPhase& broadPhase() const;
+    void wakeAround(sf::Vector2f centre, float radius);  // wakeRegion() over a circle's box plus SUPPORT_WAKE_MARGIN
 
-    std::vector<std::unique_ptr<RigidBody>> bodies;
+    BodyStore bodies;
     ParticleSystem particleSystem;
-    SpatialGrid spatialGrid;
+    HierarchicalGrid spatialGrid;
+    SweepAndPrune sweepAndPrune;
+    BroadPhaseType broadPhaseType = BroadPhaseType::Grid;
+    std::vector<CollisionPair> potentialPairs;  // Broad-phase output, reused every frame
+
+    // Incremental grid state (see updateSpatialGrid) - kept for whichever broad phase is in use
+    bool gridNeedsRebuild = true;         // Set whenever body indices change
+    std::vector<uint8_t> gridSettled;     // Body was static or resting at its last grid update
+    size_t gridMoves = 0;
+
+    // Bodies keep moving after the grid update at the start of a step;
+    // rectangle queries are widened by this much to still find them
+    static constexpr float GRID_QUERY_MARGIN = 32.0f;
+
+    // Sleepers resting on a static body that is removed or resized are
+    // within this gap of it (well over the solver's default slop)
+    static constexpr float SUPPORT_WAKE_MARGIN = 2.0f;
+
+    ContactSolver contactSolver;
+    IslandManager islands;
+    ContinuousCollision ccd;
+    bool continuousCollision = true;
+    bool sleepingEnabled = true;
+    bool deterministic = false;
+    uint64_t stateHash = 0;
+    std::vector<uint32_t> regionScratch;  // wakeRegion() query results
+    std::vector<uint32_t> removedSlots;   // removeBodies() scratch
+    mutable std::vector<uint32_t> queryScratch;     // Spatial query candidates
+    mutable std::vector<BodyHandle> pickScratch;    // getBodyAt() results
+
+    // Recent contacts for the debug view, oldest first (one flat array for all bodies)
+    struct ContactMarker {
+        sf::Vector2f point;
+        sf::Vector2f normal;   // From body A toward body B
+        float lifetime;        // 1 → 0, then removed
+    };
+    static constexpr size_t MAX_CONTACT_MARKERS = 50000;
+    std::vector<ContactMarker> contactMarkers;
+    bool debugCapture = false;
+    Profiler* profiler = nullptr;  // Not owned
+    TrajectoryRecorder* recorder = nullptr;  // Not owned
+
+    // Parallel solving state (buffers persist between frames)
+    std::unique_ptr<ThreadPool> threadPool;
+    ImpactQueue impactQueue;  // One event buffer per thread
+
+    // Fixed timestep state (fixedDeltaTime = 0 means variable mode)
+    float fixedDeltaTime = 0.0f;
+    int maxStepsPerFrame = 8;
+    float accumulator = 0.0f;
+    float interpolationAlpha = 1.0f;
+    int stepsLastFrame = 0;
+
+    SimdLevel simdLevel;
+
     sf::Vector2f gravity;
     float worldWidth;
     float worldHeight;
-
-    // Vertex arrays for batched rendering
-    sf::VertexArray glowVertices;
-    sf::VertexArray trailVertices;
 };
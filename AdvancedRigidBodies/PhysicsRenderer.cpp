@@ -0,0 +1,562 @@
+#include "PhysicsRenderer.hpp"
+#include "Vector2Utils.hpp"
+#include "UnitCircle.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+using namespace PhysicsUtils;
+
+namespace {
+    // Segments per disc when shaders are unavailable (sf::CircleShape's default)
+    constexpr int DISC_SEGMENTS = 30;
+    constexpr size_t QUAD_VERTICES = 6;
+    constexpr size_t FAN_VERTICES = DISC_SEGMENTS * 3;
+    constexpr size_t DISCS_PER_BODY = 3;   // Outline, fill, core
+    constexpr size_t LINES_PER_BODY = 2;   // Rotation, velocity
+
+    /**
+     * LEVEL OF DETAIL
+     * Picked from a body's radius in SCREEN pixels, so zooming out drops
+     * detail nobody can see:
+     *
+     *   ≥ 8 px   Full     30-slice discs, core, lines, 3 × 16-slice glow
+     *   ≥ 2 px   Reduced  10-slice discs, no core, 3 × 8-slice glow
+     *   < 2 px   Point    one 4-slice disc (a dot), 1 glow layer, no lines
+     *
+     * With the disc shader every disc is one quad anyway; there the levels
+     * only drop the extra discs and lines.
+     */
+    constexpr float FULL_DETAIL_PIXELS = 8.0f;
+    constexpr float POINT_DETAIL_PIXELS = 2.0f;
+    constexpr int REDUCED_SEGMENTS = 10;
+    constexpr int POINT_SEGMENTS = 4;
+
+    // Glows, outlines and velocity lines reach this far beyond a body's radius
+    constexpr float CULL_MARGIN = 24.0f;
+    constexpr float MIN_TRAIL_SEGMENT_PIXELS = 1.0f;  // Shorter trail pieces are merged
+
+    // Filled ellipse as a fan of Segments slices
+    template <int Segments>
+    sf::Vertex* writeFan(sf::Vertex* out, sf::Vector2f centre, sf::Vector2f radii, sf::Color colour) {
+        const auto& circle = PhysicsUtils::UNIT_CIRCLE<Segments>;
+        for (int i = 0; i < Segments; ++i) {
+            *out++ = sf::Vertex(centre, colour);
+            *out++ = sf::Vertex(centre + sf::Vector2f(circle[i].x * radii.x, circle[i].y * radii.y), colour);
+            *out++ = sf::Vertex(centre + sf::Vector2f(circle[i + 1].x * radii.x, circle[i + 1].y * radii.y), colour);
+        }
+        return out;
+    }
+
+    /**
+     * DISC SHADER
+     * The quad's texture coordinates run from (-1,-1) to (1,1), so the
+     * distance from the centre is just length(texCoord). Pixels beyond 1 are
+     * thrown away; the last pixel of the edge is faded for smooth outlines.
+     */
+    const char* DISC_FRAGMENT_SHADER = R"(
+        void main() {
+            float distance = length(gl_TexCoord[0].xy);
+            float edge = fwidth(distance);
+            float coverage = 1.0 - smoothstep(1.0 - edge, 1.0, distance);
+            if (coverage <= 0.0) discard;
+            gl_FragColor = vec4(gl_Color.rgb, gl_Color.a * coverage);
+        }
+    )";
+
+    /**
+     * SEPARABLE GAUSSIAN BLUR
+     * A 2D blur of radius r costs r² samples per pixel; blurring rows and
+     * then columns gives the same result for 2r. Sampling BETWEEN two texels
+     * lets the linear filter average them for free, so 5 reads cover 9 taps.
+     * direction = one texel along the axis being blurred.
+     */
+    const char* BLUR_FRAGMENT_SHADER = R"(
+        uniform sampler2D source;
+        uniform vec2 direction;
+        void main() {
+            vec2 uv = gl_TexCoord[0].xy;
+            vec4 sum = texture2D(source, uv) * 0.227027;
+            sum += texture2D(source, uv + direction * 1.384615) * 0.316216;
+            sum += texture2D(source, uv - direction * 1.384615) * 0.316216;
+            sum += texture2D(source, uv + direction * 3.230769) * 0.070270;
+            sum += texture2D(source, uv - direction * 3.230769) * 0.070270;
+            gl_FragColor = sum;
+        }
+    )";
+
+    constexpr unsigned GLOW_DOWNSAMPLE = 4;  // Glow texture is 1/4 of the screen per axis
+    constexpr int GLOW_BLUR_PASSES = 2;      // Horizontal + vertical, twice
+
+    // Pure addition: glow light stacks up where bodies crowd together
+    const sf::BlendMode ADDITIVE(sf::BlendMode::Factor::One, sf::BlendMode::Factor::One);
+
+    // Corners of the two triangles that make up a quad
+    constexpr std::array<sf::Vector2f, QUAD_VERTICES> QUAD_CORNERS = {{
+        {-1.f, -1.f}, {1.f, -1.f}, {1.f, 1.f},
+        {-1.f, -1.f}, {1.f, 1.f}, {-1.f, 1.f}
+    }};
+
+    sf::Color brighten(sf::Color colour, float factor, uint8_t alpha) {
+        return sf::Color(
+            static_cast<uint8_t>(std::min(255, static_cast<int>(colour.r * factor))),
+            static_cast<uint8_t>(std::min(255, static_cast<int>(colour.g * factor))),
+            static_cast<uint8_t>(std::min(255, static_cast<int>(colour.b * factor))),
+            alpha
+        );
+    }
+}
+
+PhysicsRenderer::PhysicsRenderer() {
+    setStreamingUpload(true);
+}
+
+PhysicsRenderer::Detail PhysicsRenderer::detailFor(float radiusPixels) {
+    if (radiusPixels >= FULL_DETAIL_PIXELS) return Detail::Full;
+    if (radiusPixels >= POINT_DETAIL_PIXELS) return Detail::Reduced;
+    return Detail::Point;
+}
+
+void PhysicsRenderer::setStreamingUpload(bool enabled) {
+    streamingUpload = enabled;
+    glowBatch.setStreaming(enabled);
+    trailBatch.setStreaming(enabled);
+    bodyBatch.setStreaming(enabled);
+    bodyLineBatch.setStreaming(enabled);
+    debugPointBatch.setStreaming(enabled);
+    debugLineBatch.setStreaming(enabled);
+}
+
+void PhysicsRenderer::drawBatchedGlows(sf::RenderTarget& target, const RenderState& state) {
+    constexpr int glowLayers = 3;
+    constexpr int segments = 16; // Reduced from default circle resolution for performance
+
+    sf::Vertex* out = glowBatch.begin(state.size() * glowLayers * segments * 3);
+
+    for (size_t bi = 0; bi < state.size(); ++bi) {
+        if (state.isStatic[bi]) continue;
+
+        sf::Vector2f pos = state.position[bi];
+        float radius = state.radius[bi];
+        sf::Color colour = state.colour[bi];
+        float impactIntensity = state.impactIntensity[bi];
+        bool isResting = state.isResting[bi];
+
+        // Calculate display color
+        sf::Color displayColour = isResting ?
+            sf::Color(colour.r / 2, colour.g / 2, colour.b / 2) : colour;
+
+        float flashIntensity = impactIntensity * 100.0f;
+        displayColour.r = std::min(255, static_cast<int>(displayColour.r + flashIntensity));
+        displayColour.g = std::min(255, static_cast<int>(displayColour.g + flashIntensity));
+        displayColour.b = std::min(255, static_cast<int>(displayColour.b + flashIntensity));
+
+        // Fewer slices (and for dots a single layer) once the body is small on screen
+        Detail detail = detailFor(view.toPixels(radius));
+        const sf::Vector2f* circle = detail == Detail::Full ? UNIT_CIRCLE<segments>.data()
+                                   : detail == Detail::Reduced ? UNIT_CIRCLE<segments / 2>.data()
+                                   : UNIT_CIRCLE<POINT_SEGMENTS>.data();
+        int slices = detail == Detail::Full ? segments : detail == Detail::Reduced ? segments / 2 : POINT_SEGMENTS;
+        int firstLayer = detail == Detail::Point ? 1 : glowLayers;
+
+        // Draw glow layers as triangle fans
+        for (int layer = firstLayer; layer > 0; --layer) {
+            float glowRadius = radius + (layer * 4.0f) + (impactIntensity * 5.0f);
+            float alpha = isResting ? 10.0f : 20.0f;
+            alpha = alpha / (layer + 1) + (impactIntensity * 30.0f);
+
+            sf::Color glowColor(displayColour.r, displayColour.g, displayColour.b,
+                               static_cast<uint8_t>(alpha));
+
+            // Create triangle fan for circle (points from the precomputed table)
+            for (int i = 0; i < slices; ++i) {
+                *out++ = sf::Vertex(pos, glowColor);
+                *out++ = sf::Vertex(pos + circle[i] * glowRadius, glowColor);
+                *out++ = sf::Vertex(pos + circle[i + 1] * glowRadius, glowColor);
+            }
+        }
+    }
+    glowBatch.end(out);
+
+    glowBatch.draw(target);
+    verticesSubmitted += glowBatch.getVertexCount();
+}
+
+/**
+ * Make sure both glow textures match the target's size / GLOW_DOWNSAMPLE
+ * Only reallocates when the window size changes
+ */
+bool PhysicsRenderer::prepareGlowTextures(sf::Vector2u targetSize) {
+    sf::Vector2u size(std::max(1u, targetSize.x / GLOW_DOWNSAMPLE), std::max(1u, targetSize.y / GLOW_DOWNSAMPLE));
+    if (size == glowTextureSize) return true;
+
+    for (auto& texture : glowTextures) {
+        if (!texture.resize(size)) {
+            glowTextureSize = sf::Vector2u();
+            return false;
+        }
+        texture.setSmooth(true);  // Linear filtering: the blur taps and the upscale rely on it
+    }
+    glowTextureSize = size;
+    return true;
+}
+
+/**
+ * POST-PROCESS GLOW (BLOOM)
+ * =========================
+ *
+ *   1. Draw ONE soft disc per dynamic body into a small texture
+ *      (impact flash travels in the vertex colour, like the geometry glow)
+ *   2. Blur that texture - each pass reads one texture and writes the other
+ *   3. Stretch it over the screen and ADD it to what is already there
+ *
+ *      bodies → [glow 0] ─blur x→ [glow 1] ─blur y→ [glow 0] → + screen
+ *
+ * Per body that is 6 vertices instead of 144. The blur works on
+ * (width / 4) × (height / 4) pixels however many bodies there are.
+ *
+ * @return false if shaders or render textures are unavailable (caller falls back)
+ */
+bool PhysicsRenderer::drawPostProcessGlows(sf::RenderTarget& target, const RenderState& state) {
+    if (!blurShaderReady || !prepareGlowTextures(target.getSize())) {
+        return false;
+    }
+
+    size_t discVertices = useDiscShader ? QUAD_VERTICES : FAN_VERTICES;
+    sf::Vertex* out = glowBatch.begin(state.size() * discVertices);
+    for (size_t bi = 0; bi < state.size(); ++bi) {
+        if (state.isStatic[bi]) continue;
+
+        sf::Color colour = state.colour[bi];
+        float impactIntensity = state.impactIntensity[bi];
+
+        // Dimmer when resting, brighter right after an impact (premultiplied for ADDITIVE)
+        float strength = std::min(1.0f, (state.isResting[bi] ? 0.15f : 0.3f) + impactIntensity * 0.6f);
+        sf::Color glowColour(static_cast<uint8_t>(colour.r * strength),
+                             static_cast<uint8_t>(colour.g * strength),
+                             static_cast<uint8_t>(colour.b * strength));
+
+        float glowRadius = state.radius[bi] + 6.0f + impactIntensity * 5.0f;
+        out = writeDisc(out, state.position[bi], sf::Vector2f(glowRadius, glowRadius), glowColour,
+                        detailFor(view.toPixels(glowRadius)));
+    }
+    glowBatch.end(out);
+
+    // 1. Bodies into glow texture 0, seen through the same view as the screen
+    sf::RenderStates discStates(ADDITIVE);
+    if (useDiscShader) {
+        discStates.shader = &discShader;
+    }
+    glowTextures[0].setView(target.getView());
+    glowTextures[0].clear(sf::Color::Transparent);
+    glowBatch.draw(glowTextures[0], discStates);
+    glowTextures[0].display();
+
+    // 2. Ping-pong blur in texture space
+    sf::Vector2f texel(1.0f / glowTextureSize.x, 1.0f / glowTextureSize.y);
+    sf::RenderStates blurStates(sf::BlendNone);
+    blurStates.shader = &blurShader;
+    for (int pass = 0; pass < GLOW_BLUR_PASSES * 2; ++pass) {
+        sf::RenderTexture& source = glowTextures[pass % 2];
+        sf::RenderTexture& destination = glowTextures[(pass + 1) % 2];
+
+        blurShader.setUniform("direction", pass % 2 == 0 ? sf::Vector2f(texel.x, 0.f) : sf::Vector2f(0.f, texel.y));
+        destination.setView(destination.getDefaultView());
+        destination.draw(sf::Sprite(source.getTexture()), blurStates);
+        destination.display();
+    }
+
+    // 3. Composite in screen space (an even pass count leaves the result in texture 0)
+    sf::View sceneView = target.getView();
+    target.setView(target.getDefaultView());
+    sf::Sprite glow(glowTextures[0].getTexture());
+    glow.setScale(sf::Vector2f(static_cast<float>(target.getSize().x) / glowTextureSize.x,
+                               static_cast<float>(target.getSize().y) / glowTextureSize.y));
+    target.draw(glow, sf::RenderStates(ADDITIVE));
+    target.setView(sceneView);
+
+    verticesSubmitted += glowBatch.getVertexCount() + 6 * (GLOW_BLUR_PASSES * 2 + 1);
+    return true;
+}
+
+void PhysicsRenderer::drawBatchedTrails(sf::RenderTarget& target, const RenderState& state) {
+    constexpr size_t L = RigidBody::MAX_TRAIL_LENGTH;
+
+    // Vertex count first: 2 per segment between consecutive trail points
+    // (an upper bound - segments outside the view or under a pixel are dropped below)
+    size_t segmentCount = state.trailPoints.size() - state.trails.size();
+
+    /**
+     * Alpha from age: e^(-rate × age), with age = trailTimer + k × interval.
+     * That splits into a per-body factor and a per-index factor, so the
+     * per-index part is a table and each segment costs one multiply.
+     */
+    static const std::array<float, L> FADE_BY_INDEX = [] {
+        std::array<float, L> fade{};
+        for (size_t k = 0; k < L; ++k) {
+            fade[k] = std::exp(-RigidBody::TRAIL_FADE_RATE * k * RigidBody::TRAIL_UPDATE_INTERVAL);
+        }
+        return fade;
+    }();
+
+    float minSegment = MIN_TRAIL_SEGMENT_PIXELS / view.pixelsPerUnit;
+    float minSegmentSquared = minSegment * minSegment;
+
+    sf::Vertex* out = trailBatch.begin(segmentCount * 2);
+    for (const RenderState::Trail& trail : state.trails) {
+        // Points are stored newest first (see RenderState::capture)
+        const sf::Vector2f* points = &state.trailPoints[trail.first];
+        size_t length = trail.length;
+        sf::Color trailColor = trail.colour;
+        float bodyAlpha = 150.0f * std::exp(-RigidBody::TRAIL_FADE_RATE * trail.newestAge);
+
+        size_t newer = 0;
+        for (size_t k = 1; k < length; ++k) {
+            // LOD: pieces shorter than a pixel on screen are joined to the next one
+            sf::Vector2f step = points[k] - points[newer];
+            if (k + 1 < length && step.x * step.x + step.y * step.y < minSegmentSquared) continue;
+
+            if (view.overlapsSegment(points[newer], points[k])) {
+                trailColor.a = static_cast<uint8_t>(bodyAlpha * FADE_BY_INDEX[k]);
+                *out++ = sf::Vertex(points[newer], trailColor);
+                *out++ = sf::Vertex(points[k], trailColor);
+            }
+            newer = k;
+        }
+    }
+    trailBatch.end(out);
+
+    trailBatch.draw(target);
+    verticesSubmitted += trailBatch.getVertexCount();
+}
+
+/**
+ * Try to build the shaders once a render target (and so a GL context) exists
+ * Falls back to triangle fans / geometry glows when shaders are unsupported
+ * or fail to compile
+ */
+void PhysicsRenderer::initShaders() {
+    shadersChecked = true;
+    if (!sf::Shader::isAvailable()) return;
+
+    useDiscShader = discShader.loadFromMemory(DISC_FRAGMENT_SHADER, sf::Shader::Type::Fragment);
+    blurShaderReady = blurShader.loadFromMemory(BLUR_FRAGMENT_SHADER, sf::Shader::Type::Fragment);
+    if (blurShaderReady) {
+        blurShader.setUniform("source", sf::Shader::CurrentTexture);
+    }
+}
+
+/**
+ * Write one filled ellipse starting at out
+ * @param detail - Slice count for the fan fallback (the shader quad is always 6 vertices)
+ * @return One past the last vertex written
+ */
+sf::Vertex* PhysicsRenderer::writeDisc(sf::Vertex* out, sf::Vector2f centre, sf::Vector2f radii, sf::Color colour,
+                                       Detail detail) const {
+    if (useDiscShader) {
+        for (const sf::Vector2f& corner : QUAD_CORNERS) {
+            *out++ = sf::Vertex(centre + sf::Vector2f(corner.x * radii.x, corner.y * radii.y), colour, corner);
+        }
+        return out;
+    }
+
+    switch (detail) {
+        case Detail::Full:    return writeFan<DISC_SEGMENTS>(out, centre, radii, colour);
+        case Detail::Reduced: return writeFan<REDUCED_SEGMENTS>(out, centre, radii, colour);
+        default:              return writeFan<POINT_SEGMENTS>(out, centre, radii, colour);
+    }
+}
+
+/**
+ * BATCHED BODY RENDERING
+ *
+ * Pass 1 (CPU): write every body's discs and lines into the two batches.
+ * Pass 2 (GPU): one draw for all discs, one for all lines.
+ *
+ * The batches only grow when the body count does and are overwritten in
+ * place - no per-frame allocation and no per-body draw call.
+ * Only bodies in view are written, at the detail their screen size needs.
+ */
+void PhysicsRenderer::drawBodies(sf::RenderTarget& target, const RenderState& state, bool showVelocity) {
+    size_t discVertices = useDiscShader ? QUAD_VERTICES : FAN_VERTICES;
+    sf::Vertex* out = bodyBatch.begin(state.size() * DISCS_PER_BODY * discVertices);
+    sf::Vertex* lineOut = bodyLineBatch.begin(state.size() * LINES_PER_BODY * 2);
+
+    for (size_t i = 0; i < state.size(); ++i) {
+        sf::Vector2f position = state.position[i];
+        sf::Vector2f velocity = state.velocity[i];
+        float radius = state.radius[i];
+        sf::Color colour = state.colour[i];
+        float impactIntensity = state.impactIntensity[i];
+        bool isStatic = state.isStatic[i];
+        bool isResting = state.isResting[i];
+
+        sf::Color displayColour = isResting ?
+            sf::Color(colour.r / 2, colour.g / 2, colour.b / 2) : colour;
+
+        float flashIntensity = impactIntensity * 100.0f;
+        displayColour.r = std::min(255, static_cast<int>(displayColour.r + flashIntensity));
+        displayColour.g = std::min(255, static_cast<int>(displayColour.g + flashIntensity));
+        displayColour.b = std::min(255, static_cast<int>(displayColour.b + flashIntensity));
+
+        // Glows are drawn in batched mode by drawBatchedGlows()
+
+        // A dot on screen: just the fill, no outline, core, squash or lines
+        Detail detail = detailFor(view.toPixels(radius));
+        if (detail == Detail::Point) {
+            out = writeDisc(out, position, sf::Vector2f(radius, radius), displayColour, detail);
+            continue;
+        }
+
+        sf::Vector2f scale(1.0f, 1.0f);
+        if (impactIntensity > 0.01f) {
+            float squashAmount = 1.0f - (impactIntensity * 0.3f);
+            float stretchAmount = 1.0f + (impactIntensity * 0.3f);
+
+            sf::Vector2f velocityDir = length(velocity) > 0.1f ? normalise(velocity) : sf::Vector2f(0.f, 1.f);
+            float angle = std::atan2(velocityDir.y, velocityDir.x);
+
+            scale.x = squashAmount * std::cos(angle) * std::cos(angle) + stretchAmount * std::sin(angle) * std::sin(angle);
+            scale.y = squashAmount * std::sin(angle) * std::sin(angle) + stretchAmount * std::cos(angle) * std::cos(angle);
+        }
+
+        // Outline first, fill on top - only the outer ring of the outline stays visible
+        float outlineThickness = isStatic ? 2.0f : 1.5f;
+        sf::Color outlineColour = isStatic ? sf::Color(60, 60, 70, 150)
+                                           : brighten(displayColour, 1.3f, isResting ? 100 : 200);
+        out = writeDisc(out, position, sf::Vector2f((radius + outlineThickness) * scale.x, (radius + outlineThickness) * scale.y),
+                        outlineColour, detail);
+        out = writeDisc(out, position, sf::Vector2f(radius * scale.x, radius * scale.y), displayColour, detail);
+
+        if (!isStatic && !isResting && detail == Detail::Full) {
+            float coreRadius = radius * 0.4f;
+            out = writeDisc(out, position, sf::Vector2f(coreRadius, coreRadius), brighten(displayColour, 1.5f, 180));
+        }
+
+        if (!isStatic && std::abs(state.angularVelocity[i]) > 0.1f) {
+            sf::Vector2f lineEnd = position + rotate(sf::Vector2f(radius, 0.f), state.rotation[i]);
+            *lineOut++ = sf::Vertex(position, sf::Color(255, 255, 255, 150));
+            *lineOut++ = sf::Vertex(lineEnd, sf::Color(255, 255, 255, 150));
+        }
+
+        if (showVelocity && !isStatic && !isResting && length(velocity) > 1.f) {
+            sf::Vector2f lineEnd = position + normalise(velocity) * (radius * 2.0f);
+            *lineOut++ = sf::Vertex(position, sf::Color(255, 255, 0, 200));
+            *lineOut++ = sf::Vertex(lineEnd, sf::Color(255, 255, 0, 200));
+        }
+    }
+
+    bodyBatch.end(out);
+    bodyLineBatch.end(lineOut);
+
+    sf::RenderStates states;
+    if (useDiscShader) {
+        states.shader = &discShader;
+    }
+    bodyBatch.draw(target, states);
+    bodyLineBatch.draw(target);
+    verticesSubmitted += bodyBatch.getVertexCount() + bodyLineBatch.getVertexCount();
+}
+
+/**
+ * BATCHED DEBUG VIEW
+ * The engine recorded points and lines into the state's list; every point becomes a
+ * small 8-slice fan in one batch, every line goes into another.
+ * However many contacts there are, that is two draw calls.
+ */
+void PhysicsRenderer::drawDebug(sf::RenderTarget& target, const RenderState& state) {
+    constexpr int pointSegments = 8;
+    const auto& circle = UNIT_CIRCLE<pointSegments>;
+
+    const auto& points = state.debugList.getPoints();
+    sf::Vertex* out = debugPointBatch.begin(points.size() * pointSegments * 3);
+    for (const DebugDrawList::Point& point : points) {
+        for (int i = 0; i < pointSegments; ++i) {
+            *out++ = sf::Vertex(point.position, point.colour);
+            *out++ = sf::Vertex(point.position + circle[i] * point.radius, point.colour);
+            *out++ = sf::Vertex(point.position + circle[i + 1] * point.radius, point.colour);
+        }
+    }
+    debugPointBatch.end(out);
+
+    const auto& lines = state.debugList.getLines();
+    out = debugLineBatch.begin(lines.size() * 2);
+    for (const DebugDrawList::Line& line : lines) {
+        *out++ = sf::Vertex(line.from, line.colour);
+        *out++ = sf::Vertex(line.to, line.colour);
+    }
+    debugLineBatch.end(out);
+
+    debugPointBatch.draw(target);
+    debugLineBatch.draw(target);
+    verticesSubmitted += debugPointBatch.getVertexCount() + debugLineBatch.getVertexCount();
+}
+
+RenderRequest PhysicsRenderer::makeRequest(const sf::RenderTarget& target, bool showTrails, bool showDebug) const {
+    RenderRequest request;
+    request.view = ViewRegion::fromTarget(target).inflated(CULL_MARGIN);
+    request.trails = showTrails;
+    request.debug = showDebug;
+    request.debugCategories = debugCategories;
+    return request;
+}
+
+void PhysicsRenderer::draw(sf::RenderTarget& target, const PhysicsEngine& physics,
+                           bool showVelocity, bool showTrails, bool showDebug) {
+    // FRUSTUM CULLING: the capture asks the engine's grid for what the view
+    // can see, once per frame; every body layer walks only that copy
+    {
+        ScopedTimer timer(profiler, ProfilePhase::Capture);
+        capturedState.capture(physics, makeRequest(target, showTrails, showDebug));
+    }
+    draw(target, capturedState, showVelocity, showTrails, showDebug);
+}
+
+void PhysicsRenderer::draw(sf::RenderTarget& target, const RenderState& state,
+                           bool showVelocity, bool showTrails, bool showDebug) {
+    verticesSubmitted = 0;
+    if (!shadersChecked) {
+        initShaders();
+    }
+
+    // This frame's view drives level of detail and trail/particle culling
+    view = ViewRegion::fromTarget(target);
+
+    // Draw glows first (background layer)
+    {
+        ScopedTimer timer(profiler, ProfilePhase::DrawGlows);
+        bool drawn = glowMode == GlowMode::PostProcess && drawPostProcessGlows(target, state);
+        if (!drawn) {
+            drawBatchedGlows(target, state);
+        }
+    }
+
+    // Draw batched trails
+    if (showTrails) {
+        ScopedTimer timer(profiler, ProfilePhase::DrawTrails);
+        drawBatchedTrails(target, state);
+    }
+
+    // Draw particles (will be optimized separately)
+    {
+        ScopedTimer timer(profiler, ProfilePhase::DrawParticles);
+        state.particles.draw(target, view, streamingUpload);
+        verticesSubmitted += state.particles.getVertexCount();
+    }
+
+    // Draw bodies (main shapes, cores, rotation indicators)
+    {
+        ScopedTimer timer(profiler, ProfilePhase::DrawBodies);
+        drawBodies(target, state, showVelocity);
+    }
+
+    // Draw debug visualizations (only if the state was captured with them)
+    if (showDebug && state.hasDebug) {
+        ScopedTimer timer(profiler, ProfilePhase::DrawDebug);
+        drawDebug(target, state);
+    }
+
+    if (profiler) {
+        profiler->setCounter(ProfileCounter::VerticesSubmitted, verticesSubmitted);
+    }
+}
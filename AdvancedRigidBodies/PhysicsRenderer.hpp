@@ -0,0 +1,145 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "PhysicsEngine.hpp"
+#include "Profiler.hpp"
+#include "RenderState.hpp"
+#include "VertexBatch.hpp"
+#include "ViewRegion.hpp"
+
+/**
+ * PHYSICS RENDERER - DRAWING KEPT OUT OF THE SIMULATION
+ * =====================================================
+ *
+ * PhysicsEngine only simulates. Everything that needs a render target lives
+ * here, drawing a RenderState copied out of the engine (RenderState::capture).
+ * Drawing from a copy means the engine can already be stepping the next
+ * frame on another thread while this one is drawn (see SimulationThread).
+ *
+ * WHY SEPARATE?
+ * - The engine can run with no window at all (benchmarks, build servers,
+ *   servers simulating for networked clients)
+ * - Drawing can never accidentally change the simulation
+ * - sf::RenderTarget covers both windows and off-screen RenderTextures
+ *
+ * The renderer owns its vertex batches so their memory is reused every frame
+ * (see VertexBatch).
+ *
+ * BATCHED BODIES:
+ * Drawing one sf::CircleShape per body costs a tessellation and a draw call
+ * (two with the core, three with the rotation line). At 10k bodies that is
+ * 30k draw calls - the GPU sits idle while the CPU feeds it.
+ * Instead every body is written as up to three discs into ONE vertex array:
+ *
+ *   outline disc (radius + outline)  →  fill disc (radius)  →  core disc (0.4 × radius)
+ *
+ * Each disc is drawn over the previous one, so the outline only shows as a
+ * ring round the fill. With shaders available a disc is a single quad
+ * (6 vertices) that a fragment shader trims to a circle; without them it
+ * falls back to a 30-triangle fan. With streaming upload on, the whole
+ * array goes through a persistent sf::VertexBuffer and is drawn with one
+ * call, the lines with another.
+ *
+ * GLOW MODES:
+ * - Geometry:    three alpha-blended triangle fans per body (144 vertices of
+ *                overdraw each) - cost grows with the body count
+ * - PostProcess: one soft disc per body into a quarter-size RenderTexture,
+ *                blurred on the GPU and added over the scene - cost grows
+ *                with the screen size instead (see drawPostProcessGlows())
+ *
+ * CULLING AND LEVEL OF DETAIL:
+ * The target's view decides what is drawn. Bodies are captured from the
+ * engine's spatial grid for the visible rectangle only, trail segments and
+ * particles outside it are skipped, and bodies that are only a few pixels
+ * across on screen get fewer slices, then collapse to a single dot.
+ */
+class PhysicsRenderer {
+public:
+    enum class GlowMode {
+        Geometry,
+        PostProcess
+    };
+
+    PhysicsRenderer();
+
+    // Capture the engine's state for the target's view, then draw it (same thread)
+    void draw(sf::RenderTarget& target, const PhysicsEngine& physics,
+              bool showVelocity, bool showTrails, bool showDebug);
+
+    // Draw a state captured elsewhere (debug only shows if it was captured with it)
+    void draw(sf::RenderTarget& target, const RenderState& state,
+              bool showVelocity, bool showTrails, bool showDebug);
+
+    /**
+     * What a capture for this target should contain: bodies in its view
+     * (padded for culling), trails and debug layers if they will be shown
+     */
+    RenderRequest makeRequest(const sf::RenderTarget& target, bool showTrails, bool showDebug) const;
+
+    // Time each draw stage and count submitted vertices (nullptr = off, not owned)
+    void setProfiler(Profiler* newProfiler) { profiler = newProfiler; }
+
+    /**
+     * Upload batches through persistent streaming sf::VertexBuffers (default on)
+     * Off = hand the vertex pointer straight to each draw call
+     */
+    void setStreamingUpload(bool enabled);
+    bool isStreamingUpload() const { return streamingUpload; }
+
+    /**
+     * Choose how glows are drawn (default Geometry)
+     * PostProcess quietly falls back to Geometry on hardware without shaders
+     * or render textures
+     */
+    void setGlowMode(GlowMode mode) { glowMode = mode; }
+    GlowMode getGlowMode() const { return glowMode; }
+
+    // Debug layers shown when showDebug is on (the engine needs setDebugCapture(true) for contacts)
+    void setDebugCategories(const DebugCategories& categories) { debugCategories = categories; }
+    const DebugCategories& getDebugCategories() const { return debugCategories; }
+
+private:
+    void drawBatchedGlows(sf::RenderTarget& target, const RenderState& state);
+    bool drawPostProcessGlows(sf::RenderTarget& target, const RenderState& state);
+    bool prepareGlowTextures(sf::Vector2u targetSize);
+    void drawBatchedTrails(sf::RenderTarget& target, const RenderState& state);
+    void drawBodies(sf::RenderTarget& target, const RenderState& state, bool showVelocity);
+    void drawDebug(sf::RenderTarget& target, const RenderState& state);
+
+    void initShaders();
+    // Level of detail from a radius in screen pixels (thresholds in the .cpp)
+    enum class Detail { Full, Reduced, Point };
+    static Detail detailFor(float radiusPixels);
+    sf::Vertex* writeDisc(sf::Vertex* out, sf::Vector2f centre, sf::Vector2f radii, sf::Color colour,
+                          Detail detail = Detail::Full) const;
+
+    // This frame's view, and the copy draw(target, physics, ...) captures into
+    ViewRegion view;
+    RenderState capturedState;
+
+    // Batches for each layer (storage persists between frames)
+    VertexBatch glowBatch{sf::PrimitiveType::Triangles};
+    VertexBatch trailBatch{sf::PrimitiveType::Lines};
+    VertexBatch bodyBatch{sf::PrimitiveType::Triangles};
+    VertexBatch bodyLineBatch{sf::PrimitiveType::Lines};
+
+    // Debug view: commands recorded into the state, flushed as one batch per primitive type
+    DebugCategories debugCategories;
+    VertexBatch debugPointBatch{sf::PrimitiveType::Triangles};
+    VertexBatch debugLineBatch{sf::PrimitiveType::Lines};
+    bool streamingUpload = true;
+
+    // Fragment shader turning each body quad into a circle (created on first draw)
+    sf::Shader discShader;
+    bool shadersChecked = false;
+    bool useDiscShader = false;
+
+    // Post-process glow: two low-resolution targets blurred back and forth
+    GlowMode glowMode = GlowMode::Geometry;
+    sf::Shader blurShader;
+    bool blurShaderReady = false;
+    sf::RenderTexture glowTextures[2];
+    sf::Vector2u glowTextureSize;
+
+    Profiler* profiler = nullptr;
+    size_t verticesSubmitted = 0;
+};
@@ -0,0 +1,177 @@
+#include "Profiler.hpp"
+#include <algorithm>
+#include <fstream>
+
+Profiler::Profiler()
+    : epoch(std::chrono::steady_clock::now()), history(HISTORY_SIZE) {
+}
+
+double Profiler::nowMicros() const {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void Profiler::beginFrame() {
+    // Reset in place - the Frame (and its event array) is reused, never reallocated
+    current.frameNumber = nextFrameNumber++;
+    current.startMicros = nowMicros();
+    current.durationMicros = 0.0;
+    current.phaseMicros.fill(0.0);
+    current.counters.fill(0);
+    current.eventCount = 0;
+}
+
+void Profiler::endFrame() {
+    current.durationMicros = nowMicros() - current.startMicros;
+
+    history[writeIndex] = current;
+    writeIndex = (writeIndex + 1) % HISTORY_SIZE;
+    frameCount = std::min(frameCount + 1, HISTORY_SIZE);
+}
+
+void Profiler::addPhaseTime(ProfilePhase phase, double startMicros, double endMicros) {
+    double duration = endMicros - startMicros;
+    current.phaseMicros[static_cast<size_t>(phase)] += duration;
+
+    // Totals are always kept; individual events only while there's room
+    if (current.eventCount < MAX_EVENTS_PER_FRAME) {
+        current.events[current.eventCount++] = {phase, startMicros, duration};
+    }
+}
+
+const Profiler::Frame& Profiler::getFrame(size_t age) const {
+    // writeIndex points one past the newest frame
+    size_t index = (writeIndex + HISTORY_SIZE - 1 - (age % HISTORY_SIZE)) % HISTORY_SIZE;
+    return history[index];
+}
+
+double Profiler::getAveragePhaseMs(ProfilePhase phase, size_t frames) const {
+    size_t count = std::min(frames, frameCount);
+    if (count == 0) return 0.0;
+
+    double total = 0.0;
+    for (size_t age = 0; age < count; ++age) {
+        total += getFrame(age).phaseMicros[static_cast<size_t>(phase)];
+    }
+    return total / count / 1000.0;
+}
+
+double Profiler::getAverageFrameMs(size_t frames) const {
+    size_t count = std::min(frames, frameCount);
+    if (count == 0) return 0.0;
+
+    double total = 0.0;
+    for (size_t age = 0; age < count; ++age) {
+        total += getFrame(age).durationMicros;
+    }
+    return total / count / 1000.0;
+}
+
+/**
+ * CSV: oldest frame first, times in milliseconds
+ *   frame,frame_ms,integrate_ms,...,candidate_pairs,...
+ */
+bool Profiler::exportCSV(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) return false;
+
+    file << "frame,frame_ms";
+    for (size_t p = 0; p < PHASE_COUNT; ++p) {
+        file << ',' << getPhaseName(static_cast<ProfilePhase>(p)) << "_ms";
+    }
+    for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+        file << ',' << getCounterName(static_cast<ProfileCounter>(c));
+    }
+    file << '\n';
+
+    for (size_t age = frameCount; age-- > 0;) {
+        const Frame& frame = getFrame(age);
+        file << frame.frameNumber << ',' << frame.durationMicros / 1000.0;
+        for (double micros : frame.phaseMicros) {
+            file << ',' << micros / 1000.0;
+        }
+        for (uint64_t value : frame.counters) {
+            file << ',' << value;
+        }
+        file << '\n';
+    }
+    return static_cast<bool>(file);
+}
+
+/**
+ * CHROME TRACE FORMAT
+ * A JSON array of events; "X" = complete event with start (ts) and duration
+ * (dur) in microseconds, "C" = counter track. Load the file in
+ * chrome://tracing or https://ui.perfetto.dev
+ */
+bool Profiler::exportChromeTrace(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) return false;
+
+    file << "{\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&] {
+        if (!first) file << ",\n";
+        first = false;
+    };
+
+    for (size_t age = frameCount; age-- > 0;) {
+        const Frame& frame = getFrame(age);
+
+        separator();
+        file << "{\"name\":\"Frame " << frame.frameNumber << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+             << ",\"ts\":" << frame.startMicros << ",\"dur\":" << frame.durationMicros << '}';
+
+        for (size_t e = 0; e < frame.eventCount; ++e) {
+            const Event& event = frame.events[e];
+            separator();
+            file << "{\"name\":\"" << getPhaseName(event.phase) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+                 << ",\"ts\":" << event.startMicros << ",\"dur\":" << event.durationMicros << '}';
+        }
+
+        for (size_t c = 0; c < COUNTER_COUNT; ++c) {
+            separator();
+            file << "{\"name\":\"" << getCounterName(static_cast<ProfileCounter>(c)) << "\",\"ph\":\"C\",\"pid\":1"
+                 << ",\"ts\":" << frame.startMicros << ",\"args\":{\"value\":" << frame.counters[c] << "}}";
+        }
+    }
+
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
+
+const char* Profiler::getPhaseName(ProfilePhase phase) {
+    switch (phase) {
+        case ProfilePhase::Effects:        return "effects";
+        case ProfilePhase::Integrate:      return "integrate";
+        case ProfilePhase::GridRebuild:    return "grid_rebuild";
+        case ProfilePhase::PairGeneration: return "pair_generation";
+        case ProfilePhase::Continuous:     return "continuous";
+        case ProfilePhase::NarrowPhase:    return "narrow_phase";
+        case ProfilePhase::Solve:          return "solve";
+        case ProfilePhase::Islands:        return "islands";
+        case ProfilePhase::Record:         return "record";
+        case ProfilePhase::Capture:        return "capture";
+        case ProfilePhase::DrawGlows:      return "draw_glows";
+        case ProfilePhase::DrawTrails:     return "draw_trails";
+        case ProfilePhase::DrawParticles:  return "draw_particles";
+        case ProfilePhase::DrawBodies:     return "draw_bodies";
+        case ProfilePhase::DrawDebug:      return "draw_debug";
+        default:                           return "unknown";
+    }
+}
+
+const char* Profiler::getCounterName(ProfileCounter counter) {
+    switch (counter) {
+        case ProfileCounter::CandidatePairs:    return "candidate_pairs";
+        case ProfileCounter::Contacts:          return "contacts";
+        case ProfileCounter::GridMoves:         return "grid_moves";
+        case ProfileCounter::FastBodies:        return "fast_bodies";
+        case ProfileCounter::SleepingBodies:    return "sleeping_bodies";
+        case ProfileCounter::SleepingIslands:   return "sleeping_islands";
+        case ProfileCounter::ParticlesAlive:    return "particles_alive";
+        case ProfileCounter::ImpactEvents:      return "impact_events";
+        case ProfileCounter::ImpactBursts:      return "impact_bursts";
+        case ProfileCounter::VerticesSubmitted: return "vertices_submitted";
+        default:                                return "unknown";
+    }
+}
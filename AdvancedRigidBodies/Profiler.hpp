@@ -0,0 +1,161 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * FRAME PROFILER - WHERE DID THE TIME GO?
+ * =======================================
+ *
+ * FPS tells you THAT a frame was slow, not WHY. The profiler times each stage
+ * of the frame separately, so a slow frame can be blamed on the right code:
+ *
+ *   frame 812:  integrate 0.2ms | grid 0.4ms | pairs 1.1ms | solve 6.3ms | ...
+ *                                                            ^^^^^ culprit
+ *
+ * HOW IT WORKS:
+ * - A ScopedTimer is created at the top of a stage and measures until the
+ *   end of that scope (RAII - it can't forget to stop)
+ * - Times and counters go into the CURRENT frame
+ * - Finished frames are kept in a ring buffer of the last HISTORY_SIZE frames:
+ *
+ *   [f0][f1][f2]...[f239]   writeIndex wraps around, oldest frame overwritten
+ *
+ * The buffer is allocated once, so profiling doesn't allocate while running.
+ *
+ * EXPORT:
+ * - CSV: one row per frame, one column per phase/counter (spreadsheets, plots)
+ * - Chrome trace JSON: open in chrome://tracing or ui.perfetto.dev to see
+ *   every timed scope on a timeline
+ */
+
+enum class ProfilePhase : uint8_t {
+    Effects,         // Trails, flashes, particles
+    Integrate,
+    GridRebuild,
+    PairGeneration,
+    Continuous,      // Fast-body sweeps and time of impact
+    NarrowPhase,     // Contact generation
+    Solve,           // Prepare, warm start, velocity and position iterations
+    Islands,         // Contact islands and sleeping
+    Record,          // Trajectory recorder encoding (the disk writes are on its own thread)
+    Capture,         // Copying the engine's state out for drawing (RenderState)
+    DrawGlows,
+    DrawTrails,
+    DrawParticles,
+    DrawBodies,
+    DrawDebug,
+    Count
+};
+
+enum class ProfileCounter : uint8_t {
+    CandidatePairs,
+    Contacts,
+    GridMoves,
+    FastBodies,
+    SleepingBodies,
+    SleepingIslands,
+    ParticlesAlive,
+    ImpactEvents,
+    ImpactBursts,
+    VerticesSubmitted,
+    Count
+};
+
+class Profiler {
+public:
+    static constexpr size_t PHASE_COUNT = static_cast<size_t>(ProfilePhase::Count);
+    static constexpr size_t COUNTER_COUNT = static_cast<size_t>(ProfileCounter::Count);
+    static constexpr size_t HISTORY_SIZE = 240;        // 4 seconds at 60 FPS
+    static constexpr size_t MAX_EVENTS_PER_FRAME = 96;  // Enough for 8 fixed steps + drawing
+
+    /**
+     * One timed scope, for the Chrome trace timeline
+     * Times are microseconds since the profiler was created
+     */
+    struct Event {
+        ProfilePhase phase;
+        double startMicros;
+        double durationMicros;
+    };
+
+    struct Frame {
+        uint64_t frameNumber = 0;
+        double startMicros = 0.0;
+        double durationMicros = 0.0;
+        std::array<double, PHASE_COUNT> phaseMicros{};   // Summed over all scopes this frame
+        std::array<uint64_t, COUNTER_COUNT> counters{};
+        std::array<Event, MAX_EVENTS_PER_FRAME> events{};
+        size_t eventCount = 0;
+    };
+
+    Profiler();
+
+    void beginFrame();
+    void endFrame();
+
+    // Called by ScopedTimer
+    void addPhaseTime(ProfilePhase phase, double startMicros, double endMicros);
+
+    void setCounter(ProfileCounter counter, uint64_t value) { current.counters[static_cast<size_t>(counter)] = value; }
+    void addCounter(ProfileCounter counter, uint64_t value) { current.counters[static_cast<size_t>(counter)] += value; }
+
+    double nowMicros() const;
+
+    /**
+     * Finished frames, newest first
+     * @param age - 0 = last finished frame, 1 = the one before, ...
+     */
+    const Frame& getFrame(size_t age) const;
+    size_t getFrameCount() const { return frameCount; }
+
+    // Averages over the last `frames` finished frames (milliseconds)
+    double getAveragePhaseMs(ProfilePhase phase, size_t frames = 60) const;
+    double getAverageFrameMs(size_t frames = 60) const;
+
+    bool exportCSV(const std::string& path) const;
+    bool exportChromeTrace(const std::string& path) const;
+
+    static const char* getPhaseName(ProfilePhase phase);
+    static const char* getCounterName(ProfileCounter counter);
+
+private:
+    std::chrono::steady_clock::time_point epoch;
+    std::vector<Frame> history;   // Ring buffer, HISTORY_SIZE entries
+    size_t writeIndex = 0;        // Where the next finished frame goes
+    size_t frameCount = 0;        // Finished frames stored (max HISTORY_SIZE)
+    uint64_t nextFrameNumber = 0;
+    Frame current;
+};
+
+/**
+ * RAII TIMER
+ * Times from construction to the end of the enclosing scope.
+ * A null profiler makes it a no-op, so engine code can always create one.
+ *
+ *   {
+ *       ScopedTimer timer(profiler, ProfilePhase::Integrate);
+ *       integrateBodies(dt);
+ *   }   // ← time recorded here
+ */
+class ScopedTimer {
+public:
+    ScopedTimer(Profiler* profiler, ProfilePhase phase)
+        : profiler(profiler), phase(phase), startMicros(profiler ? profiler->nowMicros() : 0.0) {}
+
+    ~ScopedTimer() {
+        if (profiler) {
+            profiler->addPhaseTime(phase, startMicros, profiler->nowMicros());
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Profiler* profiler;
+    ProfilePhase phase;
+    double startMicros;
+};
@@ -0,0 +1,62 @@
+#include "RenderState.hpp"
+#include "PhysicsEngine.hpp"
+
+void RenderState::capture(const PhysicsEngine& physics, const RenderRequest& request) {
+    const BodyStore& b = physics.getBodies();
+    float blend = physics.getInterpolationAlpha();  // Baked in: the copy is drawn as it is
+
+    physics.queryBodiesInRect(request.view.min, request.view.max, visibleScratch);
+    size_t count = visibleScratch.size();
+    position.resize(count);
+    rotation.resize(count);
+    velocity.resize(count);
+    angularVelocity.resize(count);
+    radius.resize(count);
+    colour.resize(count);
+    impactIntensity.resize(count);
+    isStatic.resize(count);
+    isResting.resize(count);
+
+    for (size_t k = 0; k < count; ++k) {
+        uint32_t i = visibleScratch[k];
+        position[k] = b.getInterpolatedPosition(i, blend);
+        rotation[k] = b.getInterpolatedRotation(i, blend);
+        velocity[k] = b.getVelocity(i);
+        angularVelocity[k] = b.angularVelocity[i];
+        radius[k] = b.radius[i];
+        colour[k] = b.colour[i];
+        impactIntensity[k] = b.impactIntensity[i];
+        isStatic[k] = b.isStatic[i];
+        isResting[k] = b.isResting[i];
+    }
+
+    // Trails: unroll each ring newest → oldest so the renderer reads them in order
+    trails.clear();
+    trailPoints.clear();
+    if (request.trails) {
+        constexpr size_t L = RigidBody::MAX_TRAIL_LENGTH;
+        for (size_t i = 0; i < b.size(); ++i) {
+            size_t length = b.trailLength[i];
+            if (length < 2) continue;
+
+            trails.push_back({static_cast<uint32_t>(trailPoints.size()), static_cast<uint32_t>(length),
+                              b.colour[i], b.trailAge(i, 0)});
+            const sf::Vector2f* ring = b.trailRing(i);
+            size_t slot = b.trailHead[i];
+            for (size_t k = 0; k < length; ++k) {
+                trailPoints.push_back(ring[slot]);
+                slot = slot == 0 ? L - 1 : slot - 1;
+            }
+        }
+    }
+
+    particles.copyAliveFrom(physics.getParticleSystem());
+
+    debugList.clear();
+    hasDebug = request.debug;
+    if (hasDebug) {
+        physics.fillDebugDraw(debugList, request.debugCategories);
+    }
+
+    dynamicBodyCount = physics.getDynamicBodyCount();
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <vector>
+#include "DebugDraw.hpp"
+#include "ParticleSystem.hpp"
+#include "ViewRegion.hpp"
+
+class PhysicsEngine;
+
+/**
+ * What the next capture should contain (filled in by whoever draws)
+ */
+struct RenderRequest {
+    ViewRegion view;               // Bodies overlapping this region are copied (pad it for culling)
+    bool trails = true;            // Copy motion trails
+    bool debug = false;            // Record the engine's debug layers
+    DebugCategories debugCategories;
+};
+
+/**
+ * RENDER STATE - EVERYTHING ONE FRAME DRAWS, COPIED OUT OF THE ENGINE
+ * ===================================================================
+ *
+ * PhysicsRenderer never reads the engine directly; it draws a RenderState.
+ * capture() copies just what drawing needs, so once it returns the engine
+ * is free to step again while the copy is drawn:
+ *
+ *   sim:    [step N ][capture N][step N+1 ][capture N+1] ...
+ *   draw:              [draw N                ][draw N+1  ] ...
+ *
+ * (see SimulationThread, which runs the top row on its own thread)
+ *
+ * WHAT IS COPIED:
+ * - Bodies in the requested region only, already interpolated between the
+ *   previous and current step - the renderer needs no alpha and no grid
+ * - Trails of every body (a trail can be on screen when its body is not),
+ *   flattened newest point first so drawing walks one array
+ * - Alive particles and, when asked, this step's debug primitives
+ *
+ * Every array is cleared and refilled in place, so after the first few
+ * captures a RenderState never allocates.
+ */
+class RenderState {
+public:
+    // One body's trail: `length` points from trailPoints[first], newest first
+    struct Trail {
+        uint32_t first;
+        uint32_t length;
+        sf::Color colour;
+        float newestAge;   // Seconds since the newest point was recorded (see BodyStore::trailAge)
+    };
+
+    /**
+     * Replace the contents with the engine's current state
+     * Reads the engine only - must not run while it is stepping
+     */
+    void capture(const PhysicsEngine& physics, const RenderRequest& request);
+
+    size_t size() const { return position.size(); }
+
+    // Bodies inside the requested region (parallel arrays, ascending engine index order)
+    std::vector<sf::Vector2f> position;   // Interpolated
+    std::vector<float> rotation;          // Interpolated
+    std::vector<sf::Vector2f> velocity;
+    std::vector<float> angularVelocity;
+    std::vector<float> radius;
+    std::vector<sf::Color> colour;
+    std::vector<float> impactIntensity;
+    std::vector<uint8_t> isStatic;
+    std::vector<uint8_t> isResting;
+
+    std::vector<Trail> trails;
+    std::vector<sf::Vector2f> trailPoints;
+
+    ParticleSystem particles{0};   // Alive particles only - drawn, never updated
+    DebugDrawList debugList;       // Empty unless the request asked for debug
+    bool hasDebug = false;
+
+    size_t dynamicBodyCount = 0;   // All dynamic bodies, not just the visible ones
+
+private:
+    std::vector<uint32_t> visibleScratch;  // Engine indices from the grid query
+};
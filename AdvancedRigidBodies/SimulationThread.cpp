@@ -0,0 +1,76 @@
+#include "SimulationThread.hpp"
+#include <utility>
+
+SimulationThread::SimulationThread(PhysicsEngine& physics, Profiler* profiler)
+    : physics(physics), profiler(profiler), thread([this] { run(); }) {
+}
+
+SimulationThread::~SimulationThread() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+}
+
+void SimulationThread::post(Command command) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pendingCommands.push_back(std::move(command));
+}
+
+void SimulationThread::advance(float frameTime, const RenderRequest& request) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pendingTime += frameTime;
+        pendingRequest = request;
+        framePending = true;
+    }
+    wake.notify_one();
+}
+
+const RenderState& SimulationThread::acquire() {
+    // Only swap when the sim has published since our last swap
+    if (middle.load(std::memory_order_relaxed) & FRESH) {
+        frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+    return states[frontIndex];
+}
+
+void SimulationThread::run() {
+    std::vector<Command> commands;  // Swapped with pendingCommands, so both keep their capacity
+    RenderRequest request;
+
+    for (;;) {
+        float frameTime;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return framePending || stopping; });
+            if (stopping) return;
+
+            commands.swap(pendingCommands);
+            frameTime = pendingTime;
+            request = pendingRequest;
+            pendingTime = 0.0f;
+            framePending = false;
+        }
+
+        if (profiler) profiler->beginFrame();
+
+        for (Command& command : commands) {
+            command(physics);
+        }
+        commands.clear();
+
+        physics.update(frameTime);
+
+        {
+            ScopedTimer timer(profiler, ProfilePhase::Capture);
+            states[backIndex].capture(physics, request);
+        }
+        // Publish: the finished state becomes the middle, the old middle our next back buffer
+        backIndex = middle.exchange(backIndex | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+
+        if (profiler) profiler->endFrame();
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "PhysicsEngine.hpp"
+#include "RenderState.hpp"
+
+/**
+ * SIMULATION THREAD - STEP THE NEXT FRAME WHILE THIS ONE IS DRAWN
+ * ===============================================================
+ *
+ * Single-threaded, a frame is physics THEN drawing, and each waits for the
+ * other. Here the engine lives on its own thread and the two overlap:
+ *
+ *   render:  [input][advance N+1][draw N    ][display] [input][advance N+2][draw N+1 ] ...
+ *   sim:                         [step N+1][capture]                       [step N+2][capture] ...
+ *
+ * A frame costs max(step, draw) instead of step + draw, for one frame of
+ * extra latency (what is drawn is the previous frame's result).
+ *
+ * TRIPLE-BUFFERED STATE (lock-free):
+ * Three RenderStates - one the sim thread writes, one the render thread
+ * draws, and one in the middle holding the newest finished capture:
+ *
+ *   sim:  capture into [back] → swap back ⇄ middle (marked fresh)
+ *   draw: if middle is fresh  → swap front ⇄ middle, draw [front]
+ *
+ * Each swap is one atomic exchange of a small index, so neither side ever
+ * waits for the other: a slow draw just skips captures, a slow step just
+ * means the same state is drawn again.
+ *
+ * COMMAND QUEUE:
+ * The render thread never touches the engine. Anything that changes it
+ * (UI sliders, mouse drags, keys) is posted as a command and runs on the
+ * sim thread before its next update, in the order it was posted. Commands
+ * take a short lock; they arrive a few per frame, not per body.
+ *
+ * A Profiler is single-threaded, so the engine's profiler (if any) must not
+ * be the one the renderer writes to. Pass it here and each sim frame is
+ * begun and ended on it.
+ */
+class SimulationThread {
+public:
+    using Command = std::function<void(PhysicsEngine&)>;
+
+    /**
+     * Starts the thread; from now on only the commands below may use physics
+     * @param profiler - The engine's profiler (nullptr = none, not owned)
+     */
+    explicit SimulationThread(PhysicsEngine& physics, Profiler* profiler = nullptr);
+    ~SimulationThread();
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // Run command on the sim thread before its next update
+    void post(Command command);
+
+    /**
+     * Hand over one rendered frame: the sim thread runs the posted commands,
+     * updates by frameTime and captures what request asks for.
+     * Never waits - if the last frame is still being stepped, the time adds up
+     * and the newest request wins.
+     * The capture is drawn a frame later, so pad request.view for camera moves.
+     */
+    void advance(float frameTime, const RenderRequest& request);
+
+    /**
+     * Newest finished state (empty until the first capture)
+     * It stays valid and unchanged until the next acquire() - render thread only
+     */
+    const RenderState& acquire();
+
+private:
+    void run();
+
+    PhysicsEngine& physics;
+    Profiler* profiler;
+
+    // Handed over under the lock
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<Command> pendingCommands;
+    float pendingTime = 0.0f;
+    RenderRequest pendingRequest;
+    bool framePending = false;
+    bool stopping = false;
+
+    // Triple buffer: the middle index (plus FRESH once the sim has written it) is shared
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t FRESH = 0x4;
+    RenderState states[3];
+    std::atomic<uint8_t> middle{1};
+    uint8_t backIndex = 0;   // Sim thread only
+    uint8_t frontIndex = 2;  // Render thread only
+
+    std::thread thread;  // Last, so it starts after everything above exists
+};
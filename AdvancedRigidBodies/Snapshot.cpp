@@ -0,0 +1,42 @@
+#include "Snapshot.hpp"
+#include <fstream>
+
+void SnapshotWriter::append(const void* data, size_t size) {
+    const char* p = static_cast<const char*>(data);
+    bytes.insert(bytes.end(), p, p + size);
+}
+
+bool SnapshotWriter::saveToFile(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    return static_cast<bool>(file);
+}
+
+bool SnapshotReader::loadFromFile(const std::string& path) {
+    bytes.clear();
+    cursor = 0;
+    failed = true;
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+
+    std::streamsize size = file.tellg();
+    if (size < 0) return false;
+    bytes.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    if (!file.read(bytes.data(), size)) return false;
+
+    failed = false;
+    return true;
+}
+
+bool SnapshotReader::take(void* out, size_t size) {
+    if (size == 0) return !failed;
+    if (failed || size > bytes.size() - cursor) {
+        failed = true;
+        return false;
+    }
+    std::memcpy(out, bytes.data() + cursor, size);
+    cursor += size;
+    return true;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * BINARY SNAPSHOTS - SAVE A WORLD, LOAD IT BACK INSTANTLY
+ * =======================================================
+ *
+ * PROBLEM: Settling a 20k-body pile takes thousands of steps. Benchmarks
+ * and scene presets that need a settled pile shouldn't have to simulate it
+ * again every run.
+ *
+ * SOLUTION: Write the SoA arrays out exactly as they sit in memory.
+ *
+ *   file:  [header][positionX: x0 x1 x2 ...][positionY: y0 y1 ...] ...
+ *
+ * Each array is one block of raw bytes, so:
+ * - saving is one write per array, with no per-body formatting
+ * - loading reads the whole file in one go, then each array is resized and
+ *   filled by ONE memcpy - no parsing, no per-body work
+ * - the file is about as big as the state itself (~75 bytes per body,
+ *   plus 16 per contact for the warm-start impulses)
+ *
+ * The blocks are copied out of the read buffer rather than used in place:
+ * BodyStore owns its arrays as std::vectors, and keeping them that way
+ * costs one memcpy per array - a few hundred microseconds for 20k bodies.
+ *
+ * PORTABILITY: Raw bytes means native byte order and float format. A file
+ * written on a machine with the other byte order fails the magic check
+ * instead of loading garbage. The version number is bumped whenever the
+ * layout changes, so old files are rejected, never misread.
+ *
+ * Each class writes and reads its own part (BodyStore, ContactSolver,
+ * IslandManager); PhysicsEngine::saveSnapshot/loadSnapshot put them together.
+ */
+class SnapshotWriter {
+public:
+    // One plain value (trivially copyable: floats, ints, POD structs)
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        append(&value, sizeof(T));
+    }
+
+    // The first count elements of an array, as one block (no length is stored)
+    template <typename T>
+    void writeArray(const std::vector<T>& values, size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        append(values.data(), count * sizeof(T));
+    }
+
+    // Write everything to path, replacing the file; false if it couldn't be written
+    bool saveToFile(const std::string& path) const;
+
+private:
+    void append(const void* data, size_t size);
+
+    std::vector<char> bytes;
+};
+
+class SnapshotReader {
+public:
+    // Read the whole file into memory; false if it can't be opened or read
+    bool loadFromFile(const std::string& path);
+
+    /**
+     * Read one value / one block of count elements
+     * Reading past the end marks the reader failed and leaves the target
+     * untouched, so one check of ok() at the end covers a whole load
+     */
+    template <typename T>
+    bool read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return take(&value, sizeof(T));
+    }
+
+    template <typename T>
+    bool readArray(std::vector<T>& values, size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (!fits(count, sizeof(T))) return false;
+        values.resize(count);
+        return take(values.data(), count * sizeof(T));
+    }
+
+    // Would count elements of elementSize bytes still fit? (checks a count before allocating for it)
+    bool fits(size_t count, size_t elementSize) {
+        if (elementSize != 0 && count > (bytes.size() - cursor) / elementSize) {
+            failed = true;
+        }
+        return !failed;
+    }
+
+    bool ok() const { return !failed; }
+
+private:
+    bool take(void* out, size_t size);
+
+    std::vector<char> bytes;
+    size_t cursor = 0;
+    bool failed = false;
+};
@@ -2,6 +2,11 @@
 #include <algorithm>
 #include <cmath>
 
+namespace {
+    // Hashed cells are unclamped; this only keeps floor() within int range
+    constexpr float HASHED_COORD_LIMIT = static_cast<float>(1 << 30);
+}
+
 /**
  * Initialize the spatial grid
  *
@@ -14,6 +19,7 @@
  * - Each cell is lightweight (just a vector)
  * - Empty cells take minimal memory
  * - Memory scales with world size, not object count
+ *   (which is why huge worlds start in Hashed mode instead)
  */
 SpatialGrid::SpatialGrid(float worldWidth, float worldHeight, float cellSize)
     : worldWidth(worldWidth), worldHeight(worldHeight), cellSize(cellSize) {
@@ -22,27 +28,52 @@ SpatialGrid::SpatialGrid(float worldWidth, float worldHeight, float cellSize)
     gridWidth = static_cast<int>(std::ceil(worldWidth / cellSize));
     gridHeight = static_cast<int>(std::ceil(worldHeight / cellSize));
 
-    // Pre-allocate all cells (they start empty)
-    cells.resize(gridWidth * gridHeight);
+    // Pre-allocate all cells (they start empty) - unless there would be too many
+    size_t denseCells = static_cast<size_t>(gridWidth) * static_cast<size_t>(gridHeight);
+    setMode(denseCells > MAX_DENSE_CELLS ? Mode::Hashed : Mode::Dense);
+}
+
+void SpatialGrid::setMode(Mode newMode) {
+    mode = newMode;
+    bodyRanges.clear();
+    if (mode == Mode::Dense) {
+        cells.assign(static_cast<size_t>(gridWidth) * static_cast<size_t>(gridHeight), Cell{});
+    } else {
+        std::vector<Cell>().swap(cells);  // Give the dense cells' memory back
+    }
+
+    tableKeys.clear();
+    tableStart.clear();
+    tableCount.clear();
+    occupiedSlots.clear();
+    cellEntries.clear();
+    tableShift = 64;
+    hashedDirty = true;
+}
+
+size_t SpatialGrid::getCellCount() const {
+    return mode == Mode::Dense ? cells.size() : occupiedSlots.size();
 }
 
 /**
  * Clear all bodies from all cells
  *
  * PERFORMANCE NOTE:
- * - Called every frame before rebuilding
+ * - Called before a full rebuild (bodies added or removed)
  * - O(number of cells) operation
  * - Very fast because cells vector stays allocated (no deallocation)
  *
- * WHY REBUILD EVERY FRAME?
- * - Objects are moving constantly
- * - Easier than tracking which cells objects enter/leave
- * - Fast enough that rebuilding is simpler than updating
+ * WHY NOT REBUILD EVERY FRAME?
+ * - A rebuild touches every body, even the ones sitting still
+ * - Between rebuilds, update() only touches the few bodies that crossed a
+ *   cell boundary (see update())
  */
 void SpatialGrid::clear() {
     for (auto& cell : cells) {
         cell.bodies.clear();  // Clear the bodies, keep the vector allocated
     }
+    bodyRanges.clear();
+    hashedDirty = true;
 }
 
 /**
@@ -54,8 +85,12 @@ void SpatialGrid::clear() {
  * CLAMPING:
  * - Ensures objects outside world boundaries don't cause crashes
  * - Objects are forced into edge cells if out of bounds
+ * - Hashed mode has no edges: floor() so that -0.5 is column -1, not 0
  */
 int SpatialGrid::getCellX(float x) const {
+    if (mode == Mode::Hashed) {
+        return static_cast<int>(std::clamp(std::floor(x / cellSize), -HASHED_COORD_LIMIT, HASHED_COORD_LIMIT));
+    }
     int cellX = static_cast<int>(x / cellSize);
     return std::clamp(cellX, 0, gridWidth - 1);  // Keep in valid range [0, gridWidth-1]
 }
@@ -65,6 +100,9 @@ int SpatialGrid::getCellX(float x) const {
  * Same logic as getCellX but for Y axis
  */
 int SpatialGrid::getCellY(float y) const {
+    if (mode == Mode::Hashed) {
+        return static_cast<int>(std::clamp(std::floor(y / cellSize), -HASHED_COORD_LIMIT, HASHED_COORD_LIMIT));
+    }
     int cellY = static_cast<int>(y / cellSize);
     return std::clamp(cellY, 0, gridHeight - 1);  // Keep in valid range [0, gridHeight-1]
 }
@@ -92,7 +130,7 @@ int SpatialGrid::getCellIndex(int cellX, int cellY) const {
  * BOUNDING BOX APPROACH:
  * - Use AABB (Axis-Aligned Bounding Box) of the circular body
  * - Find min/max cells the box touches
- * - Add all cells in that rectangular region
+ * - The body covers every cell in that rectangular region
  *
  * EXAMPLE: Body at (250, 250) with radius 30, cellSize 100
  * - Left edge: 250 - 30 = 220 → cell 2
@@ -106,44 +144,71 @@ int SpatialGrid::getCellIndex(int cellX, int cellY) const {
  * - Right: 325 → cell 3
  * - Result: Body spans cells [2,2] and [3,2] (2 cells)
  *
- * WHY USE BOUNDING BOX?
- * - Simpler than precise circle-cell overlap test
- * - Fast to calculate
- * - Slightly conservative (might include extra cells) but safe
+ * WHY RETURN A RANGE (not a list of cells)?
+ * - Four ints on the stack instead of a std::vector allocated per body per frame
+ * - The caller just loops over the rectangle
  */
-std::vector<int> SpatialGrid::getCellsForBody(RigidBody* body) const {
-    std::vector<int> cellIndices;
-
-    sf::Vector2f pos = body->getPosition();
-    float radius = body->getRadius();
-
+SpatialGrid::CellRange SpatialGrid::getCellRange(const sf::Vector2f& pos, float radius) const {
     // Calculate the bounding box of the body's circle
     // This gives us the rectangular region the body occupies
-    int minCellX = getCellX(pos.x - radius);  // Leftmost cell
-    int maxCellX = getCellX(pos.x + radius);  // Rightmost cell
-    int minCellY = getCellY(pos.y - radius);  // Topmost cell
-    int maxCellY = getCellY(pos.y + radius);  // Bottommost cell
+    sf::Vector2f extent(radius, radius);
+    return getCellRange(pos - extent, pos + extent);
+}
 
-    // Insert body into all cells within the bounding box
-    // Usually 1-4 cells for typical body sizes
-    for (int y = minCellY; y <= maxCellY; ++y) {
-        for (int x = minCellX; x <= maxCellX; ++x) {
-            cellIndices.push_back(getCellIndex(x, y));
-        }
-    }
+/**
+ * Cells covered by a body's box (insert, update and swept boxes all come here,
+ * so a body keeps the same range from one step to the next)
+ */
+SpatialGrid::CellRange SpatialGrid::getCellRange(const sf::Vector2f& min, const sf::Vector2f& max) const {
+    CellRange range;
+    range.minX = getCellX(min.x);  // Leftmost cell
+    range.maxX = getCellX(max.x);  // Rightmost cell
+    range.minY = getCellY(min.y);  // Topmost cell
+    range.maxY = getCellY(max.y);  // Bottommost cell
 
-    return cellIndices;
+    // Keep a runaway body's entry count bounded (see MAX_HASHED_BODY_SPAN)
+    if (mode == Mode::Hashed) {
+        auto limitSpan = [](int& low, int& high, int centre) {
+            if (static_cast<int64_t>(high) - low >= MAX_HASHED_BODY_SPAN) {
+                low = std::clamp(centre - MAX_HASHED_BODY_SPAN / 2, low, high - (MAX_HASHED_BODY_SPAN - 1));
+                high = low + MAX_HASHED_BODY_SPAN - 1;
+            }
+        };
+        sf::Vector2f centre = (min + max) * 0.5f;
+        limitSpan(range.minX, range.maxX, getCellX(centre.x));
+        limitSpan(range.minY, range.maxY, getCellY(centre.y));
+    }
+    return range;
 }
 
 /**
  * Insert a body into a specific cell
  * Includes bounds checking to prevent crashes
  */
-void SpatialGrid::insertBodyIntoCell(RigidBody* body, int cellX, int cellY) {
+void SpatialGrid::insertBodyIntoCell(uint32_t bodyIndex, int cellX, int cellY) {
     // Bounds check - make sure cell coordinates are valid
     if (cellX >= 0 && cellX < gridWidth && cellY >= 0 && cellY < gridHeight) {
         int index = getCellIndex(cellX, cellY);
-        cells[index].bodies.push_back(body);
+        cells[index].bodies.push_back(bodyIndex);
+    }
+}
+
+/**
+ * Remove a body from a specific cell
+ *
+ * SWAP-AND-POP:
+ * Order inside a cell doesn't matter, so the last entry fills the hole
+ * instead of shifting everything after it down by one.
+ * Cells hold a handful of bodies, so the linear search is a few compares.
+ */
+void SpatialGrid::removeBodyFromCell(uint32_t bodyIndex, int cellX, int cellY) {
+    auto& bodies = cells[getCellIndex(cellX, cellY)].bodies;
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        if (bodies[i] == bodyIndex) {
+            bodies[i] = bodies.back();
+            bodies.pop_back();
+            return;
+        }
     }
 }
 
@@ -155,11 +220,79 @@ void SpatialGrid::insertBodyIntoCell(RigidBody* body, int cellX, int cellY) {
  * - Called once per body per frame
  * - Total: O(n) for n bodies
  */
-void SpatialGrid::insert(RigidBody* body) {
-    auto cellIndices = getCellsForBody(body);
-    for (int index : cellIndices) {
-        cells[index].bodies.push_back(body);
+void SpatialGrid::insert(uint32_t bodyIndex, const sf::Vector2f& position, float radius) {
+    CellRange range = getCellRange(position, radius);
+
+    // Indices skipped over (bodies kept in another grid) cover no cells
+    if (bodyIndex >= bodyRanges.size()) {
+        bodyRanges.resize(bodyIndex + 1, CellRange::empty());
+    }
+    bodyRanges[bodyIndex] = range;
+
+    // Hashed mode only records the range; rebuildIfDirty() sorts bodies into cells
+    if (mode == Mode::Hashed) {
+        hashedDirty = true;
+        return;
+    }
+
+    // Insert body into all cells within the bounding box
+    // Usually 1-4 cells for typical body sizes
+    for (int y = range.minY; y <= range.maxY; ++y) {
+        for (int x = range.minX; x <= range.maxX; ++x) {
+            cells[getCellIndex(x, y)].bodies.push_back(bodyIndex);
+        }
+    }
+}
+
+/**
+ * Move a body to the cells covering its new position
+ *
+ * FAST PATH (almost every call):
+ * - Compute the new cell range (four float → int conversions)
+ * - Same as the stored range → nothing to do
+ *
+ * SLOW PATH (body crossed a cell boundary):
+ * - Leave the cells that are in the old range but not in the new one
+ * - Join the cells that are in the new range but not in the old one
+ * - Cells in both ranges keep their entry untouched
+ *
+ * The body must have been inserted since the last clear()
+ */
+bool SpatialGrid::update(uint32_t bodyIndex, const sf::Vector2f& position, float radius) {
+    sf::Vector2f extent(radius, radius);
+    return update(bodyIndex, position - extent, position + extent);
+}
+
+bool SpatialGrid::update(uint32_t bodyIndex, const sf::Vector2f& min, const sf::Vector2f& max) {
+    CellRange newRange = getCellRange(min, max);
+    CellRange& oldRange = bodyRanges[bodyIndex];
+    if (newRange == oldRange) {
+        return false;
+    }
+
+    if (mode == Mode::Hashed) {
+        oldRange = newRange;
+        hashedDirty = true;
+        return true;
+    }
+
+    for (int y = oldRange.minY; y <= oldRange.maxY; ++y) {
+        for (int x = oldRange.minX; x <= oldRange.maxX; ++x) {
+            if (!newRange.contains(x, y)) {
+                removeBodyFromCell(bodyIndex, x, y);
+            }
+        }
+    }
+    for (int y = newRange.minY; y <= newRange.maxY; ++y) {
+        for (int x = newRange.minX; x <= newRange.maxX; ++x) {
+            if (!oldRange.contains(x, y)) {
+                cells[getCellIndex(x, y)].bodies.push_back(bodyIndex);
+            }
+        }
     }
+
+    oldRange = newRange;
+    return true;
 }
 
 /**
@@ -168,59 +301,420 @@ void SpatialGrid::insert(RigidBody* body) {
  *
  * ALGORITHM:
  * 1. For each cell, check all pairs of bodies in that cell
- * 2. Use hash set to avoid duplicate pairs (bodies in multiple cells)
- * 3. Return list of unique pairs for narrow-phase testing
+ * 2. Only report a pair from the ONE cell that "owns" it (see below)
+ * 3. Write the unique pairs into the caller's buffer for narrow-phase testing
  *
  * DUPLICATE PROBLEM:
  * - Body A might be in cells [1,1] and [2,1]
- * - Body B might be in cells [2,1] and [2,2]
- * - Both appear in cell [2,1] → we'd check them
- * - Without deduplication, we'd check the same pair multiple times!
+ * - Body B might be in cells [1,1] and [2,1] too
+ * - Both cells contain A and B → we'd report the pair twice!
+ *
+ * OWNER-CELL RULE (no hash set needed):
+ * - The cells shared by A and B form a rectangle: the overlap of their ranges
+ * - Its top-left cell is (max(A.minX, B.minX), max(A.minY, B.minY))
+ * - Only that cell emits the pair; every other shared cell skips it
  *
- * HASH FUNCTION:
- * - Combine two pointer addresses into single hash
- * - XOR (^) and bit shift (<<) mix the bits
- * - Order-independent: hash(A,B) == hash(B,A)
+ *     A covers x 1..2, B covers x 2..3  →  shared x 2..2  →  owner column 2
+ *
+ * - Exactly one cell passes the test, so every pair appears exactly once
+ * - Costs two comparisons instead of a hash, an allocation and a lookup
+ * - Nothing can collide, so no real pair is ever dropped
  *
  * COMPLEXITY ANALYSIS:
  * - Best case: O(n) when bodies evenly distributed
  * - Worst case: O(n²) if all bodies in one cell (but this is rare!)
  * - Typical case: O(n × k) where k = average bodies per cell (small!)
  */
-std::vector<std::pair<RigidBody*, RigidBody*>> SpatialGrid::getPotentialCollisions() {
-    std::vector<std::pair<RigidBody*, RigidBody*>> pairs;
-    std::unordered_set<size_t> processedPairs;  // Track which pairs we've already added
-
-    // For each cell, check collisions between bodies in the cell
-    for (const auto& cell : cells) {
-        const auto& bodies = cell.bodies;
-
-        // Check all pairs within this cell using nested loop
-        // This is O(k²) where k = bodies in this cell
-        for (size_t i = 0; i < bodies.size(); ++i) {
-            for (size_t j = i + 1; j < bodies.size(); ++j) {  // j starts at i+1 to avoid checking (A,B) and (B,A)
-                RigidBody* body1 = bodies[i];
-                RigidBody* body2 = bodies[j];
-
-                // Create a unique hash for this pair
-                // Use pointer addresses to create unique identifier
-                // Order the pointers to ensure consistent hashing
-                size_t hash = 0;
-                if (body1 < body2) {
-                    hash = reinterpret_cast<size_t>(body1) ^ (reinterpret_cast<size_t>(body2) << 1);
-                } else {
-                    hash = reinterpret_cast<size_t>(body2) ^ (reinterpret_cast<size_t>(body1) << 1);
+void SpatialGrid::getPotentialCollisions(std::vector<CollisionPair>& outPairs) const {
+    outPairs.clear();  // Keeps capacity - no allocation once warmed up
+
+    if (mode == Mode::Hashed) {
+        // Only occupied cells exist - visit them straight from the table
+        for (uint32_t slot : occupiedSlots) {
+            uint64_t key = tableKeys[slot];
+            emitCellPairs(&cellEntries[tableStart[slot]], tableCount[slot], keyCellX(key), keyCellY(key), outPairs);
+        }
+        return;
+    }
+
+    for (int cellY = 0; cellY < gridHeight; ++cellY) {
+        for (int cellX = 0; cellX < gridWidth; ++cellX) {
+            const auto& bodies = cells[getCellIndex(cellX, cellY)].bodies;
+            emitCellPairs(bodies.data(), bodies.size(), cellX, cellY, outPairs);
+        }
+    }
+}
+
+/**
+ * Every pair of bodies in one cell that this cell owns (see above)
+ */
+void SpatialGrid::emitCellPairs(const uint32_t* bodies, size_t count, int cellX, int cellY,
+                                std::vector<CollisionPair>& outPairs) const {
+    // Check all pairs within this cell using nested loop
+    // This is O(k²) where k = bodies in this cell
+    for (size_t i = 0; i < count; ++i) {
+        const CellRange& rangeA = bodyRanges[bodies[i]];
+        bool sleepingA = sleepFlags && sleepFlags[bodies[i]];
+
+        for (size_t j = i + 1; j < count; ++j) {  // j starts at i+1 to avoid checking (A,B) and (B,A)
+            if (sleepingA && sleepFlags[bodies[j]]) {
+                continue;  // Neither body moves - they can't start touching
+            }
+            const CellRange& rangeB = bodyRanges[bodies[j]];
+
+            // Is this cell the top-left corner of the shared region?
+            int ownerX = std::max(rangeA.minX, rangeB.minX);
+            int ownerY = std::max(rangeA.minY, rangeB.minY);
+            if (ownerX != cellX || ownerY != cellY) {
+                continue;  // Another cell reports this pair
+            }
+
+            outPairs.push_back({bodies[i], bodies[j]});
+        }
+    }
+}
+
+void SpatialGrid::queryRect(const sf::Vector2f& min, const sf::Vector2f& max, std::vector<uint32_t>& outBodies) const {
+    outBodies.clear();
+
+    int minX = getCellX(min.x);
+    int minY = getCellY(min.y);
+    int maxX = getCellX(max.x);
+    int maxY = getCellY(max.y);
+
+    // Report the body from the top-left cell it shares with the query
+    auto reportCell = [&](const uint32_t* bodies, size_t count, int cellX, int cellY) {
+        for (size_t i = 0; i < count; ++i) {
+            const CellRange& range = bodyRanges[bodies[i]];
+            if (std::max(range.minX, minX) == cellX && std::max(range.minY, minY) == cellY) {
+                outBodies.push_back(bodies[i]);
+            }
+        }
+    };
+
+    if (mode == Mode::Hashed) {
+        // A wide query can cover far more cells than exist - then it is
+        // cheaper to walk the occupied cells and keep those inside
+        int64_t queryCells = (static_cast<int64_t>(maxX) - minX + 1) * (static_cast<int64_t>(maxY) - minY + 1);
+        if (queryCells <= static_cast<int64_t>(occupiedSlots.size())) {
+            for (int cellY = minY; cellY <= maxY; ++cellY) {
+                for (int cellX = minX; cellX <= maxX; ++cellX) {
+                    int64_t slot = findSlot(cellKey(cellX, cellY));
+                    if (slot >= 0) {
+                        reportCell(&cellEntries[tableStart[slot]], tableCount[slot], cellX, cellY);
+                    }
+                }
+            }
+        } else {
+            for (uint32_t slot : occupiedSlots) {
+                uint64_t key = tableKeys[slot];
+                int cellX = keyCellX(key);
+                int cellY = keyCellY(key);
+                if (cellX >= minX && cellX <= maxX && cellY >= minY && cellY <= maxY) {
+                    reportCell(&cellEntries[tableStart[slot]], tableCount[slot], cellX, cellY);
                 }
+            }
+        }
+        return;
+    }
+
+    for (int cellY = minY; cellY <= maxY; ++cellY) {
+        for (int cellX = minX; cellX <= maxX; ++cellX) {
+            const auto& bodies = cells[getCellIndex(cellX, cellY)].bodies;
+            reportCell(bodies.data(), bodies.size(), cellX, cellY);
+        }
+    }
+}
+
+std::span<const uint32_t> SpatialGrid::getCellBodies(int cellX, int cellY) const {
+    if (mode == Mode::Dense) {
+        return cells[getCellIndex(cellX, cellY)].bodies;
+    }
+    int64_t slot = findSlot(cellKey(cellX, cellY));
+    if (slot < 0) {
+        return {};
+    }
+    return std::span<const uint32_t>(&cellEntries[tableStart[slot]], tableCount[slot]);
+}
+
+/**
+ * THE DDA WALK
+ *
+ * For a ray p(t) = origin + t * direction, crossing one column takes
+ * cellSize / |direction.x| of t (stepX), one row cellSize / |direction.y|.
+ * nextX / nextY hold the t at which the ray crosses into the next column /
+ * row; whichever is smaller is the next cell:
+ *
+ *        nextY           │
+ *   ───────●─────────────┼──
+ *         ╱              │
+ *        ╱  cell         │
+ *   ────●────────────────┼──   ← the ray crosses this row line first
+ *    origin            nextX     so the next cell is the one above
+ *
+ * Every step visits the cells around its piece of the ray, p(enter)..p(exit)
+ * widened by thickness. A body hit at distance d is found in the step that
+ * contains d, so once a step exits past the visitor's distance, no later cell
+ * can hold anything closer.
+ *
+ * Dense mode walks cell by cell only inside the world. Outside it, bodies sit
+ * in the clamped edge cells, so the part of the ray before the world and the
+ * part after it are one step each: the strip of edge cells they clamp onto.
+ * Hashed mode has nothing outside the occupied cells and skips those parts.
+ */
+float SpatialGrid::queryRay(const sf::Vector2f& origin, const sf::Vector2f& direction, float maxDistance,
+                            float thickness, RayVisitor& visitor) const {
+    CellRange bounds = mode == Mode::Dense ? CellRange{0, 0, gridWidth - 1, gridHeight - 1} : occupiedBounds;
+    if (bounds.maxX < bounds.minX) {
+        return maxDistance;  // Empty hashed grid
+    }
+    float boundsMin[2] = {bounds.minX * cellSize, bounds.minY * cellSize};
+    float boundsMax[2] = {(bounds.maxX + 1) * cellSize, (bounds.maxY + 1) * cellSize};
+    if (mode == Mode::Hashed) {
+        for (int axis = 0; axis < 2; ++axis) {
+            boundsMin[axis] -= thickness;
+            boundsMax[axis] += thickness;
+        }
+    }
+
+    // The part of the ray inside the bounds: tStart..tEnd
+    float start[2] = {origin.x, origin.y};
+    float dir[2] = {direction.x, direction.y};
+    float tStart = 0.0f;
+    float tEnd = maxDistance;
+    for (int axis = 0; axis < 2; ++axis) {
+        if (dir[axis] == 0.0f) {
+            if (start[axis] < boundsMin[axis] || start[axis] > boundsMax[axis]) tStart = INFINITY;
+            continue;
+        }
+        float t0 = (boundsMin[axis] - start[axis]) / dir[axis];
+        float t1 = (boundsMax[axis] - start[axis]) / dir[axis];
+        tStart = std::max(tStart, std::min(t0, t1));
+        tEnd = std::min(tEnd, std::max(t0, t1));
+    }
+    bool missesBounds = tStart > tEnd;
 
-                // Only add if we haven't processed this pair yet
-                // This prevents duplicate collision checks when bodies share multiple cells
-                if (processedPairs.find(hash) == processedPairs.end()) {
-                    processedPairs.insert(hash);
-                    pairs.emplace_back(body1, body2);
+    float distance = maxDistance;
+    CellRange visited = CellRange::empty();
+
+    // Visit the cells around p(enter)..p(exit); the last piece's cells were already seen
+    auto visitPiece = [&](float enter, float exit) {
+        sf::Vector2f a = origin + direction * enter;
+        sf::Vector2f b = origin + direction * exit;
+        sf::Vector2f min(std::min(a.x, b.x) - thickness, std::min(a.y, b.y) - thickness);
+        sf::Vector2f max(std::max(a.x, b.x) + thickness, std::max(a.y, b.y) + thickness);
+        if (mode == Mode::Dense) {
+            // Anything past the world lands in the edge cells anyway; this keeps the casts in int range
+            sf::Vector2f lowest(-cellSize, -cellSize);
+            sf::Vector2f highest(boundsMax[0] + cellSize, boundsMax[1] + cellSize);
+            min = sf::Vector2f(std::clamp(min.x, lowest.x, highest.x), std::clamp(min.y, lowest.y, highest.y));
+            max = sf::Vector2f(std::clamp(max.x, lowest.x, highest.x), std::clamp(max.y, lowest.y, highest.y));
+        }
+        // Not getCellRange(): a ray piece must not be capped like a body
+        CellRange range{getCellX(min.x), getCellY(min.y), getCellX(max.x), getCellY(max.y)};
+
+        for (int y = range.minY; y <= range.maxY; ++y) {
+            for (int x = range.minX; x <= range.maxX; ++x) {
+                if (visited.contains(x, y)) continue;
+                for (uint32_t body : getCellBodies(x, y)) {
+                    distance = std::min(distance, visitor.visit(body));
                 }
             }
         }
+        visited = range;
+    };
+
+    if (missesBounds) {
+        if (mode == Mode::Dense) {
+            visitPiece(0.0f, maxDistance);
+        }
+        return distance;
+    }
+    if (tStart > 0.0f && mode == Mode::Dense) {
+        visitPiece(0.0f, tStart);
+        if (distance <= tStart) return distance;
+    }
+
+    // The first column / row line ahead of the entry point
+    sf::Vector2f entry = origin + direction * tStart;
+    float lineX = std::floor(entry.x / cellSize) + (direction.x > 0.0f ? 1.0f : 0.0f);
+    float lineY = std::floor(entry.y / cellSize) + (direction.y > 0.0f ? 1.0f : 0.0f);
+    float stepX = direction.x != 0.0f ? cellSize / std::fabs(direction.x) : INFINITY;
+    float stepY = direction.y != 0.0f ? cellSize / std::fabs(direction.y) : INFINITY;
+    float nextX = direction.x != 0.0f ? (lineX * cellSize - origin.x) / direction.x : INFINITY;
+    float nextY = direction.y != 0.0f ? (lineY * cellSize - origin.y) / direction.y : INFINITY;
+
+    for (float enter = tStart;;) {
+        float exit = std::min({nextX, nextY, tEnd});
+        visitPiece(enter, exit);
+        if (exit >= std::min(tEnd, distance)) break;
+
+        enter = exit;
+        if (nextX < nextY) {
+            nextX += stepX;
+        } else {
+            nextY += stepY;
+        }
+    }
+
+    if (tEnd < std::min(maxDistance, distance) && mode == Mode::Dense) {
+        visitPiece(tEnd, maxDistance);
+    }
+    return distance;
+}
+
+void SpatialGrid::rebuildIfDirty() {
+    if (mode == Mode::Hashed && hashedDirty) {
+        rebuildHashed();
+        hashedDirty = false;
+    }
+}
+
+/**
+ * Regroup every (cell, body) entry by cell - the counting sort described
+ * with Mode in the header
+ *
+ * PASSES:
+ * 1. Find (or create) each entry's cell in the hash table and count it
+ * 2. Prefix-sum the counts: each cell's run starts where the previous ended
+ * 3. Scatter body indices into their runs, in body order
+ *
+ * The table only grows, and is emptied by visiting the slots used last time,
+ * so a rebuild costs O(entries) and allocates nothing once warmed up.
+ */
+// Cells in a body's range (0 for an empty range), widened before subtracting
+size_t SpatialGrid::cellsCovered(const CellRange& range) {
+    int64_t width = static_cast<int64_t>(range.maxX) - range.minX + 1;
+    int64_t height = static_cast<int64_t>(range.maxY) - range.minY + 1;
+    return width > 0 && height > 0 ? static_cast<size_t>(width) * static_cast<size_t>(height) : 0;
+}
+
+void SpatialGrid::rebuildHashed() {
+    size_t entryCount = 0;
+    for (const CellRange& range : bodyRanges) {
+        entryCount += cellsCovered(range);
+    }
+
+    // At most half full: there are never more occupied cells than entries
+    size_t capacity = 16;
+    while (capacity < entryCount * 2) {
+        capacity <<= 1;
+    }
+    if (capacity > tableKeys.size()) {
+        tableKeys.assign(capacity, EMPTY_KEY);
+        tableStart.resize(capacity);
+        tableCount.resize(capacity);
+    } else {
+        for (uint32_t slot : occupiedSlots) {
+            tableKeys[slot] = EMPTY_KEY;
+        }
+    }
+    int bits = 0;
+    while ((size_t(1) << bits) < tableKeys.size()) {
+        ++bits;
+    }
+    tableShift = 64 - bits;
+    occupiedSlots.clear();
+    entrySlots.resize(entryCount);
+    cellEntries.resize(entryCount);
+
+    // 1. Count bodies per cell
+    size_t entry = 0;
+    occupiedBounds = CellRange{INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN};
+    for (const CellRange& range : bodyRanges) {
+        if (range.maxX >= range.minX) {
+            occupiedBounds.minX = std::min(occupiedBounds.minX, range.minX);
+            occupiedBounds.minY = std::min(occupiedBounds.minY, range.minY);
+            occupiedBounds.maxX = std::max(occupiedBounds.maxX, range.maxX);
+            occupiedBounds.maxY = std::max(occupiedBounds.maxY, range.maxY);
+        }
+        for (int y = range.minY; y <= range.maxY; ++y) {
+            for (int x = range.minX; x <= range.maxX; ++x) {
+                uint32_t slot = findOrInsertSlot(cellKey(x, y));
+                ++tableCount[slot];
+                entrySlots[entry++] = slot;
+            }
+        }
     }
 
-    return pairs;
+    // 2. Start of each cell's run (count is reset to serve as the fill cursor)
+    uint32_t runStart = 0;
+    for (uint32_t slot : occupiedSlots) {
+        tableStart[slot] = runStart;
+        runStart += tableCount[slot];
+        tableCount[slot] = 0;
+    }
+
+    // 3. Scatter - same walk as pass 1, so entrySlots lines up
+    entry = 0;
+    for (uint32_t body = 0; body < bodyRanges.size(); ++body) {
+        const CellRange& range = bodyRanges[body];
+        size_t count = cellsCovered(range);
+        for (size_t c = 0; c < count; ++c) {
+            uint32_t slot = entrySlots[entry++];
+            cellEntries[tableStart[slot] + tableCount[slot]++] = body;
+        }
+    }
+}
+
+/**
+ * OPEN ADDRESSING (LINEAR PROBING)
+ * Start at the key's hash slot and step forward until the key or a free
+ * slot turns up. Keys sit inline in one array, so a probe is usually one
+ * cache line - no buckets, no per-cell allocations.
+ */
+uint32_t SpatialGrid::findOrInsertSlot(uint64_t key) {
+    size_t mask = tableKeys.size() - 1;
+    for (size_t slot = hashSlot(key);; slot = (slot + 1) & mask) {
+        if (tableKeys[slot] == key) {
+            return static_cast<uint32_t>(slot);
+        }
+        if (tableKeys[slot] == EMPTY_KEY) {
+            tableKeys[slot] = key;
+            tableCount[slot] = 0;
+            occupiedSlots.push_back(static_cast<uint32_t>(slot));
+            return static_cast<uint32_t>(slot);
+        }
+    }
+}
+
+int64_t SpatialGrid::findSlot(uint64_t key) const {
+    if (tableKeys.empty()) {
+        return -1;
+    }
+    size_t mask = tableKeys.size() - 1;
+    for (size_t slot = hashSlot(key);; slot = (slot + 1) & mask) {
+        if (tableKeys[slot] == key) {
+            return static_cast<int64_t>(slot);
+        }
+        if (tableKeys[slot] == EMPTY_KEY) {
+            return -1;
+        }
+    }
+}
+
+/**
+ * Fibonacci hashing: multiply by 2^64 / φ and keep the top bits
+ * Neighbouring cells (keys that differ in their low bits) land far apart
+ */
+size_t SpatialGrid::hashSlot(uint64_t key) const {
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> tableShift);
+}
+
+/**
+ * Cell (x, y) as one 64-bit key: y in the high half, x in the low half
+ * The sign bit of each half is flipped, so (-1, -1) doesn't become all ones
+ * (EMPTY_KEY) - that pattern would need coordinates past HASHED_COORD_LIMIT
+ */
+uint64_t SpatialGrid::cellKey(int cellX, int cellY) {
+    constexpr uint32_t SIGN = 0x80000000u;
+    return (static_cast<uint64_t>(static_cast<uint32_t>(cellY) ^ SIGN) << 32) | (static_cast<uint32_t>(cellX) ^ SIGN);
+}
+
+int SpatialGrid::keyCellX(uint64_t key) {
+    return static_cast<int32_t>(static_cast<uint32_t>(key) ^ 0x80000000u);
+}
+
+int SpatialGrid::keyCellY(uint64_t key) {
+    return static_cast<int32_t>(static_cast<uint32_t>(key >> 32) ^ 0x80000000u);
 }
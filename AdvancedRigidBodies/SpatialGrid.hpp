@@ -1,8 +1,9 @@
 #pragma once
-#include <SFML/Graphics.hpp>
+#include <SFML/System/Vector2.hpp>
 #include <vector>
-#include <unordered_set>
-#include "RigidBody.hpp"
+#include <cstdint>
+#include <span>
+#include "BroadPhase.hpp"
 
 /**
  * SPATIAL PARTITIONING - OPTIMIZATION TECHNIQUE
@@ -31,11 +32,55 @@
  * OTHER SPATIAL PARTITIONING METHODS:
  * - Quadtree: Hierarchical division (good for uneven distribution)
  * - KD-Tree: Binary space partitioning (good for 3D)
- * - Sweep and Prune: Sort objects along axes (good for few moving objects)
+ * - Sweep and Prune: Sort objects along axes (good for coherent motion)
+ *   (available here as SweepAndPrune - see BroadPhase.hpp)
  * - Hash Grid: Similar to this but uses hash function for cell lookup
+ *   (available here as Mode::Hashed - see below)
  */
 class SpatialGrid {
 public:
+    /**
+     * STORAGE MODE
+     *
+     * Dense (default for normal worlds):
+     *   One Cell per grid square, width × height of them, whether anything is
+     *   there or not. Lookups are a multiply and an add; updates are in place.
+     *   Bodies outside the world are clamped into the edge cells.
+     *
+     * Hashed (chosen automatically for huge worlds):
+     *   Only OCCUPIED cells exist, found through an open-addressing hash table
+     *   keyed by the cell's (x, y). Cell coordinates are not clamped, so a
+     *   body far outside the world still gets a cell of its own instead of
+     *   piling into the border. Memory follows the number of bodies, not the
+     *   world's area - a 100k × 100k world costs the same as a 1k × 1k one.
+     *
+     *   No vector per cell: after the bodies move, every (cell, body) entry is
+     *   regrouped by a COUNTING SORT into one flat array:
+     *
+     *     count per cell   [A:2][B:1][C:3]
+     *     prefix sums      [A:0][B:2][C:3]      ← where each cell's run starts
+     *     scatter bodies   [a a|b|c c c]         ← cellEntries
+     *
+     *   Bodies are scattered in index order, so each run is sorted by index.
+     *   Two linear passes, no comparisons, and only when some body actually
+     *   changed cells (see rebuildIfDirty()).
+     */
+    enum class Mode {
+        Dense,
+        Hashed
+    };
+
+    // Dense worlds larger than this many cells start in Hashed mode
+    static constexpr size_t MAX_DENSE_CELLS = size_t(1) << 18;
+
+    /**
+     * Hashed mode: a body is entered in at most this many cells per axis,
+     * centred on its box (plain or swept - see getCellRange()). Only a runaway body (absurd radius, or flung out near
+     * the coordinate limit) gets that wide - its entry count would
+     * otherwise run into the billions.
+     */
+    static constexpr int MAX_HASHED_BODY_SPAN = 256;
+
     /**
      * Constructor - Sets up the grid structure
      *
@@ -48,7 +93,20 @@ public:
     SpatialGrid(float worldWidth, float worldHeight, float cellSize);
 
     /**
-     * Clear all bodies from grid (called each frame before re-inserting)
+     * Switch storage mode (empties the grid - insert everything again)
+     */
+    void setMode(Mode newMode);
+    Mode getMode() const { return mode; }
+
+    /**
+     * Hashed mode: regroup the bodies by cell if any insert()/update()
+     * changed cells since the last call. Dense mode: nothing to do.
+     * Call after the inserts/updates of a step, before querying.
+     */
+    void rebuildIfDirty();
+
+    /**
+     * Clear all bodies from grid (called before a full rebuild)
      * Grid structure itself persists - we just empty the cells
      */
     void clear();
@@ -60,7 +118,31 @@ public:
      * A body's bounding circle might overlap cell boundaries
      * We need to check it against bodies in ALL cells it touches
      */
-    void insert(RigidBody* body);
+    void insert(uint32_t bodyIndex, const sf::Vector2f& position, float radius);
+
+    /**
+     * Move an already inserted body to its new position (INCREMENTAL UPDATE)
+     *
+     * Most steps a body moves a few pixels and stays inside the same cells.
+     * Only when its bounding box crosses a cell boundary is it taken out of
+     * the cells it left and added to the cells it entered:
+     *
+     *     before: x 2..2        after: x 2..3        → add to column 3 only
+     *     [ ][ ][A][ ]          [ ][ ][A][A]
+     *
+     * @return true if the body changed cells
+     */
+    bool update(uint32_t bodyIndex, const sf::Vector2f& position, float radius);
+
+    /**
+     * Same, for any bounding box min..max instead of the body's circle
+     * (a fast body files the box its whole step sweeps - see ContinuousCollision)
+     */
+    bool update(uint32_t bodyIndex, const sf::Vector2f& min, const sf::Vector2f& max);
+
+    // One past the highest body index inserted since the last clear()
+    // (indices never inserted are allowed and occupy no cells)
+    size_t getBodyCount() const { return bodyRanges.size(); }
 
     /**
      * Get all pairs of bodies that MIGHT be colliding
@@ -70,27 +152,97 @@ public:
      * - Broad Phase: Quick test to find potential collisions (this function)
      * - Narrow Phase: Precise test to confirm actual collision (distance check)
      *
-     * Returns pairs of bodies in same cells - still need to check exact distance!
+     * Writes pairs of body indices in same cells into outPairs - still need to
+     * check exact distance!
+     *
+     * ZERO ALLOCATIONS:
+     * - outPairs is owned by the caller and kept between frames
+     * - It is cleared (size 0) but keeps its capacity, so after the first few
+     *   frames it never has to grow again
+     */
+    void getPotentialCollisions(std::vector<CollisionPair>& outPairs) const;
+
+    /**
+     * Per-body flags (indexed like the grid): nonzero = the body is not moving
+     * (static or asleep). Pairs of two such bodies can't start touching, so
+     * the broad phase doesn't report them. nullptr (default) = report all pairs.
+     * The array is not owned and must stay valid while pairs are generated.
+     */
+    void setSleepFlags(const uint8_t* flags) { sleepFlags = flags; }
+
+    /**
+     * Every body whose cells touch the rectangle min..max (RECT QUERY)
+     *
+     * Only the cells under the rectangle are visited. A body spanning several
+     * of them is reported once - by the first of its cells inside the query,
+     * the same owner-cell trick the broad phase uses for pairs.
+     * Results are candidates in cell order; outBodies is cleared first.
+     */
+    void queryRect(const sf::Vector2f& min, const sf::Vector2f& max, std::vector<uint32_t>& outBodies) const;
+
+    /**
+     * Walk the cells along a ray, nearest first (RAY QUERY - grid DDA)
+     *
+     * DDA ("digital differential analyser", Amanatides & Woo): from the cell
+     * the ray starts in, step into whichever neighbour - across x or across
+     * y - the ray reaches first. Each step is a couple of adds, and only the
+     * cells the ray really crosses are visited:
+     *
+     *   [ ][ ][ ][*]      * = visited
+     *   [ ][*][*][*]
+     *   [*][*][ ][ ]      (not every cell of the ray's bounding box)
+     *
+     * A thickness widens the ray: each step also visits the cells within
+     * thickness of its piece of the ray (cells the step before already
+     * visited are skipped). The walk stops once the visitor's distance lies
+     * behind the current cell.
+     *
+     * Only the part of the ray over the grid is walked cell by cell (Dense:
+     * the world, with the clamped edge cells taken in one go for the rest;
+     * Hashed: the occupied cells' bounds).
+     * @return the visitor's last distance (maxDistance if nothing was visited)
      */
-    std::vector<std::pair<RigidBody*, RigidBody*>> getPotentialCollisions();
+    float queryRay(const sf::Vector2f& origin, const sf::Vector2f& direction, float maxDistance,
+                   float thickness, RayVisitor& visitor) const;
 
     // Helper functions to convert world coordinates to grid coordinates
     int getCellX(float x) const;  // Which column is this X position in?
     int getCellY(float y) const;  // Which row is this Y position in?
     int getCellIndex(int cellX, int cellY) const;  // Convert 2D grid coords to 1D array index
 
+    // Cells allocated (Dense) or occupied (Hashed) - for stats and benchmarks
+    size_t getCellCount() const;
+
 private:
     /**
      * A single cell in the grid
-     * Contains pointers to all bodies currently overlapping this cell
+     * Contains the BodyStore indices of all bodies currently overlapping this cell
      *
-     * NOTE: Using raw pointers here is safe because:
-     * - Bodies are owned by PhysicsEngine (unique_ptr)
-     * - Grid is rebuilt every frame (no dangling pointer risk)
-     * - Grid lifetime < Body lifetime
+     * NOTE: Storing indices here is safe because:
+     * - Bodies are owned by PhysicsEngine's BodyStore
+     * - The engine rebuilds the grid whenever bodies are added or removed
+     *   (the only times indices change), and updates it in place otherwise
+     * - 4 bytes per entry instead of an 8-byte pointer
      */
     struct Cell {
-        std::vector<RigidBody*> bodies;
+        std::vector<uint32_t> bodies;
+    };
+
+    /**
+     * Rectangle of cells a body's bounding box covers (inclusive)
+     * Remembered per body so the broad phase can decide which cell "owns" a pair
+     */
+    struct CellRange {
+        int minX, minY;
+        int maxX, maxY;
+
+        // No cells at all (max < min, so every loop over it runs zero times)
+        static constexpr CellRange empty() { return CellRange{0, 0, -1, -1}; }
+
+        bool contains(int x, int y) const { return x >= minX && x <= maxX && y >= minY && y <= maxY; }
+        bool operator==(const CellRange& other) const {
+            return minX == other.minX && minY == other.minY && maxX == other.maxX && maxY == other.maxY;
+        }
     };
 
     // Grid dimensions and configuration
@@ -113,7 +265,46 @@ private:
      */
     std::vector<Cell> cells;
 
+    /**
+     * Cell range of every inserted body, indexed by body index
+     * Like the cells, this vector is reused frame to frame (no reallocation)
+     */
+    std::vector<CellRange> bodyRanges;
+
+    const uint8_t* sleepFlags = nullptr;  // Not owned
+
+    /**
+     * HASHED MODE STORAGE
+     * One slot per table entry; tableKeys marks a slot free with EMPTY_KEY.
+     * A cell's bodies are cellEntries[tableStart[slot] .. + tableCount[slot]].
+     * The table is kept at most half full so probe chains stay short.
+     */
+    static constexpr uint64_t EMPTY_KEY = ~uint64_t(0);
+    Mode mode = Mode::Dense;
+    bool hashedDirty = false;
+    int tableShift = 64;                  // 64 - log2(table size), for the multiplicative hash
+    std::vector<uint64_t> tableKeys;
+    std::vector<uint32_t> tableStart;
+    std::vector<uint32_t> tableCount;
+    std::vector<uint32_t> occupiedSlots;  // Slots in use, in the order their cells were first seen
+    std::vector<uint32_t> cellEntries;    // Body indices grouped by cell (counting sort output)
+    std::vector<uint32_t> entrySlots;     // Rebuild scratch: table slot of every (cell, body) entry
+    CellRange occupiedBounds = CellRange::empty();  // Every occupied cell, as of the last rebuild (for rays)
+
     // Helper methods
-    void insertBodyIntoCell(RigidBody* body, int cellX, int cellY);
-    std::vector<int> getCellsForBody(RigidBody* body) const;
+    void insertBodyIntoCell(uint32_t bodyIndex, int cellX, int cellY);
+    void removeBodyFromCell(uint32_t bodyIndex, int cellX, int cellY);
+    CellRange getCellRange(const sf::Vector2f& position, float radius) const;
+    CellRange getCellRange(const sf::Vector2f& min, const sf::Vector2f& max) const;
+    void emitCellPairs(const uint32_t* bodies, size_t count, int cellX, int cellY,
+                       std::vector<CollisionPair>& outPairs) const;
+    void rebuildHashed();
+    static size_t cellsCovered(const CellRange& range);
+    std::span<const uint32_t> getCellBodies(int cellX, int cellY) const;  // Empty for an unoccupied cell
+    uint32_t findOrInsertSlot(uint64_t key);
+    int64_t findSlot(uint64_t key) const;  // -1 if the cell is empty
+    size_t hashSlot(uint64_t key) const;
+    static uint64_t cellKey(int cellX, int cellY);
+    static int keyCellX(uint64_t key);
+    static int keyCellY(uint64_t key);
 };
@@ -0,0 +1,134 @@
+#include "SweepAndPrune.hpp"
+#include <algorithm>
+
+void SweepAndPrune::clear() {
+    entries.clear();
+    slot.clear();
+    needsFullSort = true;
+}
+
+void SweepAndPrune::insert(uint32_t bodyIndex, const sf::Vector2f& position, float radius) {
+    if (bodyIndex >= slot.size()) {
+        slot.resize(bodyIndex + 1, NO_SLOT);
+    }
+    slot[bodyIndex] = static_cast<uint32_t>(entries.size());
+    entries.push_back({position.x - radius, position.x + radius, position.y - radius, position.y + radius, bodyIndex});
+    needsFullSort = true;
+}
+
+bool SweepAndPrune::update(uint32_t bodyIndex, const sf::Vector2f& min, const sf::Vector2f& max) {
+    Entry& entry = entries[slot[bodyIndex]];
+    if (entry.minX == min.x && entry.maxX == max.x && entry.minY == min.y && entry.maxY == max.y) {
+        return false;
+    }
+    entry.minX = min.x;
+    entry.maxX = max.x;
+    entry.minY = min.y;
+    entry.maxY = max.y;
+    return true;
+}
+
+/**
+ * INSERTION SORT ON A NEARLY SORTED ARRAY
+ *
+ * Each entry slides left past the entries that now start after it:
+ *
+ *   [2 5 9 7 12]   7 < 9 → shift 9 right, drop 7 in   [2 5 7 9 12]
+ *
+ * An entry that didn't pass anyone costs one compare. Slots are fixed up
+ * only for the entries that actually moved.
+ */
+void SweepAndPrune::rebuildIfDirty() {
+    lastSwaps = 0;
+    auto byMinX = [](const Entry& a, const Entry& b) { return a.minX < b.minX; };
+
+    if (needsFullSort) {
+        std::sort(entries.begin(), entries.end(), byMinX);
+        for (size_t i = 0; i < entries.size(); ++i) {
+            slot[entries[i].body] = static_cast<uint32_t>(i);
+        }
+        needsFullSort = false;
+    } else {
+        for (size_t i = 1; i < entries.size(); ++i) {
+            if (!(entries[i].minX < entries[i - 1].minX)) continue;
+
+            Entry moving = entries[i];
+            size_t j = i;
+            do {
+                entries[j] = entries[j - 1];
+                slot[entries[j].body] = static_cast<uint32_t>(j);
+                --j;
+                ++lastSwaps;
+            } while (j > 0 && moving.minX < entries[j - 1].minX);
+            entries[j] = moving;
+            slot[moving.body] = static_cast<uint32_t>(j);
+        }
+    }
+
+    widestBox = 0.0f;
+    for (const Entry& entry : entries) {
+        widestBox = std::max(widestBox, entry.maxX - entry.minX);
+    }
+}
+
+void SweepAndPrune::getPotentialCollisions(std::vector<CollisionPair>& outPairs) const {
+    outPairs.clear();
+
+    const size_t count = entries.size();
+    for (size_t i = 0; i < count; ++i) {
+        const Entry& a = entries[i];
+        bool sleepingA = sleepFlags && sleepFlags[a.body];
+
+        // Only boxes that start before this one ends can overlap it
+        for (size_t j = i + 1; j < count && entries[j].minX <= a.maxX; ++j) {
+            const Entry& b = entries[j];
+            if (b.maxY < a.minY || b.minY > a.maxY) continue;
+            if (sleepingA && sleepFlags[b.body]) continue;  // Neither moves
+            outPairs.push_back({a.body, b.body});
+        }
+    }
+}
+
+/**
+ * Boxes overlapping min..max
+ * A box reaching past min.x starts at most widestBox before it, so a binary
+ * search skips everything further left and the scan stops past max.x
+ */
+void SweepAndPrune::queryRect(const sf::Vector2f& min, const sf::Vector2f& max, std::vector<uint32_t>& outBodies) const {
+    outBodies.clear();
+
+    float firstStart = min.x - widestBox;
+    auto first = std::lower_bound(entries.begin(), entries.end(), firstStart,
+        [](const Entry& entry, float x) { return entry.minX < x; });
+
+    for (auto it = first; it != entries.end() && it->minX <= max.x; ++it) {
+        if (it->maxX < min.x || it->maxY < min.y || it->minY > max.y) continue;
+        outBodies.push_back(it->body);
+    }
+}
+
+/**
+ * Boxes overlapping the ray's bounding box, cut short as hits come in
+ * The sort is along x only, so a ray is no better than its bounding box -
+ * a long diagonal ray tests everything under it. A ray going right can
+ * still stop early: boxes are met in x order, so once they start past the
+ * closest hit's x, all the rest do too.
+ */
+void SweepAndPrune::queryRay(const sf::Vector2f& origin, const sf::Vector2f& direction, float maxDistance,
+                             float thickness, RayVisitor& visitor) const {
+    sf::Vector2f end = origin + direction * maxDistance;
+    sf::Vector2f min(std::min(origin.x, end.x) - thickness, std::min(origin.y, end.y) - thickness);
+    sf::Vector2f max(std::max(origin.x, end.x) + thickness, std::max(origin.y, end.y) + thickness);
+
+    auto first = std::lower_bound(entries.begin(), entries.end(), min.x - widestBox,
+        [](const Entry& entry, float x) { return entry.minX < x; });
+
+    float distance = maxDistance;
+    for (auto it = first; it != entries.end() && it->minX <= max.x; ++it) {
+        if (it->maxX < min.x || it->maxY < min.y || it->minY > max.y) continue;
+        distance = std::min(distance, visitor.visit(it->body));
+        if (direction.x > 0.0f) {
+            max.x = std::min(max.x, origin.x + direction.x * distance + thickness);
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <vector>
+#include "BroadPhase.hpp"
+
+/**
+ * SWEEP AND PRUNE (SORT AND SWEEP) - PAIRS FROM ONE SORTED AXIS
+ * =============================================================
+ *
+ * IDEA: Sort every body's box by its left edge (minX). Two boxes can only
+ * overlap if their x-intervals overlap, and in sorted order that is easy
+ * to find - sweep left to right, and each box only needs to look at the
+ * boxes that START before it ENDS:
+ *
+ *   x →      0    10    20    30    40
+ *   A        [────────]
+ *   B              [──────]
+ *   C                        [────]
+ *
+ *   sweep A: B starts at 8 < A's end 14 → test (A,B); C starts at 24 → stop
+ *   sweep B: C starts at 24 > B's end 20 → stop
+ *
+ * Each x-overlap is then checked on y, so a pair is reported only if the
+ * boxes overlap on both axes. Cost: O(n + x-overlaps).
+ *
+ * WHY IT SUITS COHERENT MOTION:
+ * The sorted order is KEPT between steps. Bodies move a little each step,
+ * so last step's order is almost right and an INSERTION SORT fixes it:
+ *
+ *   last order:  A B C D E      D moved left past C
+ *   this step:   A B C D E  →   A B D C E      one swap
+ *
+ * Insertion sort costs O(n + swaps): close to O(n) when few bodies pass
+ * each other, whatever the world's size. A grid has no such memory - but
+ * it doesn't care about order, so it copes better with chaotic motion.
+ *
+ * WEAK SPOT: Many bodies sharing an x-range (a tall stack, a wall) are all
+ * x-overlaps, and the y test has to reject them one by one. A large world
+ * filled in 2D is the worst case - every box x-overlaps its whole column
+ * (the bodies50k benchmark: ~100 y tests per body). The grid does better there.
+ *
+ * After clear() (bodies added or removed, indices changed) the order is
+ * rebuilt with a full sort; the incremental sort takes over from the next step.
+ */
+class SweepAndPrune : public BroadPhase {
+public:
+    using BroadPhase::update;
+    void clear() override;
+    void insert(uint32_t bodyIndex, const sf::Vector2f& position, float radius) override;
+    bool update(uint32_t bodyIndex, const sf::Vector2f& min, const sf::Vector2f& max) override;
+    void rebuildIfDirty() override;  // Re-sort: full after clear(), incremental otherwise
+    void getPotentialCollisions(std::vector<CollisionPair>& outPairs) const override;
+    void queryRect(const sf::Vector2f& min, const sf::Vector2f& max, std::vector<uint32_t>& outBodies) const override;
+    void queryRay(const sf::Vector2f& origin, const sf::Vector2f& direction, float maxDistance,
+                  float thickness, RayVisitor& visitor) const override;
+    void setSleepFlags(const uint8_t* flags) override { sleepFlags = flags; }
+    size_t getBodyCount() const override { return slot.size(); }
+
+    // Entries moved by the last incremental sort (how coherent the motion was)
+    size_t getLastSwapCount() const { return lastSwaps; }
+
+private:
+    static constexpr uint32_t NO_SLOT = 0xFFFFFFFFu;
+
+    // One box in sort order; the whole box is kept here so the sweep reads
+    // consecutive memory instead of jumping around the body arrays
+    struct Entry {
+        float minX;
+        float maxX;
+        float minY;
+        float maxY;
+        uint32_t body;
+    };
+
+    std::vector<Entry> entries;    // Sorted by minX after rebuildIfDirty()
+    std::vector<uint32_t> slot;    // Body index → its position in entries
+    bool needsFullSort = false;
+    float widestBox = 0.0f;        // Widest box at the last sort (bounds queryRect's search)
+    size_t lastSwaps = 0;
+    const uint8_t* sleepFlags = nullptr;  // Not owned
+};
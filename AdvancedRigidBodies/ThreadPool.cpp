@@ -0,0 +1,72 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned threadCount) {
+    unsigned count = std::max(1u, threadCount);
+    for (unsigned i = 1; i < count; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    startCondition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::run(size_t count, void* task, TaskCall call) {
+    if (workers.empty() || count < 2) {
+        call(task, 0, 0, count);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentTask = task;
+        currentCall = call;
+        currentCount = count;
+        pendingWorkers = static_cast<unsigned>(workers.size());
+        ++jobGeneration;
+    }
+    startCondition.notify_all();
+
+    // The caller does its share instead of sitting idle
+    runChunk(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [this] { return pendingWorkers == 0; });
+    currentTask = nullptr;
+}
+
+void ThreadPool::runChunk(unsigned chunk) {
+    size_t chunks = getThreadCount();
+    size_t begin = currentCount * chunk / chunks;
+    size_t end = currentCount * (chunk + 1) / chunks;
+    if (begin < end) {
+        currentCall(currentTask, chunk, begin, end);
+    }
+}
+
+void ThreadPool::workerLoop(unsigned workerIndex) {
+    uint64_t lastJob = 0;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        startCondition.wait(lock, [&] { return stopping || jobGeneration != lastJob; });
+        if (stopping) return;
+        lastJob = jobGeneration;
+
+        lock.unlock();
+        runChunk(workerIndex);
+        lock.lock();
+
+        if (--pendingWorkers == 0) {
+            doneCondition.notify_one();
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * THREAD POOL - SPREADING WORK ACROSS CPU CORES
+ * =============================================
+ *
+ * Creating a std::thread costs tens of microseconds - far too slow to do every
+ * frame. A thread pool creates its worker threads ONCE and then hands them
+ * jobs for the rest of the program.
+ *
+ * HOW parallelFor() WORKS:
+ * - The range [0, count) is cut into one contiguous chunk per thread
+ * - Chunk 0 runs on the calling thread, chunk k on worker k
+ * - parallelFor() returns only when every chunk has finished
+ *
+ *     count = 10, 3 threads:  [0 1 2] [3 4 5] [6 7 8 9]
+ *                             caller  worker1  worker2
+ *
+ * DETERMINISM:
+ * The split depends only on count and the thread count - never on which
+ * thread happens to be fastest. Same inputs + same thread count = same chunks,
+ * so results can be reproduced exactly.
+ */
+class ThreadPool {
+public:
+    /**
+     * @param threadCount - Total threads including the caller (1 = run everything inline)
+     */
+    explicit ThreadPool(unsigned threadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned getThreadCount() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    /**
+     * Run task(chunkIndex, begin, end) on every chunk of [0, count)
+     * chunkIndex is in [0, getThreadCount()) - use it to pick per-thread scratch buffers
+     *
+     * NO ALLOCATION: a std::function parameter would copy a capturing lambda
+     * to the heap on every call - and the solver calls this once per colour
+     * batch per iteration. The task is only borrowed (it outlives the call),
+     * so all that is passed on is its address and a function that calls it.
+     */
+    template <typename Task>
+    void parallelFor(size_t count, Task&& task) {
+        using TaskType = std::remove_reference_t<Task>;
+        run(count, const_cast<void*>(static_cast<const void*>(std::addressof(task))),
+            [](void* object, unsigned chunk, size_t begin, size_t end) {
+                (*static_cast<TaskType*>(object))(chunk, begin, end);
+            });
+    }
+
+private:
+    using TaskCall = void (*)(void* task, unsigned chunk, size_t begin, size_t end);
+
+    void run(size_t count, void* task, TaskCall call);
+    void workerLoop(unsigned workerIndex);
+    void runChunk(unsigned chunk);
+
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable startCondition;  // Wakes workers when a job is posted
+    std::condition_variable doneCondition;   // Wakes the caller when workers finish
+
+    // Current job (only valid while a parallelFor() is running)
+    void* currentTask = nullptr;
+    TaskCall currentCall = nullptr;
+    size_t currentCount = 0;
+    uint64_t jobGeneration = 0;  // Incremented per job so workers can tell a new job from a spurious wakeup
+    unsigned pendingWorkers = 0;
+    bool stopping = false;
+};
@@ -0,0 +1,534 @@
+#include "TrajectoryRecorder.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    constexpr uint32_t FILE_MAGIC = 0x52544252u;     // "RBTR"
+    constexpr uint32_t CHUNK_MAGIC = 0x4B4E4843u;    // "CHNK"
+    constexpr uint32_t TRAILER_MAGIC = 0x58444E49u;  // "INDX"
+    constexpr uint32_t FILE_VERSION = 1;
+    constexpr size_t FILE_HEADER_BYTES = 16;   // magic, version, positionScale, keyframeInterval
+    constexpr size_t CHUNK_HEADER_BYTES = 16;  // magic, payload bytes, first frame, frame count
+    constexpr size_t TRAILER_BYTES = 16;       // index offset, chunk count, magic
+    constexpr uint32_t MAX_SLOT = 1u << 28;    // Sanity limit when reading damaged files
+
+    constexpr float TWO_PI = 6.2831853f;
+    constexpr float ANGLE_STEPS = 65536.0f;    // One turn in 16 bits
+
+    // Zigzag: small negative and positive numbers both become small unsigned ones
+    uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+    int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+    void putSigned(std::vector<uint8_t>& out, int64_t value) { putVarint(out, zigzag(value)); }
+
+    // Reads one varint; on running off the end (or an over-long number) ok becomes false
+    uint64_t getVarint(const std::vector<uint8_t>& in, size_t& cursor, bool& ok) {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (cursor >= in.size()) break;
+            uint8_t byte = in[cursor++];
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        ok = false;
+        return 0;
+    }
+
+    template <typename T>
+    void putRaw(std::vector<uint8_t>& out, size_t at, const T& value) {
+        std::memcpy(out.data() + at, &value, sizeof(T));
+    }
+    template <typename T>
+    T getRaw(const uint8_t* in) {
+        T value;
+        std::memcpy(&value, in, sizeof(T));
+        return value;
+    }
+
+    int32_t quantisePosition(float value, float scale) {
+        return static_cast<int32_t>(std::lround(value * scale));
+    }
+
+    // Rotation keeps growing as a body spins; only the angle within one turn is kept
+    uint16_t quantiseAngle(float radians) {
+        float turns = radians / TWO_PI;
+        turns -= std::floor(turns);
+        return static_cast<uint16_t>(static_cast<uint32_t>(std::lround(turns * ANGLE_STEPS)) & 0xFFFF);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// RECORDER
+// ----------------------------------------------------------------------------
+
+TrajectoryRecorder::~TrajectoryRecorder() {
+    if (recording) {
+        stop();
+    }
+}
+
+bool TrajectoryRecorder::start(const std::string& path, const TrajectorySettings& newSettings) {
+    if (recording) return false;
+
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+
+    settings = newSettings;
+    settings.positionScale = settings.positionScale > 0.0f ? settings.positionScale : 1.0f;
+    settings.keyframeInterval = std::max(1u, settings.keyframeInterval);
+
+    std::vector<uint8_t> header(FILE_HEADER_BYTES);
+    putRaw(header, 0, FILE_MAGIC);
+    putRaw(header, 4, FILE_VERSION);
+    putRaw(header, 8, settings.positionScale);
+    putRaw(header, 12, settings.keyframeInterval);
+    file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+    fileOffset = header.size();
+
+    slots.clear();
+    aliveSlots.clear();
+    chunkIndex.clear();
+    pending.clear();
+    frameCount = 0;
+    encodedBytes = 0;
+    rawBytes = 0;
+    stopping = false;
+    writeFailed = !file;
+
+    beginChunk();
+    recording = true;
+    writer = std::thread(&TrajectoryRecorder::writerLoop, this);
+    return true;
+}
+
+bool TrajectoryRecorder::stop() {
+    if (!recording) return false;
+
+    finishChunk();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+
+    file.close();
+    recording = false;
+    return !writeFailed;
+}
+
+void TrajectoryRecorder::beginChunk() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!spare.empty()) {
+            chunk = std::move(spare.back());
+            spare.pop_back();
+        }
+    }
+    chunk.assign(CHUNK_HEADER_BYTES, 0);  // Filled in by finishChunk()
+    chunkFirstFrame = frameCount;
+    chunkFrames = 0;
+}
+
+void TrajectoryRecorder::finishChunk() {
+    if (chunkFrames == 0) return;
+
+    putRaw(chunk, 0, CHUNK_MAGIC);
+    putRaw(chunk, 4, static_cast<uint32_t>(chunk.size() - CHUNK_HEADER_BYTES));
+    putRaw(chunk, 8, chunkFirstFrame);
+    putRaw(chunk, 12, chunkFrames);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(std::move(chunk));
+    }
+    wake.notify_one();
+    chunk = {};
+    chunkFrames = 0;
+}
+
+void TrajectoryRecorder::capture(const BodyStore& bodies) {
+    if (!recording) return;
+
+    size_t before = chunk.size();
+    if (chunkFrames == 0) {
+        encodeKeyframe(bodies);
+    } else {
+        encodeDelta(bodies);
+    }
+    encodedBytes += chunk.size() - before;
+    rawBytes += bodies.size() * 3 * sizeof(float);
+
+    ++frameCount;
+    if (++chunkFrames == settings.keyframeInterval) {
+        finishChunk();
+        beginChunk();
+    }
+}
+
+/**
+ * KEYFRAME: every body, absolute values
+ * The reader starts from nothing here, so slots that held a body before
+ * just aren't mentioned
+ */
+void TrajectoryRecorder::encodeKeyframe(const BodyStore& bodies) {
+    const uint32_t stamp = frameCount + 1;  // 0 = never seen
+    putVarint(chunk, bodies.size());
+
+    nextAlive.clear();
+    uint32_t previousSlot = 0;
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        BodyHandle handle = bodies.handleAt(i);
+        if (handle.slot >= slots.size()) slots.resize(handle.slot + 1);
+
+        SlotState& state = slots[handle.slot];
+        state.generation = handle.generation;
+        state.x = quantisePosition(bodies.positionX[i], settings.positionScale);
+        state.y = quantisePosition(bodies.positionY[i], settings.positionScale);
+        state.angle = quantiseAngle(bodies.rotation[i]);
+        state.alive = 1;
+        state.settled = bodies.isStatic[i] | bodies.isResting[i];
+        state.seenFrame = stamp;
+        nextAlive.push_back(handle.slot);
+
+        putSigned(chunk, static_cast<int64_t>(handle.slot) - previousSlot);
+        putVarint(chunk, state.generation);
+        putSigned(chunk, state.x);
+        putSigned(chunk, state.y);
+        putVarint(chunk, state.angle);
+        previousSlot = handle.slot;
+    }
+
+    for (uint32_t slot : aliveSlots) {
+        if (slots[slot].seenFrame != stamp) slots[slot].alive = 0;
+    }
+    aliveSlots.swap(nextAlive);
+}
+
+/**
+ * DELTA FRAME: only what changed since the previous frame
+ * - moved:   awake bodies whose quantised position or angle changed
+ * - added:   bodies in a slot that was empty (or held another body) last frame
+ * - removed: slots that held a body last frame and don't now
+ */
+void TrajectoryRecorder::encodeDelta(const BodyStore& bodies) {
+    const uint32_t stamp = frameCount + 1;
+    moved.clear();
+    added.clear();
+    removed.clear();
+    uint64_t movedCount = 0, addedCount = 0, removedCount = 0;
+    uint32_t movedSlot = 0, addedSlot = 0, removedSlot = 0;
+
+    nextAlive.clear();
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        BodyHandle handle = bodies.handleAt(i);
+        if (handle.slot >= slots.size()) slots.resize(handle.slot + 1);
+
+        SlotState& state = slots[handle.slot];
+        state.seenFrame = stamp;
+        nextAlive.push_back(handle.slot);
+
+        uint8_t settled = bodies.isStatic[i] | bodies.isResting[i];
+        if (!state.alive || state.generation != handle.generation) {
+            state.generation = handle.generation;
+            state.x = quantisePosition(bodies.positionX[i], settings.positionScale);
+            state.y = quantisePosition(bodies.positionY[i], settings.positionScale);
+            state.angle = quantiseAngle(bodies.rotation[i]);
+            state.alive = 1;
+            state.settled = settled;
+
+            putSigned(added, static_cast<int64_t>(handle.slot) - addedSlot);
+            putVarint(added, state.generation);
+            putSigned(added, state.x);
+            putSigned(added, state.y);
+            putVarint(added, state.angle);
+            addedSlot = handle.slot;
+            ++addedCount;
+            continue;
+        }
+
+        // Static and sleeping bodies don't move - nothing to quantise or compare.
+        // A body that fell asleep THIS step still moved in it, so it's written once more
+        bool wasSettled = state.settled;
+        state.settled = settled;
+        if (settled && wasSettled) continue;
+
+        int32_t x = quantisePosition(bodies.positionX[i], settings.positionScale);
+        int32_t y = quantisePosition(bodies.positionY[i], settings.positionScale);
+        uint16_t angle = quantiseAngle(bodies.rotation[i]);
+        if (x == state.x && y == state.y && angle == state.angle) continue;
+
+        putSigned(moved, static_cast<int64_t>(handle.slot) - movedSlot);
+        putSigned(moved, static_cast<int64_t>(x) - state.x);
+        putSigned(moved, static_cast<int64_t>(y) - state.y);
+        putSigned(moved, static_cast<int16_t>(static_cast<uint16_t>(angle - state.angle)));  // Shortest way round
+        movedSlot = handle.slot;
+        ++movedCount;
+
+        state.x = x;
+        state.y = y;
+        state.angle = angle;
+    }
+
+    for (uint32_t slot : aliveSlots) {
+        SlotState& state = slots[slot];
+        if (state.seenFrame == stamp) continue;
+        state.alive = 0;
+        putSigned(removed, static_cast<int64_t>(slot) - removedSlot);
+        removedSlot = slot;
+        ++removedCount;
+    }
+    aliveSlots.swap(nextAlive);
+
+    putVarint(chunk, movedCount);
+    chunk.insert(chunk.end(), moved.begin(), moved.end());
+    putVarint(chunk, addedCount);
+    chunk.insert(chunk.end(), added.begin(), added.end());
+    putVarint(chunk, removedCount);
+    chunk.insert(chunk.end(), removed.begin(), removed.end());
+}
+
+/**
+ * WRITER THREAD
+ * Writes full chunks in order and remembers where each one went; when
+ * stop() has been called and the queue is empty, appends the index
+ */
+void TrajectoryRecorder::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return stopping || !pending.empty(); });
+        if (pending.empty()) break;  // Stopping, and everything is written
+
+        std::vector<uint8_t> buffer = std::move(pending.front());
+        pending.pop_front();
+        lock.unlock();
+
+        ChunkIndexEntry entry;
+        entry.firstFrame = getRaw<uint32_t>(buffer.data() + 8);
+        entry.frameCount = getRaw<uint32_t>(buffer.data() + 12);
+        entry.offset = fileOffset;
+        chunkIndex.push_back(entry);
+
+        file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        fileOffset += buffer.size();
+        if (!file) writeFailed = true;
+
+        lock.lock();
+        spare.push_back(std::move(buffer));
+    }
+    lock.unlock();
+
+    // INDEX + TRAILER: entries, then where the index starts, how long it is, magic
+    uint64_t indexOffset = fileOffset;
+    file.write(reinterpret_cast<const char*>(chunkIndex.data()),
+               static_cast<std::streamsize>(chunkIndex.size() * sizeof(ChunkIndexEntry)));
+    std::vector<uint8_t> trailer(TRAILER_BYTES);
+    putRaw(trailer, 0, indexOffset);
+    putRaw(trailer, 8, static_cast<uint32_t>(chunkIndex.size()));
+    putRaw(trailer, 12, TRAILER_MAGIC);
+    file.write(reinterpret_cast<const char*>(trailer.data()), static_cast<std::streamsize>(trailer.size()));
+    file.flush();
+    if (!file) writeFailed = true;
+}
+
+// ----------------------------------------------------------------------------
+// READER
+// ----------------------------------------------------------------------------
+
+bool TrajectoryReader::open(const std::string& path) {
+    file.close();
+    file.clear();
+    chunks.clear();
+    slots.clear();
+    frameBodies.clear();
+    totalFrames = 0;
+    loadedChunk = SIZE_MAX;
+    hasFrame = false;
+    currentFrame = 0;
+
+    file.open(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+
+    uint8_t header[FILE_HEADER_BYTES];
+    file.seekg(0);
+    if (fileSize < FILE_HEADER_BYTES || !file.read(reinterpret_cast<char*>(header), sizeof(header))) return false;
+    if (getRaw<uint32_t>(header) != FILE_MAGIC || getRaw<uint32_t>(header + 4) != FILE_VERSION) return false;
+    positionScale = getRaw<float>(header + 8);
+
+    // Index from the trailer, if the recording was stopped properly
+    if (fileSize >= FILE_HEADER_BYTES + TRAILER_BYTES) {
+        uint8_t trailer[TRAILER_BYTES];
+        file.seekg(static_cast<std::streamoff>(fileSize - TRAILER_BYTES));
+        if (file.read(reinterpret_cast<char*>(trailer), sizeof(trailer)) &&
+            getRaw<uint32_t>(trailer + 12) == TRAILER_MAGIC) {
+            uint64_t indexOffset = getRaw<uint64_t>(trailer);
+            uint64_t count = getRaw<uint32_t>(trailer + 8);
+            if (indexOffset + count * sizeof(Chunk) + TRAILER_BYTES == fileSize) {
+                chunks.resize(static_cast<size_t>(count));
+                file.seekg(static_cast<std::streamoff>(indexOffset));
+                if (!file.read(reinterpret_cast<char*>(chunks.data()),
+                               static_cast<std::streamsize>(count * sizeof(Chunk)))) {
+                    chunks.clear();
+                }
+            }
+        }
+    }
+
+    // No trailer: walk the chunk headers until the file ends or stops making sense
+    if (chunks.empty()) {
+        file.clear();
+        uint64_t offset = FILE_HEADER_BYTES;
+        uint8_t chunkHeader[CHUNK_HEADER_BYTES];
+        while (offset + CHUNK_HEADER_BYTES <= fileSize) {
+            file.seekg(static_cast<std::streamoff>(offset));
+            if (!file.read(reinterpret_cast<char*>(chunkHeader), sizeof(chunkHeader))) break;
+            uint64_t payload = getRaw<uint32_t>(chunkHeader + 4);
+            if (getRaw<uint32_t>(chunkHeader) != CHUNK_MAGIC ||
+                offset + CHUNK_HEADER_BYTES + payload > fileSize) break;
+            chunks.push_back({getRaw<uint32_t>(chunkHeader + 8), getRaw<uint32_t>(chunkHeader + 12), offset});
+            offset += CHUNK_HEADER_BYTES + payload;
+        }
+    }
+
+    // Chunks must follow each other frame by frame, or seek() can't find anything
+    for (const Chunk& c : chunks) {
+        if (c.firstFrame != totalFrames || c.frameCount == 0) {
+            chunks.clear();
+            totalFrames = 0;
+            return false;
+        }
+        totalFrames += c.frameCount;
+    }
+    return true;
+}
+
+bool TrajectoryReader::loadChunk(size_t index) {
+    loadedChunk = SIZE_MAX;
+    const Chunk& c = chunks[index];
+
+    uint8_t header[CHUNK_HEADER_BYTES];
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(c.offset));
+    if (!file.read(reinterpret_cast<char*>(header), sizeof(header)) ||
+        getRaw<uint32_t>(header) != CHUNK_MAGIC) return false;
+
+    chunkData.resize(getRaw<uint32_t>(header + 4));
+    if (!file.read(reinterpret_cast<char*>(chunkData.data()), static_cast<std::streamsize>(chunkData.size()))) return false;
+
+    cursor = 0;
+    loadedChunk = index;
+    return true;
+}
+
+/**
+ * SEEK: find the chunk holding the frame, decode its keyframe, then apply
+ * deltas up to the frame. Moving forward inside the loaded chunk skips the
+ * keyframe and continues from the current frame.
+ */
+bool TrajectoryReader::seek(uint32_t frame) {
+    if (frame >= totalFrames) return false;
+
+    auto after = std::upper_bound(chunks.begin(), chunks.end(), frame,
+        [](uint32_t f, const Chunk& c) { return f < c.firstFrame; });
+    size_t index = static_cast<size_t>(after - chunks.begin()) - 1;
+    const Chunk& c = chunks[index];
+
+    bool continueForward = hasFrame && loadedChunk == index && currentFrame <= frame;
+    if (!continueForward) {
+        hasFrame = false;
+        if (!loadChunk(index) || !decodeFrame(true)) return false;
+        currentFrame = c.firstFrame;
+        hasFrame = true;
+    }
+    while (currentFrame < frame) {
+        if (!decodeFrame(false)) {
+            hasFrame = false;
+            return false;
+        }
+        ++currentFrame;
+    }
+
+    buildFrameBodies();
+    return true;
+}
+
+bool TrajectoryReader::decodeFrame(bool keyframe) {
+    bool ok = true;
+    auto readSlot = [&](uint32_t& previous) -> uint32_t {
+        int64_t slot = static_cast<int64_t>(previous) + unzigzag(getVarint(chunkData, cursor, ok));
+        if (slot < 0 || slot >= MAX_SLOT) {
+            ok = false;
+            return 0;
+        }
+        previous = static_cast<uint32_t>(slot);
+        if (previous >= slots.size()) slots.resize(previous + 1);
+        return previous;
+    };
+    auto readAbsolute = [&](uint32_t& previous) {
+        uint32_t slot = readSlot(previous);
+        if (!ok) return;
+        SlotState& state = slots[slot];
+        state.generation = static_cast<uint32_t>(getVarint(chunkData, cursor, ok));
+        state.x = static_cast<int32_t>(unzigzag(getVarint(chunkData, cursor, ok)));
+        state.y = static_cast<int32_t>(unzigzag(getVarint(chunkData, cursor, ok)));
+        state.angle = static_cast<uint16_t>(getVarint(chunkData, cursor, ok));
+        state.alive = 1;
+    };
+
+    if (keyframe) {
+        for (SlotState& state : slots) state.alive = 0;
+        uint64_t count = getVarint(chunkData, cursor, ok);
+        uint32_t previous = 0;
+        for (uint64_t k = 0; k < count && ok; ++k) readAbsolute(previous);
+        return ok;
+    }
+
+    uint64_t movedCount = getVarint(chunkData, cursor, ok);
+    uint32_t previous = 0;
+    for (uint64_t k = 0; k < movedCount && ok; ++k) {
+        uint32_t slot = readSlot(previous);
+        if (!ok) break;
+        SlotState& state = slots[slot];
+        state.x += static_cast<int32_t>(unzigzag(getVarint(chunkData, cursor, ok)));
+        state.y += static_cast<int32_t>(unzigzag(getVarint(chunkData, cursor, ok)));
+        state.angle = static_cast<uint16_t>(state.angle + unzigzag(getVarint(chunkData, cursor, ok)));
+        ok = ok && state.alive;
+    }
+
+    uint64_t addedCount = ok ? getVarint(chunkData, cursor, ok) : 0;
+    previous = 0;
+    for (uint64_t k = 0; k < addedCount && ok; ++k) readAbsolute(previous);
+
+    uint64_t removedCount = ok ? getVarint(chunkData, cursor, ok) : 0;
+    previous = 0;
+    for (uint64_t k = 0; k < removedCount && ok; ++k) {
+        uint32_t slot = readSlot(previous);
+        if (ok) slots[slot].alive = 0;
+    }
+    return ok;
+}
+
+void TrajectoryReader::buildFrameBodies() {
+    frameBodies.clear();
+    for (uint32_t slot = 0; slot < slots.size(); ++slot) {
+        const SlotState& state = slots[slot];
+        if (!state.alive) continue;
+        Body body;
+        body.handle = BodyHandle{slot, state.generation};
+        body.position = sf::Vector2f(state.x / positionScale, state.y / positionScale);
+        body.rotation = state.angle * (TWO_PI / ANGLE_STEPS);
+        frameBodies.push_back(body);
+    }
+}
@@ -0,0 +1,223 @@
+#pragma once
+#include <SFML/System/Vector2.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "BodyStore.hpp"
+
+/**
+ * TRAJECTORY RECORDING - EVERY STEP TO DISK, SMALL AND OFF THE SIM THREAD
+ * =======================================================================
+ *
+ * PROBLEM: Recording a run for analysis or replay means keeping every
+ * body's position and rotation for every step. Raw, that is 12 bytes per
+ * body per step - 10k bodies at 120 Hz write 14 MB a second, and writing it
+ * from the simulation thread stalls the step whenever the disk is slow.
+ *
+ * SOLUTION: Shrink the data, then let another thread write it
+ *
+ * 1. QUANTISE: positions become integers in 1/positionScale pixel units
+ *    (default 1/16 px, far below what anyone can see); rotations become
+ *    16-bit fractions of a turn
+ *
+ * 2. DELTA-ENCODE: store how much each body moved since the previous step,
+ *    not where it is. Deltas are small numbers, and small numbers are short
+ *    as VARINTS (7 bits per byte, high bit = "more bytes follow"):
+ *
+ *      value 5      → 00000101                      1 byte
+ *      value 300    → 10101100 00000010              2 bytes
+ *      negative deltas are ZIGZAG-mapped first: 0, -1, 1, -2, 2 → 0, 1, 2, 3, 4
+ *
+ * 3. SKIP WHAT DIDN'T CHANGE: static and sleeping bodies, and bodies whose
+ *    quantised values stayed the same, are not written at all. A settled
+ *    world costs almost nothing per step
+ *
+ * 4. KEYFRAMES: deltas only make sense from the frame before, so every
+ *    keyframeInterval frames a KEYFRAME stores absolute values. Frames are
+ *    grouped into CHUNKS that each start with a keyframe:
+ *
+ *      [header][chunk: K Δ Δ Δ ... Δ][chunk: K Δ Δ ...] ... [index][trailer]
+ *
+ *    The index at the end lists where every chunk starts, so the reader can
+ *    jump to frame n by decoding one keyframe and fewer than
+ *    keyframeInterval deltas (TrajectoryReader::seek)
+ *
+ * 5. BACKGROUND WRITER: capture() encodes into the current chunk's buffer
+ *    (a pass over the bodies - no I/O). A full chunk is handed to a writer
+ *    thread through a queue; written buffers come back for reuse, so
+ *    recording stops allocating once a few chunks have gone round
+ *
+ * Bodies are identified by their handle (slot + generation), so additions
+ * and removals between frames are recorded too.
+ *
+ * FRAME LAYOUT (all numbers varints, "±" = zigzag):
+ *   keyframe:  count, then per body: ±slot gap, generation, ±x, ±y, angle
+ *   delta:     moved:   count, then ±slot gap, ±dx, ±dy, ±dangle
+ *              added:   count, then ±slot gap, generation, ±x, ±y, angle
+ *              removed: count, then ±slot gap
+ * Slot gaps are from the previous record's slot (bodies mostly go in slot
+ * order, so the gap is usually 1 byte).
+ */
+struct TrajectorySettings {
+    float positionScale = 16.0f;      // Quantisation steps per pixel
+    uint32_t keyframeInterval = 120;  // Frames per chunk (one second at 120 Hz)
+};
+
+class TrajectoryRecorder {
+public:
+    TrajectoryRecorder() = default;
+    ~TrajectoryRecorder();
+
+    TrajectoryRecorder(const TrajectoryRecorder&) = delete;
+    TrajectoryRecorder& operator=(const TrajectoryRecorder&) = delete;
+
+    /**
+     * Create (or replace) the file and start the writer thread
+     * @return false if the file can't be created (or a recording is running)
+     */
+    bool start(const std::string& path, const TrajectorySettings& settings = {});
+
+    /**
+     * Write the last partial chunk and the index, and close the file
+     * Blocks until the writer thread has finished
+     * @return false if any write failed
+     */
+    bool stop();
+
+    bool isRecording() const { return recording; }
+
+    /**
+     * Record one frame (call once per physics step - PhysicsEngine does
+     * when a recorder is attached). Encodes on the calling thread; never
+     * waits for the disk.
+     */
+    void capture(const BodyStore& bodies);
+
+    // Stats for the current / last recording
+    uint32_t getFrameCount() const { return frameCount; }
+    uint64_t getEncodedBytes() const { return encodedBytes; }  // Frame data so far (without headers)
+    uint64_t getRawBytes() const { return rawBytes; }          // Same frames as plain floats (12 bytes per body)
+
+private:
+    struct SlotState {
+        uint32_t generation = 0;
+        int32_t x = 0;
+        int32_t y = 0;
+        uint16_t angle = 0;
+        uint8_t alive = 0;
+        uint8_t settled = 0;     // Static or asleep when last recorded - can't have moved since
+        uint32_t seenFrame = 0;  // Last frame the slot held a body
+    };
+
+    void beginChunk();
+    void finishChunk();
+    void encodeKeyframe(const BodyStore& bodies);
+    void encodeDelta(const BodyStore& bodies);
+    void writerLoop();
+
+    TrajectorySettings settings;
+    bool recording = false;
+
+    // Encoder state (simulation thread only)
+    std::vector<SlotState> slots;
+    std::vector<uint32_t> aliveSlots;     // Slots recorded alive in the previous frame
+    std::vector<uint32_t> nextAlive;      // Scratch: this frame's alive slots
+    std::vector<uint8_t> chunk;           // Chunk being filled
+    std::vector<uint8_t> moved, added, removed;  // Delta frame sections before they are joined
+    uint32_t chunkFirstFrame = 0;
+    uint32_t chunkFrames = 0;
+    uint32_t frameCount = 0;
+    uint64_t encodedBytes = 0;
+    uint64_t rawBytes = 0;
+
+    // Writer thread
+    struct ChunkIndexEntry {
+        uint32_t firstFrame;
+        uint32_t frameCount;
+        uint64_t offset;
+    };
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::vector<uint8_t>> pending;   // Full chunks waiting to be written, oldest first
+    std::vector<std::vector<uint8_t>> spare;    // Written chunks, returned for reuse
+    bool stopping = false;
+    std::ofstream file;                         // Writer thread only while recording
+    uint64_t fileOffset = 0;                    // Writer thread only while recording
+    std::vector<ChunkIndexEntry> chunkIndex;    // Writer thread only while recording
+    std::atomic<bool> writeFailed{false};
+};
+
+/**
+ * Reads a file written by TrajectoryRecorder, one frame at a time
+ *
+ *   reader.open("run.rbtr");
+ *   reader.seek(600);              // nearest keyframe, then the deltas up to 600
+ *   for (auto& body : reader.getBodies()) ...
+ *   reader.next();                 // frame 601
+ *
+ * Files cut short (the program died while recording) still open: without
+ * the trailer, the chunks are found by walking the chunk headers from the start.
+ */
+class TrajectoryReader {
+public:
+    struct Body {
+        BodyHandle handle;
+        sf::Vector2f position;
+        float rotation;  // Radians, 0 to 2π
+    };
+
+    bool open(const std::string& path);
+
+    uint32_t getFrameCount() const { return totalFrames; }
+    uint32_t getFrame() const { return currentFrame; }
+    float getPositionScale() const { return positionScale; }
+
+    /**
+     * Decode frame n (0 to getFrameCount() - 1)
+     * @return false if n is out of range or the file is damaged
+     */
+    bool seek(uint32_t frame);
+    bool next() { return seek(currentFrame + 1); }
+
+    // Bodies alive in the current frame, in slot order
+    const std::vector<Body>& getBodies() const { return frameBodies; }
+
+private:
+    struct Chunk {
+        uint32_t firstFrame;
+        uint32_t frameCount;
+        uint64_t offset;
+    };
+    struct SlotState {
+        uint32_t generation = 0;
+        int32_t x = 0;
+        int32_t y = 0;
+        uint16_t angle = 0;
+        uint8_t alive = 0;
+    };
+
+    bool loadChunk(size_t chunkIndex);
+    bool decodeFrame(bool keyframe);
+    void buildFrameBodies();
+
+    std::ifstream file;
+    float positionScale = 1.0f;
+    std::vector<Chunk> chunks;
+    uint32_t totalFrames = 0;
+
+    size_t loadedChunk = SIZE_MAX;
+    std::vector<uint8_t> chunkData;
+    size_t cursor = 0;          // Read position in chunkData
+    uint32_t currentFrame = 0;
+    bool hasFrame = false;      // currentFrame is decoded
+
+    std::vector<SlotState> slots;
+    std::vector<Body> frameBodies;
+};
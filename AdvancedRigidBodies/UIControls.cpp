@@ -2,6 +2,16 @@
 #include <sstream>
 #include <iomanip>
 
+namespace {
+    // Profiler panel layout (top right of the 1200px window)
+    constexpr float PROFILER_X = 880.0f;
+    constexpr float PROFILER_Y = 10.0f;
+    constexpr float PROFILER_WIDTH = 310.0f;
+    constexpr float PROFILER_LINE_HEIGHT = 16.0f;
+    constexpr float PROFILER_BAR_X = PROFILER_X + 200.0f;
+    constexpr float PROFILER_PIXELS_PER_MS = 20.0f;
+}
+
 UIControls::UIControls(sf::Font& f)
     : font(f),
       gravitySlider(f),
@@ -9,8 +19,9 @@ UIControls::UIControls(sf::Font& f)
       frictionSlider(f),
       titleText(f),
       instructionsText(f),
-      statsText(f) {
-    backgroundPanel.setSize(sf::Vector2f(300.0f, 650.0f));
+      statsText(f),
+      profilerText(f) {
+    backgroundPanel.setSize(sf::Vector2f(300.0f, 670.0f));
     backgroundPanel.setPosition(sf::Vector2f(10.0f, 10.0f));
     backgroundPanel.setFillColor(sf::Color(30, 30, 40, 230));
     backgroundPanel.setOutlineThickness(2.0f);
@@ -32,19 +43,37 @@ UIControls::UIControls(sf::Font& f)
         "C: Clear dynamic bodies\n"
         "G: Toggle gravity\n"
         "V: Toggle velocity vectors\n"
-        "T: Toggle motion trails\n"
-        "D: Toggle debug visualization\n\n"
-        "Debug shows:\n"
-        "- Contact points (red)\n"
-        "- Collision normals (cyan)\n"
-        "- Applied forces (orange)\n"
+        "T: Trails  B: Shader glow\n"
+        "D: Toggle debug visualization\n"
+        "S: Grid / sweep and prune\n"
+        "P: Profiler  F5: CSV  F6: Trace\n"
+        "F8: Save scene  F9: Load scene\n"
+        "R: Record trajectory\n"
+        "Wheel: Zoom  Arrows: Pan  Home: Reset\n\n"
+        "Debug shows (1-3 toggle):\n"
+        "1 Contact points (red)\n"
+        "2 Collision normals (cyan)\n"
+        "3 Applied forces (orange)\n"
         "- Rotation indicators (white)"
     );
 
     statsText.setCharacterSize(14);
-    statsText.setPosition(sf::Vector2f(20.0f, 590.0f));
+    statsText.setPosition(sf::Vector2f(20.0f, 610.0f));
     statsText.setFillColor(sf::Color(150, 255, 150));
 
+    profilerPanel.setPosition(sf::Vector2f(PROFILER_X, PROFILER_Y));
+    profilerPanel.setFillColor(sf::Color(30, 30, 40, 230));
+    profilerPanel.setOutlineThickness(2.0f);
+    profilerPanel.setOutlineColor(sf::Color(100, 100, 120));
+
+    profilerText.setCharacterSize(13);
+    profilerText.setPosition(sf::Vector2f(PROFILER_X + 10.0f, PROFILER_Y + 6.0f));
+    profilerText.setFillColor(sf::Color(200, 220, 255));
+
+    for (auto& bar : profilerBars) {
+        bar.setFillColor(sf::Color(120, 180, 255, 200));
+    }
+
     createSlider(gravitySlider, "Gravity", 20.0f, 60.0f, 0.0f, 1000.0f, 500.0f);
     createSlider(restitutionSlider, "Restitution", 20.0f, 140.0f, 0.0f, 1.0f, 0.6f);
     createSlider(frictionSlider, "Friction", 20.0f, 220.0f, 0.0f, 1.0f, 0.3f);
@@ -134,6 +163,44 @@ void UIControls::updateStats(int bodyCount, float fps) {
     statsText.setString(statsStream.str());
 }
 
+void UIControls::updateProfiler(const Profiler& profiler) {
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(2);
+    text << "Profiler (P): " << profiler.getAverageFrameMs() << " ms/frame";
+
+    if (!showProfiler) {
+        profilerPanel.setSize(sf::Vector2f(PROFILER_WIDTH, PROFILER_LINE_HEIGHT + 14.0f));
+        profilerText.setString(text.str());
+        return;
+    }
+
+    // One line per phase: name, average ms, and a bar 20px per ms
+    text << "\n";
+    for (size_t p = 0; p < Profiler::PHASE_COUNT; ++p) {
+        auto phase = static_cast<ProfilePhase>(p);
+        double ms = profiler.getAveragePhaseMs(phase);
+        text << "\n" << std::left << std::setw(16) << Profiler::getPhaseName(phase) << ms;
+
+        float barWidth = std::min(static_cast<float>(ms) * PROFILER_PIXELS_PER_MS, PROFILER_WIDTH - 210.0f);
+        profilerBars[p].setSize(sf::Vector2f(std::max(barWidth, 1.0f), PROFILER_LINE_HEIGHT - 6.0f));
+        profilerBars[p].setPosition(sf::Vector2f(PROFILER_BAR_X, PROFILER_Y + 9.0f + (p + 2) * PROFILER_LINE_HEIGHT));
+    }
+
+    // Counters from the newest finished frame
+    text << "\n";
+    if (profiler.getFrameCount() > 0) {
+        const Profiler::Frame& frame = profiler.getFrame(0);
+        for (size_t c = 0; c < Profiler::COUNTER_COUNT; ++c) {
+            text << "\n" << std::left << std::setw(20) << Profiler::getCounterName(static_cast<ProfileCounter>(c))
+                 << frame.counters[c];
+        }
+    }
+
+    size_t lines = 2 + Profiler::PHASE_COUNT + 1 + Profiler::COUNTER_COUNT;
+    profilerPanel.setSize(sf::Vector2f(PROFILER_WIDTH, lines * PROFILER_LINE_HEIGHT + 14.0f));
+    profilerText.setString(text.str());
+}
+
 void UIControls::draw(sf::RenderWindow& window) {
     window.draw(backgroundPanel);
     window.draw(titleText);
@@ -143,6 +210,14 @@ void UIControls::draw(sf::RenderWindow& window) {
     drawSlider(window, gravitySlider);
     drawSlider(window, restitutionSlider);
     drawSlider(window, frictionSlider);
+
+    window.draw(profilerPanel);
+    window.draw(profilerText);
+    if (showProfiler) {
+        for (const auto& bar : profilerBars) {
+            window.draw(bar);
+        }
+    }
 }
 
 void UIControls::handleEvent(const std::optional<sf::Event>& event, const sf::Vector2f& mousePos) {
@@ -178,5 +253,6 @@ void UIControls::handleEvent(const std::optional<sf::Event>& event, const sf::Ve
 }
 
 bool UIControls::isMouseOverUI(const sf::Vector2f& mousePos) const {
-    return backgroundPanel.getGlobalBounds().contains(mousePos);
+    return backgroundPanel.getGlobalBounds().contains(mousePos) ||
+           profilerPanel.getGlobalBounds().contains(mousePos);
 }
@@ -1,6 +1,8 @@
 #pragma once
 #include <SFML/Graphics.hpp>
+#include <array>
 #include <functional>
+#include "Profiler.hpp"
 
 class UIControls {
 public:
@@ -26,6 +28,14 @@ public:
 
     void updateStats(int bodyCount, float fps);
 
+    /**
+     * PROFILER PANEL (top right)
+     * Collapsed: one line with the average frame time
+     * Expanded:  per-phase times with bars, plus workload counters
+     */
+    void updateProfiler(const Profiler& profiler);
+    bool showProfiler = false;
+
 private:
     struct Slider {
         sf::RectangleShape background;
@@ -57,6 +67,10 @@ private:
 
     sf::RectangleShape backgroundPanel;
 
+    sf::RectangleShape profilerPanel;
+    sf::Text profilerText;
+    std::array<sf::RectangleShape, Profiler::PHASE_COUNT> profilerBars;
+
     float gravityValue = 500.0f;
     float restitutionValue = 0.6f;
     float frictionValue = 0.3f;
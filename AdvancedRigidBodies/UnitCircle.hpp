@@ -0,0 +1,72 @@
+#pragma once
+#include <SFML/System/Vector2.hpp>
+#include <array>
+
+/**
+ * PRECOMPUTED UNIT CIRCLES
+ * ========================
+ *
+ * Every glow, particle and body disc is a circle made of N triangle slices.
+ * The points of a circle with radius 1 never change, so instead of calling
+ * std::cos/std::sin for every slice of every circle every frame, we compute
+ * them ONCE - at compile time - and scale them:
+ *
+ *   point = centre + UNIT_CIRCLE<N>[i] * radius
+ *
+ *   16 segments × 3 glow layers × 2 trig calls = 96 trig calls per body
+ *   → 0 trig calls, one multiply-add per coordinate
+ *
+ * The table has N + 1 entries; the last repeats the first, so slice i always
+ * runs from point i to point i + 1 without a wrap-around check.
+ *
+ * WHY OUR OWN sin/cos?
+ * std::sin and std::cos are not constexpr in C++20. The Taylor series below
+ * converges to float precision within a few terms once the angle is in -π..π.
+ */
+namespace PhysicsUtils {
+    namespace detail {
+        constexpr double PI = 3.14159265358979323846;
+
+        // Taylor series around 0: x - x³/3! + x⁵/5! - ...
+        constexpr double taylorSin(double x) {
+            double term = x;
+            double sum = x;
+            for (int n = 1; n < 12; ++n) {
+                term *= -x * x / ((2 * n) * (2 * n + 1));
+                sum += term;
+            }
+            return sum;
+        }
+
+        // 1 - x²/2! + x⁴/4! - ...
+        constexpr double taylorCos(double x) {
+            double term = 1.0;
+            double sum = 1.0;
+            for (int n = 1; n < 12; ++n) {
+                term *= -x * x / ((2 * n - 1) * (2 * n));
+                sum += term;
+            }
+            return sum;
+        }
+
+        template <int Segments>
+        constexpr std::array<sf::Vector2f, Segments + 1> makeUnitCircle() {
+            std::array<sf::Vector2f, Segments + 1> points{};
+            for (int i = 0; i <= Segments; ++i) {
+                // Map i to an angle in -π..π, where the series is accurate
+                double angle = 2.0 * PI * (i % Segments) / Segments;
+                if (angle > PI) angle -= 2.0 * PI;
+                points[i] = sf::Vector2f(static_cast<float>(taylorCos(angle)),
+                                         static_cast<float>(taylorSin(angle)));
+            }
+            return points;
+        }
+    }
+
+    /**
+     * Unit circle with the given number of segments, built at compile time
+     * Usage: for (int i = 0; i < 16; ++i) { UNIT_CIRCLE<16>[i], UNIT_CIRCLE<16>[i + 1] ... }
+     */
+    template <int Segments>
+    inline constexpr std::array<sf::Vector2f, Segments + 1> UNIT_CIRCLE = detail::makeUnitCircle<Segments>();
+}
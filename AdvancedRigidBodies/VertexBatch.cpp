@@ -0,0 +1,32 @@
+#include "VertexBatch.hpp"
+
+VertexBatch::VertexBatch(sf::PrimitiveType type)
+    : primitiveType(type), buffer(type, sf::VertexBuffer::Usage::Stream) {
+}
+
+sf::Vertex* VertexBatch::begin(size_t maxVertices) {
+    if (vertices.size() < maxVertices) {
+        vertices.resize(maxVertices);
+    }
+    count = 0;
+    return vertices.data();
+}
+
+void VertexBatch::end(const sf::Vertex* writeEnd) {
+    count = static_cast<size_t>(writeEnd - vertices.data());
+}
+
+void VertexBatch::draw(sf::RenderTarget& target, const sf::RenderStates& states) {
+    if (count == 0) return;
+
+    if (streaming && sf::VertexBuffer::isAvailable()) {
+        // Recreate only when the CPU-side storage has grown past the buffer
+        bool ready = buffer.getVertexCount() >= vertices.size() || buffer.create(vertices.size());
+        if (ready && buffer.update(vertices.data(), count, 0)) {
+            target.draw(buffer, 0, count, states);
+            return;
+        }
+    }
+
+    target.draw(vertices.data(), count, primitiveType, states);
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+/**
+ * VERTEX BATCH - ONE DRAW CALL, MEMORY REUSED EVERY FRAME
+ * =======================================================
+ *
+ * sf::VertexArray::clear() + append() looks cheap, but append() checks the
+ * capacity on every vertex and the array is refilled from empty each frame.
+ * A batch instead:
+ * - grows its storage only when a frame needs MORE vertices than ever before
+ * - hands out a raw pointer that the caller overwrites in place
+ * - draws everything written this frame in a single call
+ *
+ *   sf::Vertex* out = batch.begin(maxVertices);   // Make room (rarely allocates)
+ *   *out++ = ...;                                 // Write vertices
+ *   batch.end(out);                               // Remember how many
+ *   batch.draw(target);
+ *
+ * STREAMING UPLOAD (optional):
+ * Drawing from a pointer sends the vertices to the GPU inside the draw call.
+ * With streaming on, they are copied once into a persistent sf::VertexBuffer
+ * created with the Stream usage hint (rewritten every frame, drawn once),
+ * which lets the driver pick memory suited to that pattern.
+ * Falls back to the pointer draw if vertex buffers are unsupported.
+ */
+class VertexBatch {
+public:
+    explicit VertexBatch(sf::PrimitiveType type);
+
+    /**
+     * Start a new frame of vertices
+     * @param maxVertices - Upper bound on what will be written before end()
+     * @return Where to write the first vertex
+     */
+    sf::Vertex* begin(size_t maxVertices);
+
+    // Finish writing; writeEnd is one past the last vertex written
+    void end(const sf::Vertex* writeEnd);
+
+    void draw(sf::RenderTarget& target, const sf::RenderStates& states = sf::RenderStates::Default);
+
+    void setStreaming(bool enabled) { streaming = enabled; }
+    size_t getVertexCount() const { return count; }
+
+private:
+    sf::PrimitiveType primitiveType;
+    std::vector<sf::Vertex> vertices;  // Only ever grows
+    size_t count = 0;
+
+    bool streaming = false;
+    sf::VertexBuffer buffer;
+};
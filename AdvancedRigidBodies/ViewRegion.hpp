@@ -0,0 +1,80 @@
+#pragma once
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * VIEW REGION - WHAT THE CAMERA CAN SEE
+ * =====================================
+ *
+ * With an sf::View the world can be far bigger than the window. Anything
+ * outside the view still costs vertices, uploads and (clipped) triangles,
+ * so the renderer asks for the visible rectangle first and skips the rest:
+ *
+ *   world:  ┌────────────────────────────────────┐
+ *           │   o      o    ┌──────────┐    o    │
+ *           │       o       │  o    o  │         │   only the bodies inside
+ *           │  o            │     o    │  o      │   the view are written
+ *           │        o      └──────────┘         │
+ *           └────────────────────────────────────┘
+ *
+ * The same zoom tells us how big a body is ON SCREEN (pixelsPerUnit), which
+ * drives level of detail: a 20-unit body zoomed out to 2 pixels does not
+ * need 30 triangles.
+ */
+struct ViewRegion {
+    sf::Vector2f min;            // World-space bounds of the visible area
+    sf::Vector2f max;
+    float pixelsPerUnit = 1.0f;  // Screen pixels per world unit (1 = no zoom)
+
+    /**
+     * Visible region of the target's current view
+     * Maps the four window corners back into the world, so a rotated view
+     * gets the bounding box of what it shows
+     */
+    static ViewRegion fromTarget(const sf::RenderTarget& target) {
+        sf::Vector2i size(target.getSize());
+        const sf::Vector2i corners[4] = {{0, 0}, {size.x, 0}, {0, size.y}, {size.x, size.y}};
+
+        ViewRegion region;
+        region.min = region.max = target.mapPixelToCoords(corners[0]);
+        for (const sf::Vector2i& corner : corners) {
+            sf::Vector2f world = target.mapPixelToCoords(corner);
+            region.min = sf::Vector2f(std::min(region.min.x, world.x), std::min(region.min.y, world.y));
+            region.max = sf::Vector2f(std::max(region.max.x, world.x), std::max(region.max.y, world.y));
+        }
+
+        // One window width in pixels covers this many world units
+        sf::Vector2f across = target.mapPixelToCoords(corners[1]) - target.mapPixelToCoords(corners[0]);
+        float worldWidth = std::sqrt(across.x * across.x + across.y * across.y);
+        if (worldWidth > 0.0f) {
+            region.pixelsPerUnit = size.x / worldWidth;
+        }
+        return region;
+    }
+
+    // Same region grown by margin world units on every side
+    ViewRegion inflated(float margin) const {
+        ViewRegion region = *this;
+        region.min -= sf::Vector2f(margin, margin);
+        region.max += sf::Vector2f(margin, margin);
+        return region;
+    }
+
+    // Could a circle at centre with this radius be visible?
+    bool overlaps(sf::Vector2f centre, float radius) const {
+        return centre.x + radius >= min.x && centre.x - radius <= max.x &&
+               centre.y + radius >= min.y && centre.y - radius <= max.y;
+    }
+
+    // Could any part of the segment a-b be visible? (conservative: only
+    // rejects segments lying entirely beyond one edge)
+    bool overlapsSegment(sf::Vector2f a, sf::Vector2f b) const {
+        return !((a.x < min.x && b.x < min.x) || (a.x > max.x && b.x > max.x) ||
+                 (a.y < min.y && b.y < min.y) || (a.y > max.y && b.y > max.y));
+    }
+
+    // World length → length on screen in pixels
+    float toPixels(float worldLength) const { return worldLength * pixelsPerUnit; }
+};
@@ -0,0 +1,517 @@
+/**
+ * HEADLESS BENCHMARK - MEASURING THE SIMULATION, NOT THE SCREEN
+ * =============================================================
+ *
+ * The demo caps at 60 FPS and spends most of each frame drawing, so it can't
+ * tell you how fast the PHYSICS is. This program runs the engine with no
+ * window at all, through scripted scenarios, and reports:
+ *
+ * - ms/step:     wall-clock time per physics step
+ * - pairs/step:  broad-phase candidate pairs (how well the grid filters)
+ * - contacts/step: pairs that actually overlapped
+ * - allocs/step: heap allocations per step (should be ~0 once warmed up)
+ * - asleep:      bodies asleep at the end of the run (island sleeping)
+ * - passed:      dynamic bodies right of x = Scenario::wallX at the end
+ *                (scenarios with a wall only - tunnelling check)
+ *
+ * USAGE:
+ *   Benchmark [--steps N] [--warmup N] [--threads N] [--scenario NAME] [--profile 1]
+ *             [--simd scalar|sse2|avx2|avx512] [--particles N] [--grid auto|dense|hashed]
+ *             [--levels N] [--cell PIXELS] [--sleep 0|1] [--ccd 0|1]
+ *             [--broadphase all|grid|sap] [--deterministic 0|1]
+ *             [--save DIR] [--load DIR] [--record DIR]
+ *
+ * --broadphase picks the broad phase (default all: every scenario runs once
+ *   with each, so the grid and sweep and prune can be compared line by line).
+ * --profile 1 adds a per-phase breakdown (integrate, grid, pairs, ...) per scenario.
+ * --particles sets the impact particle budget (default ParticleSystem::DEFAULT_BUDGET).
+ * --grid forces the spatial grid storage (auto = dense unless the world is huge).
+ *   The cells column shows how many cells the grid holds after the run.
+ * --levels caps the grid levels (1 = one fixed grid for all body sizes).
+ * --cell sets the level-0 cell size (default 100). On the boulders scenario,
+ *   compare the default with --levels 1 (fixed 100px grid) and with
+ *   --levels 1 --cell 500 (a fixed grid coarse enough for the boulders).
+ * --sleep 0 keeps every body awake (compare on the heaps scenario).
+ * --ccd 0 turns off continuous collision for fast bodies (bullets scenario;
+ *   the passed column counts bullets that got through the wall).
+ * --deterministic 1 solves in stable order and prints the final state hash
+ *   per run: it must not change with --threads or --broadphase.
+ * --save DIR writes each scenario's world to DIR/<scenario>.snap after the
+ *   run (first broad phase only); --load DIR starts from that file instead of
+ *   the scenario's setup. Settle a big pile once, then measure it settled:
+ *     Benchmark --scenario pile --steps 3000 --save fixtures
+ *     Benchmark --scenario pile --warmup 0 --load fixtures
+ * --record DIR records the measured steps to DIR/<scenario>-<broad>.rbtr and
+ *   prints the size against raw floats (the record phase in --profile 1 is
+ *   the encoding cost left on the simulation thread).
+ *
+ * BUILDING ON LINUX (no Visual Studio, no display needed):
+ *   g++ -std=c++20 -O2 -pthread -IAdvancedRigidBodies Benchmark/Benchmark.cpp \
+ *       AdvancedRigidBodies/{BodyStore,ContactSolver,ContinuousCollision,DebugDraw,HierarchicalGrid,ImpactQueue,Integrator,IslandManager,ParticleSystem,PhysicsEngine,Profiler,RigidBody,Snapshot,SpatialGrid,SweepAndPrune,ThreadPool,TrajectoryRecorder,VertexBatch}.cpp \
+ *       -lsfml-graphics -lsfml-system -o rigidbody-bench
+ *
+ * Only simulation sources are compiled - no Main.cpp, UIControls or PhysicsRenderer.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+#include "PhysicsEngine.hpp"
+
+/**
+ * ALLOCATION COUNTING
+ * Replacing the global operator new lets us count every heap allocation made
+ * by the engine (and the standard library on its behalf)
+ */
+static std::atomic<uint64_t> allocationCount{0};
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+    constexpr float STEP_TIME = 1.0f / 120.0f;
+
+    struct Scenario {
+        const char* name;
+        float worldWidth;
+        float worldHeight;
+        std::function<void(PhysicsEngine&, std::mt19937&)> setup;
+        std::function<void(PhysicsEngine&, std::mt19937&, int step)> perStep;  // Optional
+        float wallX = 0.0f;  // > 0: count the dynamic bodies that ended up past this x
+    };
+
+    RigidBody makeDynamicBody(const sf::Vector2f& position, float radius) {
+        float mass = radius / 5.0f;
+        return RigidBody(position, radius, mass, sf::Color(200, 120, 80));
+    }
+
+    /**
+     * UNIFORM: N bodies spread evenly, world sized so density stays constant
+     * Tests how cost scales with body count alone
+     */
+    Scenario makeUniform(const char* name, int count) {
+        float side = std::sqrt(static_cast<float>(count)) * 40.0f;
+        return Scenario{name, side, side,
+            [count, side](PhysicsEngine& physics, std::mt19937& gen) {
+                std::uniform_real_distribution<float> pos(10.0f, side - 10.0f);
+                std::uniform_real_distribution<float> radius(3.0f, 8.0f);
+                std::uniform_real_distribution<float> vel(-100.0f, 100.0f);
+                for (int i = 0; i < count; ++i) {
+                    RigidBody body = makeDynamicBody(sf::Vector2f(pos(gen), pos(gen)), radius(gen));
+                    body.setVelocity(sf::Vector2f(vel(gen), vel(gen)));
+                    physics.addBody(body);
+                }
+            },
+            nullptr};
+    }
+
+    std::vector<Scenario> makeScenarios() {
+        std::vector<Scenario> scenarios;
+
+        // RAIN: bodies keep arriving at the top (growing workload, fresh contacts)
+        scenarios.push_back({"rain", 1600.0f, 1000.0f,
+            nullptr,
+            [](PhysicsEngine& physics, std::mt19937& gen, int) {
+                if (physics.getBodyCount() >= 3000) return;
+                std::uniform_real_distribution<float> x(20.0f, 1580.0f);
+                std::uniform_real_distribution<float> radius(4.0f, 10.0f);
+                for (int i = 0; i < 4; ++i) {
+                    physics.addBody(makeDynamicBody(sf::Vector2f(x(gen), 20.0f), radius(gen)));
+                }
+            }});
+
+        // PILE: a dense heap of small bodies (many long-lived contacts, deep stacks)
+        scenarios.push_back({"pile", 800.0f, 800.0f,
+            [](PhysicsEngine& physics, std::mt19937& gen) {
+                std::uniform_real_distribution<float> jitter(-1.0f, 1.0f);
+                for (int row = 0; row < 50; ++row) {
+                    for (int col = 0; col < 50; ++col) {
+                        sf::Vector2f pos(20.0f + col * 15.5f + jitter(gen), 790.0f - row * 15.5f);
+                        physics.addBody(makeDynamicBody(pos, 7.0f));
+                    }
+                }
+            },
+            nullptr});
+
+        // PEGS: a Galton board - many static bodies, dynamic bodies bouncing through
+        scenarios.push_back({"pegs", 1600.0f, 1200.0f,
+            [](PhysicsEngine& physics, std::mt19937& gen) {
+                for (int row = 0; row < 15; ++row) {
+                    for (int col = 0; col < 30; ++col) {
+                        float offset = (row % 2) ? 26.0f : 0.0f;
+                        sf::Vector2f pos(40.0f + col * 52.0f + offset, 300.0f + row * 55.0f);
+                        physics.addBody(RigidBody(pos, 8.0f, 10.0f, sf::Color(80, 80, 90), true));
+                    }
+                }
+                std::uniform_real_distribution<float> x(20.0f, 1580.0f);
+                std::uniform_real_distribution<float> y(20.0f, 250.0f);
+                std::uniform_real_distribution<float> radius(4.0f, 8.0f);
+                for (int i = 0; i < 1500; ++i) {
+                    physics.addBody(makeDynamicBody(sf::Vector2f(x(gen), y(gen)), radius(gen)));
+                }
+            },
+            nullptr});
+
+        scenarios.push_back(makeUniform("bodies1k", 1000));
+        scenarios.push_back(makeUniform("bodies10k", 10000));
+        scenarios.push_back(makeUniform("bodies50k", 50000));
+
+        // BOULDERS: small bodies raining onto a field of huge ones (mixed sizes)
+        // A fixed 100px grid puts each boulder in dozens of cells
+        scenarios.push_back({"boulders", 4000.0f, 2500.0f,
+            [](PhysicsEngine& physics, std::mt19937& gen) {
+                std::uniform_real_distribution<float> x(300.0f, 3700.0f);
+                std::uniform_real_distribution<float> y(800.0f, 2200.0f);
+                std::uniform_real_distribution<float> boulderRadius(100.0f, 250.0f);
+                for (int i = 0; i < 60; ++i) {
+                    physics.addBody(makeDynamicBody(sf::Vector2f(x(gen), y(gen)), boulderRadius(gen)));
+                }
+                std::uniform_real_distribution<float> smallX(20.0f, 3980.0f);
+                std::uniform_real_distribution<float> smallY(20.0f, 2480.0f);
+                std::uniform_real_distribution<float> radius(4.0f, 10.0f);
+                for (int i = 0; i < 8000; ++i) {
+                    physics.addBody(makeDynamicBody(sf::Vector2f(smallX(gen), smallY(gen)), radius(gen)));
+                }
+            },
+            nullptr});
+
+        // HEAPS: 50 heaps in bins between static dividers; every second a body
+        // drops into one of them. Settled heaps sleep; a drop wakes its own heap only
+        // (dividers are static, so they don't join the heaps into one island)
+        scenarios.push_back({"heaps", 10000.0f, 800.0f,
+            [](PhysicsEngine& physics, std::mt19937&) {
+                for (int divider = 0; divider <= 50; ++divider) {
+                    physics.addBody(RigidBody(sf::Vector2f(divider * 200.0f, 780.0f), 70.0f, 10.0f,
+                                              sf::Color(80, 80, 90), true));
+                }
+                for (int heap = 0; heap < 50; ++heap) {
+                    for (int row = 0; row < 6; ++row) {
+                        for (int col = 0; col < 6; ++col) {
+                            sf::Vector2f pos(62.0f + heap * 200.0f + col * 15.2f, 790.0f - row * 15.2f);
+                            physics.addBody(makeDynamicBody(pos, 7.0f));
+                        }
+                    }
+                }
+            },
+            [](PhysicsEngine& physics, std::mt19937& gen, int step) {
+                if (step % 120 != 0) return;
+                std::uniform_int_distribution<int> heap(0, 49);
+                physics.addBody(makeDynamicBody(sf::Vector2f(100.0f + heap(gen) * 200.0f, 500.0f), 7.0f));
+            }});
+
+        // BULLETS: small bodies fired at 6000px/s into a wall of static pegs
+        // 50px per step - far more than a peg is wide, so without continuous
+        // collision most of them jump straight through
+        scenarios.push_back({"bullets", 1600.0f, 800.0f,
+            [](PhysicsEngine& physics, std::mt19937&) {
+                physics.setGravity(sf::Vector2f(0.0f, 0.0f));
+                for (int row = 0; row < 80; ++row) {  // Touching pegs, floor to ceiling
+                    physics.addBody(RigidBody(sf::Vector2f(1000.0f, 5.0f + row * 10.0f), 5.0f, 10.0f,
+                                              sf::Color(80, 80, 90), true));
+                }
+            },
+            [](PhysicsEngine& physics, std::mt19937& gen, int step) {
+                if (step % 10 != 0 || physics.getBodyCount() >= 2000) return;
+                std::uniform_real_distribution<float> y(20.0f, 780.0f);
+                for (int i = 0; i < 10; ++i) {
+                    RigidBody body = makeDynamicBody(sf::Vector2f(40.0f, y(gen)), 4.0f);
+                    body.setVelocity(sf::Vector2f(6000.0f, 0.0f));
+                    physics.addBody(body);
+                }
+            },
+            1000.0f});
+
+        // CHURN: 10k bodies; every 30 steps 2000 random ones are removed by
+        // handle and 2000 new ones spawned as one batch (reserve + addBodies +
+        // swap-and-pop removal - allocations should stay flat)
+        auto churnHandles = std::make_shared<std::vector<BodyHandle>>();
+        auto churnBatch = std::make_shared<std::vector<RigidBody>>();
+        auto spawnChurn = [churnHandles, churnBatch](PhysicsEngine& physics, std::mt19937& gen, int count) {
+            std::uniform_real_distribution<float> pos(10.0f, 3990.0f);
+            std::uniform_real_distribution<float> radius(3.0f, 8.0f);
+            std::uniform_real_distribution<float> vel(-100.0f, 100.0f);
+            churnBatch->clear();
+            for (int i = 0; i < count; ++i) {
+                RigidBody body = makeDynamicBody(sf::Vector2f(pos(gen), pos(gen)), radius(gen));
+                body.setVelocity(sf::Vector2f(vel(gen), vel(gen)));
+                churnBatch->push_back(body);
+            }
+            physics.addBodies(*churnBatch, churnHandles.get());
+        };
+        scenarios.push_back({"churn", 4000.0f, 4000.0f,
+            [churnHandles, spawnChurn](PhysicsEngine& physics, std::mt19937& gen) {
+                churnHandles->clear();
+                physics.reserve(10000);
+                spawnChurn(physics, gen, 10000);
+            },
+            [churnHandles, spawnChurn](PhysicsEngine& physics, std::mt19937& gen, int step) {
+                constexpr size_t CHURN = 2000;
+                if (step % 30 != 29) return;
+                // Move 2000 random handles to the back, remove them, spawn replacements
+                std::vector<BodyHandle>& handles = *churnHandles;
+                for (size_t k = 0; k < CHURN; ++k) {
+                    std::uniform_int_distribution<size_t> pick(0, handles.size() - 1 - k);
+                    std::swap(handles[pick(gen)], handles[handles.size() - 1 - k]);
+                }
+                physics.removeBodies(std::span<const BodyHandle>(handles.end() - CHURN, handles.end()));
+                handles.resize(handles.size() - CHURN);
+                spawnChurn(physics, gen, static_cast<int>(CHURN));
+            },
+            0.0f});
+
+        // SPARSE: a 100k × 100k world with a few hundred small clusters
+        // Almost every cell is empty - what the hashed grid is for
+        scenarios.push_back({"sparse", 100000.0f, 100000.0f,
+            [](PhysicsEngine& physics, std::mt19937& gen) {
+                std::uniform_real_distribution<float> centre(1000.0f, 99000.0f);
+                std::uniform_real_distribution<float> offset(-300.0f, 300.0f);
+                std::uniform_real_distribution<float> radius(3.0f, 8.0f);
+                for (int cluster = 0; cluster < 200; ++cluster) {
+                    sf::Vector2f middle(centre(gen), centre(gen));
+                    for (int i = 0; i < 100; ++i) {
+                        physics.addBody(makeDynamicBody(middle + sf::Vector2f(offset(gen), offset(gen)), radius(gen)));
+                    }
+                }
+            },
+            nullptr});
+
+        // RUNAWAY: one absurdly large body (20000 cells across on a single 100px level)
+        // beside ordinary clusters. Its range must stay capped through every update
+        // and swept box (SpatialGrid::MAX_HASHED_BODY_SPAN) - uncapped, the hashed
+        // grid asks for billions of entries and the run dies in the first steps
+        scenarios.push_back({"runaway", 20000000.0f, 20000000.0f,
+            [](PhysicsEngine& physics, std::mt19937& gen) {
+                physics.setMaxGridLevels(1);
+                sf::Vector2f middle(10000000.0f, 10000000.0f);
+                std::uniform_real_distribution<float> centre(1000.0f, 19999000.0f);
+                std::uniform_real_distribution<float> offset(-300.0f, 300.0f);
+                std::uniform_real_distribution<float> radius(3.0f, 8.0f);
+                for (int cluster = 0; cluster < 20;) {
+                    sf::Vector2f clusterMiddle(centre(gen), centre(gen));
+                    sf::Vector2f away = clusterMiddle - middle;
+                    if (std::max(std::abs(away.x), std::abs(away.y)) < 2000000.0f) continue;  // Clear of the giant
+                    for (int i = 0; i < 100; ++i) {
+                        physics.addBody(makeDynamicBody(clusterMiddle + sf::Vector2f(offset(gen), offset(gen)), radius(gen)));
+                    }
+                    ++cluster;
+                }
+                physics.addBody(makeDynamicBody(middle, 1000000.0f));
+            },
+            nullptr});
+        return scenarios;
+    }
+
+    struct Options {
+        int steps = 600;
+        int warmup = 60;
+        unsigned threads = 1;
+        std::string scenario;  // Empty = all
+        bool profile = false;
+        SimdLevel simd = Integrator::detectSimdLevel();
+        size_t particleBudget = ParticleSystem::DEFAULT_BUDGET;
+        const char* grid = "auto";
+        int gridLevels = HierarchicalGrid::MAX_LEVELS;
+        float cellSize = 0.0f;  // 0 = engine default
+        bool sleeping = true;
+        bool continuousCollision = true;
+        bool deterministic = false;
+        std::string saveDir;  // Empty = don't save
+        std::string loadDir;  // Empty = build the scene with the scenario's setup
+        std::string recordDir;  // Empty = don't record
+        std::vector<BroadPhaseType> broadPhases{BroadPhaseType::Grid, BroadPhaseType::SweepAndPrune};
+    };
+
+    SimdLevel parseSimdLevel(const char* name) {
+        if (std::strcmp(name, "scalar") == 0) return SimdLevel::Scalar;
+        if (std::strcmp(name, "sse2") == 0) return SimdLevel::SSE2;
+        if (std::strcmp(name, "avx2") == 0) return SimdLevel::AVX2;
+        return SimdLevel::AVX512;
+    }
+
+    Options parseOptions(int argc, char** argv) {
+        Options options;
+        for (int i = 1; i + 1 < argc; i += 2) {
+            if (std::strcmp(argv[i], "--steps") == 0) options.steps = std::max(1, std::atoi(argv[i + 1]));
+            else if (std::strcmp(argv[i], "--warmup") == 0) options.warmup = std::max(0, std::atoi(argv[i + 1]));
+            else if (std::strcmp(argv[i], "--threads") == 0) options.threads = static_cast<unsigned>(std::max(1, std::atoi(argv[i + 1])));
+            else if (std::strcmp(argv[i], "--scenario") == 0) options.scenario = argv[i + 1];
+            else if (std::strcmp(argv[i], "--simd") == 0) options.simd = parseSimdLevel(argv[i + 1]);
+            else if (std::strcmp(argv[i], "--profile") == 0) options.profile = std::atoi(argv[i + 1]) != 0;
+            else if (std::strcmp(argv[i], "--particles") == 0) options.particleBudget = static_cast<size_t>(std::max(0, std::atoi(argv[i + 1])));
+            else if (std::strcmp(argv[i], "--grid") == 0) options.grid = argv[i + 1];
+            else if (std::strcmp(argv[i], "--levels") == 0) options.gridLevels = std::atoi(argv[i + 1]);
+            else if (std::strcmp(argv[i], "--cell") == 0) options.cellSize = static_cast<float>(std::atof(argv[i + 1]));
+            else if (std::strcmp(argv[i], "--sleep") == 0) options.sleeping = std::atoi(argv[i + 1]) != 0;
+            else if (std::strcmp(argv[i], "--broadphase") == 0) {
+                if (std::strcmp(argv[i + 1], "grid") == 0) options.broadPhases = {BroadPhaseType::Grid};
+                else if (std::strcmp(argv[i + 1], "sap") == 0) options.broadPhases = {BroadPhaseType::SweepAndPrune};
+            }
+            else if (std::strcmp(argv[i], "--ccd") == 0) options.continuousCollision = std::atoi(argv[i + 1]) != 0;
+            else if (std::strcmp(argv[i], "--deterministic") == 0) options.deterministic = std::atoi(argv[i + 1]) != 0;
+            else if (std::strcmp(argv[i], "--save") == 0) options.saveDir = argv[i + 1];
+            else if (std::strcmp(argv[i], "--load") == 0) options.loadDir = argv[i + 1];
+            else if (std::strcmp(argv[i], "--record") == 0) options.recordDir = argv[i + 1];
+            else std::fprintf(stderr, "Unknown option %s\n", argv[i]);
+        }
+        return options;
+    }
+
+    void runScenario(const Scenario& scenario, BroadPhaseType broadPhase, const Options& options) {
+        PhysicsEngine physics(scenario.worldWidth, scenario.worldHeight);
+        physics.setBroadPhase(broadPhase);
+        physics.setThreadCount(options.threads);
+        physics.setSimdLevel(options.simd);
+        physics.setParticleBudget(options.particleBudget);
+        if (std::strcmp(options.grid, "dense") == 0) physics.setSpatialGridMode(SpatialGrid::Mode::Dense);
+        if (std::strcmp(options.grid, "hashed") == 0) physics.setSpatialGridMode(SpatialGrid::Mode::Hashed);
+        physics.setMaxGridLevels(options.gridLevels);
+        if (options.cellSize > 0.0f) physics.setGridCellSize(options.cellSize);
+        physics.setSleepingEnabled(options.sleeping);
+        physics.setContinuousCollision(options.continuousCollision);
+        physics.setDeterministic(options.deterministic, 12345);
+
+        // Each measured step is one profiler "frame"
+        Profiler profiler;
+        if (options.profile) physics.setProfiler(&profiler);
+
+        std::mt19937 gen(12345);  // Fixed seed: same bodies every run
+        if (!options.loadDir.empty()) {
+            std::string path = options.loadDir + "/" + scenario.name + ".snap";
+            auto loadStart = std::chrono::steady_clock::now();
+            if (!physics.loadSnapshot(path)) {
+                std::fprintf(stderr, "Can't load %s\n", path.c_str());
+                return;
+            }
+            double loadMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+            std::printf("    loaded %s (%zu bodies) in %.2f ms\n", path.c_str(), physics.getBodyCount(), loadMs);
+        } else if (scenario.setup) {
+            scenario.setup(physics, gen);
+        }
+
+        int step = 0;
+        auto runStep = [&] {
+            if (scenario.perStep) scenario.perStep(physics, gen, step);
+            physics.step(STEP_TIME);
+            ++step;
+        };
+
+        // Warm-up: let buffers reach their working size before measuring
+        for (int i = 0; i < options.warmup; ++i) {
+            runStep();
+        }
+
+        TrajectoryRecorder recorder;
+        std::string recordPath;
+        if (!options.recordDir.empty()) {
+            recordPath = options.recordDir + "/" + scenario.name + "-" + getBroadPhaseName(broadPhase) + ".rbtr";
+            if (recorder.start(recordPath)) {
+                physics.setRecorder(&recorder);
+            } else {
+                std::fprintf(stderr, "Can't record to %s\n", recordPath.c_str());
+            }
+        }
+
+        uint64_t pairs = 0;
+        uint64_t contacts = 0;
+        uint64_t allocationsBefore = allocationCount.load();
+        auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < options.steps; ++i) {
+            profiler.beginFrame();
+            runStep();
+            profiler.endFrame();
+            pairs += physics.getPotentialPairCount();
+            contacts += physics.getContactCount();
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        uint64_t allocations = allocationCount.load() - allocationsBefore;
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        double steps = static_cast<double>(options.steps);
+
+        std::printf("%-10s %-5s %8zu %10.3f %12.0f %14.0f %12.2f %10zu %8zu",
+            scenario.name, getBroadPhaseName(broadPhase), physics.getBodyCount(), ms / steps,
+            pairs / steps, contacts / steps, allocations / steps, physics.getGridCellCount(),
+            physics.getSleepingBodyCount());
+        if (scenario.wallX > 0.0f) {
+            const BodyStore& bodies = physics.getBodies();
+            size_t passed = 0;
+            for (size_t i = 0; i < bodies.size(); ++i) {
+                if (!bodies.isStatic[i] && bodies.positionX[i] > scenario.wallX) ++passed;
+            }
+            std::printf(" %8zu", passed);
+        }
+        std::printf("\n");
+
+        if (recorder.isRecording()) {
+            bool written = recorder.stop();
+            double frames = std::max(1u, recorder.getFrameCount());
+            std::printf("    recorded %s: %u frames, %.1f KB (%.0f bytes/frame, raw %.0f)%s\n",
+                recordPath.c_str(), recorder.getFrameCount(), recorder.getEncodedBytes() / 1024.0,
+                recorder.getEncodedBytes() / frames, recorder.getRawBytes() / frames, written ? "" : " WRITE FAILED");
+        }
+
+        if (!options.saveDir.empty() && broadPhase == options.broadPhases.front()) {
+            std::string path = options.saveDir + "/" + scenario.name + ".snap";
+            if (!physics.saveSnapshot(path)) std::fprintf(stderr, "Can't write %s\n", path.c_str());
+        }
+
+        if (options.deterministic) {
+            std::printf("    state hash %016llx\n", static_cast<unsigned long long>(physics.getStateHash()));
+        }
+
+        if (options.profile) {
+            size_t frames = std::min<size_t>(options.steps, Profiler::HISTORY_SIZE);
+            for (size_t p = 0; p < Profiler::PHASE_COUNT; ++p) {
+                auto phase = static_cast<ProfilePhase>(p);
+                double ms = profiler.getAveragePhaseMs(phase, frames);
+                if (ms > 0.0) {
+                    std::printf("    %-16s %8.3f ms\n", Profiler::getPhaseName(phase), ms);
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options = parseOptions(argc, argv);
+
+    std::printf("steps=%d warmup=%d threads=%u dt=%.4fs simd=%s\n",
+        options.steps, options.warmup, options.threads, STEP_TIME,
+        Integrator::getSimdLevelName(std::min(options.simd, Integrator::detectSimdLevel())));
+    std::printf("%-10s %-5s %8s %10s %12s %14s %12s %10s %8s %8s\n",
+        "scenario", "broad", "bodies", "ms/step", "pairs/step", "contacts/step", "allocs/step", "cells", "asleep", "passed");
+
+    bool ranAny = false;
+    for (const Scenario& scenario : makeScenarios()) {
+        if (!options.scenario.empty() && options.scenario != scenario.name) continue;
+        for (BroadPhaseType broadPhase : options.broadPhases) {
+            runScenario(scenario, broadPhase, options);
+        }
+        ranAny = true;
+    }
+
+    if (!ranAny) {
+        std::fprintf(stderr, "No scenario named '%s'\n", options.scenario.c_str());
+        return 1;
+    }
+    return 0;
+}